@@ -3,6 +3,15 @@
 
 #include "Board.h"
 #include "Piece.h"
+#include "SearchStats.h"
+#include "OpeningBook.h"
+#include "Nnue.h"
+#include "PawnStructure.h"
+#include "Tablebase.h"
+#include "TranspositionTable.h"
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <vector>
 
 // AI difficulty levels
@@ -12,24 +21,64 @@ enum class AILevel {
     HARD     // Minimax depth 3
 };
 
+// Result of one completed iteration of iterative deepening
+struct SearchIteration {
+    int depth;
+    Move bestMove;
+    int score;           // From the AI's point of view
+    long long nodes;     // Nodes searched so far in this search
+    double milliseconds; // Time since the search started
+};
+
 class AI {
 private:
     AILevel difficulty;
     Color aiColor;
+    int searchDepth;  // 0 = use the depth of the difficulty level
+    std::shared_ptr<const OpeningBook> openingBook;  // Optional, shared between engines
+    std::shared_ptr<const Tablebase> tablebase;      // Optional, probed in the search
+    std::shared_ptr<const Nnue::Network> network;    // Optional, replaces the evaluation
+    TranspositionTable transpositionTable;
+    PawnHashTable pawnTable;
+    
+    // Search budget; 0 means no limit
+    int timeLimitMs;
+    long long nodeLimit;
+    std::function<void(const SearchIteration&)> iterationCallback;
+    
+    // State of the running search
+    SearchStats stats;
+    bool stopped;         // Budget ran out - the current iteration is thrown away
+    bool limitsActive;    // Never stop before the first iteration is complete
+    std::chrono::steady_clock::time_point searchStart;
+    std::vector<Nnue::Accumulator> accumulators;  // By ply, while a network is set
+    
+    // Iterative deepening over the root moves
+    Move searchRoot(const Board& board, std::vector<Move>& moves);
     
     // Minimax algorithm with alpha-beta pruning
-    int minimax(Board& board, int depth, bool isMaximizing, int alpha, int beta);
+    int minimax(Board& board, int depth, int ply, bool isMaximizing, int alpha, int beta);
+    
+    void checkLimits();
+    double elapsedMilliseconds() const;
+    
+    // Accumulator of a board just made from the position at ply - 1
+    void updateAccumulator(const Board& board, int ply);
     
     // Evaluation function
-    int evaluateBoard(const Board& board) const;
-    int evaluatePiecePosition(PieceType piece, Color color, int row, int col) const;
+    int evaluateBoard(const Board& board, int ply);
+    int evaluateClassical(const Board& board);  // White's view
+    int evaluatePawns(const Board& board);  // Cached pawn structure score, white's view
     
     // Move ordering for better alpha-beta pruning
-    void orderMoves(std::vector<Move>& moves, const Board& board) const;
+    void orderMoves(std::vector<Move>& moves, const Board& board, uint16_t firstMove = 0) const;
     
     // Utility methods
     Move getRandomMove(const Board& board) const;
     bool isCapture(const Move& move, const Board& board) const;
+    
+    // The microbenchmarks (tests/bench_hotpaths.cpp) time the private hot paths
+    friend struct AIHotPaths;
 
 public:
     // Constructor
@@ -38,12 +87,60 @@ public:
     // Main AI method - returns the best move
     Move getBestMove(const Board& board);
     
+    // Evaluation of a position without searching, from white's view
+    int staticEvaluation(const Board& board);
+    
     // Getters and setters
     AILevel getDifficulty() const { return difficulty; }
     void setDifficulty(AILevel level) { difficulty = level; }
     
+    // Fixed search depth in plies, overriding the difficulty level (0 to
+    // reset). Capped at MAX_SEARCH_DEPTH.
+    int getSearchDepth() const { return searchDepth; }
+    void setSearchDepth(int depth) {
+        searchDepth = depth < 0 ? 0 : (depth > MAX_SEARCH_DEPTH ? MAX_SEARCH_DEPTH : depth);
+    }
+    
+    // Search budget per move. With a time or node limit and no fixed depth
+    // the search keeps deepening until the budget runs out. 0 = no limit.
+    void setTimeLimit(int milliseconds) { timeLimitMs = milliseconds; }
+    void setNodeLimit(long long maxNodes) { nodeLimit = maxNodes; }
+    
+    // Called after every completed iteration of the search
+    void setIterationCallback(std::function<void(const SearchIteration&)> callback) {
+        iterationCallback = callback;
+    }
+    
+    // Statistics of the last getBestMove call (empty after a book or random move)
+    const SearchStats& getLastSearchStats() const { return stats; }
+    
+    // Transposition table size; resizing or clearing forgets all results
+    void setHashSize(size_t megabytes) { transpositionTable.resize(megabytes); }
+    void clearHash() { transpositionTable.clear(); pawnTable.clear(); }
+    void prefaultHash() { transpositionTable.prefault(); }  // Call from the searching thread
+    LargePages::Kind getHashPageKind() const { return transpositionTable.pageKind(); }
+    
+    // Transposition table snapshots, so a later run starts with what this
+    // one searched (see TranspositionTable::save and load)
+    long long saveHash(const std::string& path, int minDepth = TranspositionTable::SNAPSHOT_MIN_DEPTH) const {
+        return transpositionTable.save(path, minDepth, aiColor);
+    }
+    long long loadHash(const std::string& path) { return transpositionTable.load(path, aiColor); }
+    
     Color getColor() const { return aiColor; }
-    void setColor(Color color) { aiColor = color; }
+    void setColor(Color color) {
+        if (color != aiColor) transpositionTable.clear();  // Stored scores are from our side's view
+        aiColor = color;
+    }
+    
+    // Book moves are played instead of searching while the game is in the book
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) { openingBook = book; }
+    
+    // Endgame tablebases replace the search once few enough pieces are left
+    void setTablebase(std::shared_ptr<const Tablebase> tables) { tablebase = tables; }
+    
+    // Evaluate with a neural network instead of the hand-written terms
+    void setNetwork(std::shared_ptr<const Nnue::Network> net);
     
     // Evaluation constants
     static const int PAWN_VALUE = 100;
@@ -53,13 +150,13 @@ public:
     static const int QUEEN_VALUE = 900;
     static const int KING_VALUE = 20000;
     
-    // Position bonus tables (simplified)
-    static const int PAWN_POSITION_BONUS[8][8];
-    static const int KNIGHT_POSITION_BONUS[8][8];
-    static const int BISHOP_POSITION_BONUS[8][8];
-    static const int ROOK_POSITION_BONUS[8][8];
-    static const int QUEEN_POSITION_BONUS[8][8];
-    static const int KING_POSITION_BONUS[8][8];
+    // Score of a tablebase win, minus the plies to mate. Above any material
+    // evaluation but below a mate found by the search itself.
+    static const int TABLEBASE_WIN = 1000000;
+    
+    // Deepest iteration: the limit when only a time or node limit is set,
+    // and the most a fixed depth can ask for (one accumulator per ply)
+    static const int MAX_SEARCH_DEPTH = 64;
 };
 
 #endif // AI_H
@@ -0,0 +1,63 @@
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Buffered file output written out by a thread of its own.
+//
+// There are two buffers: callers append to one while the writer thread
+// writes the other to the file. When the caller's buffer is full the two
+// swap, so a caller only waits if it fills a whole buffer before the
+// previous one has reached the disk. Writes are in the order they were
+// made. Not for use from several threads at once - callers that share one
+// writer hold their own lock around write().
+class AsyncFileWriter {
+public:
+    static const size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+    explicit AsyncFileWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~AsyncFileWriter();  // Closes the file
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // Creates or truncates the file and starts the writer thread
+    bool open(const std::string& path);
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const void* data, size_t size);
+
+    // Hands the buffer over and waits until everything so far is written
+    void flush();
+
+    // Flushes and closes the file. False if any write failed.
+    bool close();
+
+    uint64_t getBytesWritten() const { return bytesWritten; }
+
+private:
+    std::FILE* file;
+    size_t bufferSize;
+    std::vector<char> filling;  // The caller's
+    std::vector<char> writing;  // The writer thread's, while writePending
+    uint64_t bytesWritten;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool writePending;
+    bool stopping;
+    bool failed;
+
+    void handOver();  // Swap the buffers once the writer thread is idle
+    void writerLoop();
+};
+
+#endif // ASYNC_FILE_WRITER_H
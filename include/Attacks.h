@@ -0,0 +1,37 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "Piece.h"
+#include <cstdint>
+
+// Bit counting loops are built twice where the compiler can't assume the
+// POPCNT instruction (x86 without -mpopcnt): once with it and once calling
+// libgcc's software count, the right one chosen when the program loads.
+// Put this on the functions that count, so Attacks::count inlines into them.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__linux__) && !defined(__POPCNT__)
+    #define POPCNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+    #define POPCNT_CLONES
+#endif
+
+// Attack bitboards. Squares are Zobrist::squareIndex (row * 8 + col, row 0
+// is rank 8). Leaper attacks come from tables; slider attacks follow each
+// ray to its first blocker, which is included (it may be an own piece).
+namespace Attacks {
+    const uint64_t FILE_A = 0x0101010101010101ULL;
+
+    uint64_t knight(int square);
+    uint64_t king(int square);
+    uint64_t pawns(uint64_t pawns, Color color);  // All squares attacked by a set of pawns
+
+    uint64_t bishop(int square, uint64_t occupied);
+    uint64_t rook(int square, uint64_t occupied);
+    inline uint64_t queen(int square, uint64_t occupied) {
+        return bishop(square, occupied) | rook(square, occupied);
+    }
+
+    inline int count(uint64_t bits) { return __builtin_popcountll(bits); }
+    inline uint64_t fileMask(int col) { return FILE_A << col; }
+}
+
+#endif // ATTACKS_H
@@ -0,0 +1,38 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "Board.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Headless games for scripts: move lists in, final positions out, with no
+// prompts, screen clears or pauses.
+//
+// Every non-empty line of input is one game. It starts from the initial
+// position, or from "fen <FEN> moves ..." when given. Moves are separated
+// by whitespace, in SAN ("Nf3", "exd5", "O-O", "e8=Q") or coordinates
+// ("g1f3", "e7e8q", "e2-e4"). Move numbers, result markers and lines
+// starting with '#' or '[' are skipped.
+namespace Batch {
+    struct Summary {
+        uint64_t games = 0;
+        uint64_t moves = 0;
+        uint64_t failed = 0;  // Games stopped by an illegal or unreadable move
+        double seconds = 0.0;
+    };
+
+    // Apply the moves of one game. On failure the board is left at the last
+    // legal position and error says which move was refused.
+    bool playMoves(Board& board, std::string_view moves, uint64_t& played, std::string& error);
+
+    // "1-0", "0-1", "1/2-1/2", or "*" while the game goes on
+    std::string result(const Board& board);
+
+    // Play every game of the input. Writes "<result> <FEN>" per game to
+    // output and problems to errors.
+    Summary run(std::istream& input, std::ostream& output, std::ostream& errors);
+}
+
+#endif // BATCH_H
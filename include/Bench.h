@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "PerfCounters.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Fixed search workload for comparing builds ("chess_game bench").
+//
+// A built-in list of positions - openings, middlegames, endgames, checks
+// and promotions - is searched one after the other on one thread, each
+// with a fresh engine and a fixed depth. The total node count depends only
+// on what the search does, never on timing, so it is a signature: a change
+// meant only to make things faster must leave it as it was, and a change
+// to the search or evaluation will almost always move it. Time and nodes
+// per second are what to compare between builds; hardware counters per
+// node (see PerfCounters) tell why they changed.
+namespace Bench {
+    const int DEFAULT_DEPTH = 4;
+
+    struct PositionResult {
+        std::string fen;
+        std::string bestMove;  // SAN
+        long long nodes = 0;
+        double milliseconds = 0.0;
+    };
+
+    struct Result {
+        int depth = 0;
+        long long nodes = 0;
+        double milliseconds = 0.0;
+        PerfCounters::Counts counters;  // Of the searches only; none unless asked for
+        std::vector<PositionResult> positions;
+
+        double nodesPerSecond() const { return milliseconds > 0.0 ? nodes * 1000.0 / milliseconds : 0.0; }
+    };
+
+    const std::vector<std::string>& positions();
+
+    // Search every position to depth. When progress isn't null a line is
+    // written to it after each position; when counters isn't null they
+    // count every search.
+    Result run(int depth, std::ostream* progress, PerfCounters* counters = nullptr);
+
+    // Summary for people, and the same data as JSON for scripts
+    void printReport(const Result& result, std::ostream& out);
+    void writeJson(const Result& result, std::ostream& out);
+}
+
+#endif // BENCH_H
@@ -4,6 +4,7 @@
 #include "Piece.h"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 // Structure to track game state - important for chess rules
 struct GameState {
@@ -23,14 +24,44 @@ struct GameState {
                   enPassantCol(-1), halfMoveClock(0), fullMoveNumber(1) {}
 };
 
+// One square change made by Board::makeMove, for evaluators that update
+// incrementally (see Nnue.h)
+struct SquareChange {
+    int square;  // Zobrist::squareIndex
+    Piece removed;
+    Piece added;
+};
+
 class Board {
+public:
+    static const int MAX_CHANGES = 8;  // Promotion with capture needs 5, castling 4
+
 private:
     // 8x8 board represented as vector of vectors - C++ containers are powerful!
     std::vector<std::vector<Piece>> board;
     GameState gameState;
     
+    // Updated on every square change instead of recomputed from the board
+    uint64_t pieceKey;          // Zobrist key of the pieces alone
+    uint64_t pawnKey;           // Zobrist key of the pawns alone
+    uint64_t pieceBitboards[2][6];  // By color (white, black), then PieceType;
+                                    // bit = Zobrist::squareIndex(row, col)
+    uint64_t colorBitboards[2];     // All pieces of a color
+    int midgameScore;           // PieceSquareTables sums, white minus black
+    int endgameScore;
+    int phase;                  // Sum of PieceSquareTables::phaseWeight over all pieces
+    
+    // Square changes since the last makeMove started; MAX_CHANGES + 1 = too many to list
+    SquareChange changes[MAX_CHANGES];
+    int changeCount;
+    
+    // The only ways a square is changed - they keep the keys above in step
+    void placePiece(int row, int col, const Piece& piece);
+    void movePiece(int fromRow, int fromCol, int toRow, int toCol);
+    
     // Helper methods (private implementation details)
     bool isPathClear(int fromRow, int fromCol, int toRow, int toCol) const;
+    bool isValidCastling(const Move& move) const;
     bool wouldBeInCheck(Color color, const Move& move) const;
     void findKing(Color color, int& kingRow, int& kingCol) const;
     void updateGameState(const Move& move, const Piece& movingPiece, const Piece& capturedPiece);
@@ -53,6 +84,7 @@ public:
     
     // Game state checking
     bool isInCheck(Color color) const;
+    bool isSquareAttacked(int row, int col, Color byColor) const;
     bool isCheckmate(Color color) const;
     bool isStalemate(Color color) const;
     bool isDraw() const;  // 50-move rule, insufficient material, etc.
@@ -61,6 +93,12 @@ public:
     std::vector<Move> getAllLegalMoves(Color color) const;
     std::vector<Move> getPossibleMoves(int row, int col) const;
     
+    // FEN (Forsyth-Edwards Notation) import/export. The move counters are
+    // optional when loading, so EPD positions work too. On failure the
+    // board is left unchanged.
+    bool loadFEN(const std::string& fen);
+    std::string toFEN() const;
+    
     // Display
     void display() const;
     std::string getSquareName(int row, int col) const;  // e.g., "e4"
@@ -68,9 +106,39 @@ public:
     // Utility methods
     bool isOnBoard(int row, int col) const;
     void resetToStartingPosition();
+    int countPieces() const;  // Both colors, kings included
     
     // For AI evaluation
     int evaluatePosition() const;  // Positive for white advantage
+    
+    // Zobrist key of the position (pieces, side to move, castling, en passant)
+    uint64_t getHashKey() const;
+    
+    // Zobrist key of the pawn placement only, for caching pawn evaluation
+    uint64_t getPawnKey() const { return pawnKey; }
+    
+    // Squares holding pieces, one bit per Zobrist::squareIndex
+    uint64_t getPieceBitboard(Color color, PieceType type) const {
+        return pieceBitboards[color == Color::WHITE ? 0 : 1][static_cast<int>(type)];
+    }
+    uint64_t getPawnBitboard(Color color) const { return getPieceBitboard(color, PieceType::PAWN); }
+    uint64_t getColorBitboard(Color color) const { return colorBitboards[color == Color::WHITE ? 0 : 1]; }
+    uint64_t getOccupancy() const { return colorBitboards[0] | colorBitboards[1]; }
+    
+    // Material and piece-square sums (white minus black) and game phase,
+    // for the tapered evaluation - see PieceSquareTables.h
+    int getMidgameScore() const { return midgameScore; }
+    int getEndgameScore() const { return endgameScore; }
+    int getPhase() const { return phase; }
+    
+    // Square changes made by the last makeMove (and anything changed since).
+    // Returns false if more changed than can be listed - e.g. after
+    // loadFEN - in which case an incremental evaluator has to start over.
+    bool getLastChanges(const SquareChange*& list, int& count) const {
+        list = changes;
+        count = changeCount;
+        return changeCount <= MAX_CHANGES;
+    }
 };
 
 #endif // BOARD_H
@@ -0,0 +1,89 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include "Board.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Draws boards into a preallocated frame buffer that reaches the terminal
+// in one write() call, with piece symbols from PIECE_SYMBOLS.
+//
+// drawBoard draws the whole board at the cursor, as Board::display always
+// has. drawScreen and updateScreen own the screen for a game in progress:
+// updateScreen remembers what is on screen, moves the cursor to the squares
+// that changed since the last frame and repaints only those, then redraws
+// the status line under the board and clears whatever was printed below.
+//
+// Squares are found by absolute screen position, which only holds while
+// the screen hasn't scrolled. Whoever prints under the board reports it
+// with printedBelow; once the frame and that output could have taken the
+// cursor past the last line of the terminal, the next update draws the
+// whole screen. On an 80x24 terminal that is every frame.
+class BoardRenderer {
+public:
+    static const size_t BUFFER_SIZE = 32768;  // A board screen is about 4 KB, 16 spectator tiles 24 KB
+    static const int BOARD_LINES = 22;       // drawBoard output, status line included
+
+    // A negative fd builds frames without writing them
+    explicit BoardRenderer(int fd = 1);
+
+    BoardRenderer(const BoardRenderer&) = delete;
+    BoardRenderer& operator=(const BoardRenderer&) = delete;
+
+    // Add to the frame
+    void append(std::string_view text);
+    void moveCursor(int line, int column);  // 0-based screen position
+    void drawBoard(const Board& board);
+
+    // Clear the screen, then draw header (whole lines) and the board
+    void drawScreen(const Board& board, std::string_view header);
+
+    // Repaint what changed since the last drawScreen or updateScreen. The
+    // whole screen is drawn on the first frame, after invalidate(), or when
+    // the header changes.
+    void updateScreen(const Board& board, std::string_view header);
+
+    // Call when something else cleared or scrolled the screen
+    void invalidate() { onScreen = false; }
+
+    // Text written under the board since the last frame (messages, prompts
+    // and input echoed by the terminal), counted in lines as the terminal
+    // wraps them
+    void printedBelow(std::string_view text);
+
+    // Terminal height to assume when it can't be asked (not a terminal)
+    static const int DEFAULT_SCREEN_LINES = 24;
+    void setScreenLines(int lines) { screenLines = lines; }
+
+    // Send the frame with one write() and start a new one. False on an I/O
+    // error; the frame is dropped either way.
+    bool flush();
+
+    std::string_view frame() const { return std::string_view(buffer, length); }
+    int getSquaresDrawn() const { return squaresDrawn; }  // By the last draw or update
+
+private:
+    char buffer[BUFFER_SIZE];
+    size_t length;
+    int fd;
+
+    // What the terminal shows
+    bool onScreen;
+    Piece shown[64];
+    std::string header;
+    int boardLine;  // Screen line of the board's first line
+    int linesBelow;  // Printed under the frame since, and the column reached
+    int column;
+    int screenLines;
+    int squaresDrawn;
+
+    int screenHeight() const;
+    bool mayHaveScrolled() const;
+
+    void appendNumber(int value);
+    void appendSquare(int row, int col, const Piece& piece);
+    void appendStatus(const Board& board);
+};
+
+#endif // BOARD_RENDERER_H
@@ -0,0 +1,25 @@
+#ifndef EPD_H
+#define EPD_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// One line of an EPD (Extended Position Description) file: the first four
+// FEN fields followed by operations such as
+//   bm Qxf7#; id "scholar";
+// Plain FEN lines (with the two move counters) are accepted too.
+struct EpdRecord {
+    std::string fen;  // Complete FEN; counters from hmvc/fmvn, else "0 1"
+    std::vector<std::pair<std::string, std::string>> operations;  // Opcode, operands (quotes removed)
+    
+    // Operands of an operation, or an empty string if it isn't present
+    std::string getOperation(const std::string& opcode) const;
+    bool hasOperation(const std::string& opcode) const;
+};
+
+// Parse one line. Returns false for blank lines, '#' comments and lines
+// without the four position fields. The position itself is not validated.
+bool parseEpd(const std::string& line, EpdRecord& record);
+
+#endif // EPD_H
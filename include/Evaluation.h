@@ -0,0 +1,23 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "PackedPosition.h"
+#include <cstddef>
+
+// Bulk scoring of stored positions with the hand-written evaluation - the
+// same score as AI::staticEvaluation without a network, white's view.
+//
+// Positions are decoded straight from their packed form, never through a
+// Board. Each chunk of positions is scored in two passes: the first decodes
+// pieces into bitboards and fills structure-of-arrays columns (midgame,
+// endgame, phase, pawns), the second blends the columns for the whole
+// chunk in one loop the compiler vectorizes.
+namespace Evaluation {
+    const size_t BATCH_CHUNK = 256;
+
+    // scores must hold count entries. Safe to call from several threads on
+    // separate ranges.
+    void evaluateBatch(const PackedPosition* positions, size_t count, int* scores);
+}
+
+#endif // EVALUATION_H
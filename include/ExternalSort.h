@@ -0,0 +1,150 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+// External merge sort for more records than fit in memory. Callers fill a
+// buffer and spill() it whenever it gets big; each spill is sorted, has its
+// duplicates combined and goes to a temporary run file. merge() then streams
+// every record back in order, duplicates across runs combined, for the caller
+// to write out.
+//
+// Record must be trivially copyable - runs are raw arrays of it. Traits
+// supplies the order and how two records for the same entry add up:
+//   static bool less(const Record& a, const Record& b);
+//   static void combine(Record& total, const Record& more);
+// Records neither less than the other are the same entry.
+template <typename Record, typename Traits>
+class ExternalSort {
+private:
+    std::string directory;
+    std::string prefix;
+    std::vector<std::string> paths;
+    std::mutex mutex;
+    std::atomic<int> nextId{0};
+
+    static bool sameEntry(const Record& a, const Record& b) {
+        return !Traits::less(a, b) && !Traits::less(b, a);
+    }
+
+    // Reads one run file sequentially through a small buffer
+    class RunReader {
+    private:
+        std::ifstream file;
+        std::vector<Record> buffer;
+        size_t position = 0;
+
+    public:
+        explicit RunReader(const std::string& path) : file(path, std::ios::binary) {}
+
+        bool next(Record& record) {
+            if (position == buffer.size()) {
+                buffer.resize(4096);
+                file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(Record));
+                buffer.resize(file.gcount() / sizeof(Record));
+                position = 0;
+                if (buffer.empty()) return false;
+            }
+            record = buffer[position++];
+            return true;
+        }
+    };
+
+public:
+    // Runs are named <directory>/<prefix>.N.run
+    ExternalSort(const std::string& dir, const std::string& runPrefix) : directory(dir), prefix(runPrefix) {}
+    ~ExternalSort() { removeRuns(); }
+
+    ExternalSort(const ExternalSort&) = delete;
+    ExternalSort& operator=(const ExternalSort&) = delete;
+
+    // Sort records and add up duplicates in place
+    static void sortAndCombine(std::vector<Record>& records) {
+        std::sort(records.begin(), records.end(), Traits::less);
+
+        size_t out = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (out > 0 && sameEntry(records[out - 1], records[i])) {
+                Traits::combine(records[out - 1], records[i]);
+            } else {
+                records[out++] = records[i];
+            }
+        }
+        records.resize(out);
+    }
+
+    // Writes records as a new run and clears them. Safe from any thread.
+    // Returns false if the run could not be written; the partial file is
+    // removed and records are left as they were (sorted and combined).
+    bool spill(std::vector<Record>& records) {
+        if (records.empty()) return true;
+        sortAndCombine(records);
+
+        std::string path = directory + "/" + prefix + "." + std::to_string(nextId++) + ".run";
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+        out.close();  // Flushes - a full disk shows up here
+        if (!out) {
+            std::remove(path.c_str());
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        paths.push_back(path);
+        records.clear();
+        return true;
+    }
+
+    size_t runCount() const { return paths.size(); }
+
+    // K-way merge of all runs. Calls emit(record) once per entry, in order,
+    // with every run's records for it combined.
+    template <typename Emit>
+    void merge(Emit&& emit) const {
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (const std::string& path : paths) readers.push_back(std::make_unique<RunReader>(path));
+
+        using HeapItem = std::pair<Record, size_t>;
+        auto heapGreater = [](const HeapItem& a, const HeapItem& b) { return Traits::less(b.first, a.first); };
+        std::priority_queue<HeapItem, std::vector<HeapItem>, decltype(heapGreater)> heap(heapGreater);
+        for (size_t i = 0; i < readers.size(); ++i) {
+            Record record;
+            if (readers[i]->next(record)) heap.push({record, i});
+        }
+
+        bool havePending = false;
+        Record pending{};
+        while (!heap.empty()) {
+            HeapItem item = heap.top();
+            heap.pop();
+
+            if (havePending && sameEntry(pending, item.first)) {
+                Traits::combine(pending, item.first);
+            } else {
+                if (havePending) emit(pending);
+                pending = item.first;
+                havePending = true;
+            }
+
+            Record record;
+            if (readers[item.second]->next(record)) heap.push({record, item.second});
+        }
+        if (havePending) emit(pending);
+    }
+
+    // Deletes the run files; runCount() still reports how many there were
+    void removeRuns() {
+        for (const std::string& path : paths) std::remove(path.c_str());
+    }
+};
+
+#endif // EXTERNAL_SORT_H
@@ -3,7 +3,10 @@
 
 #include "Board.h"
 #include "AI.h"
+#include "BoardRenderer.h"
+#include "PositionIndex.h"
 #include <memory>  // For smart pointers - modern C++
+#include <string>
 
 // Game mode enumeration
 enum class GameMode {
@@ -17,7 +20,13 @@ private:
     Board board;
     GameMode currentMode;
     std::unique_ptr<AI> ai;  // Smart pointer - automatically manages memory
+    std::shared_ptr<const OpeningBook> openingBook;  // Given to every AI we create
+    std::shared_ptr<const Tablebase> tablebase;
+    std::shared_ptr<const Nnue::Network> network;
+    std::shared_ptr<const PositionIndex> positionIndex;  // Archive statistics under the board
+    std::string hashPath;  // Transposition table snapshot, if any
     bool gameRunning;
+    BoardRenderer renderer;  // Repaints only what changed between turns
     
     // Game loop methods
     void showMainMenu();
@@ -29,13 +38,16 @@ private:
     Move getPlayerMove();
     bool parsePlayerInput(const std::string& input, Move& move);
     void handleSpecialMoves(Move& move);
+    void handleHashCommand(const std::string& input);
     
     // Game state display
     void displayGameState();
+    void displayArchiveStats();
     void displayMoveHistory();
     void showGameResult();
     
     // Utility methods
+    void print(const std::string& text);  // Under the board, counted by the renderer
     void waitForEnter();
     void showInstructions();
     void showAbout();
@@ -61,6 +73,11 @@ public:
     void quitGame();
     
     // Settings
+    bool loadOpeningBook(const std::string& path);
+    int loadTablebases(const std::string& directory);  // Returns the number of tables
+    bool loadNetwork(const std::string& path);
+    bool loadPositionIndex(const std::string& path);
+    bool loadHashSnapshot(const std::string& path);
     void changeAIDifficulty();
     void toggleDisplaySettings();
     
@@ -0,0 +1,68 @@
+#ifndef GAME_ARCHIVE_H
+#define GAME_ARCHIVE_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include "Pgn.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Compact binary container for large numbers of games, in place of PGN.
+// Every move is stored as its index in MoveGen's legal move list for the
+// position, in just enough bits to count the legal moves there (about 5
+// bits a move; none when there is only one legal move).
+//
+// File layout: header, the games, then the game index (gameCount + 1
+// offsets). A game is: varint tag count, then per tag the name and the
+// value as varint length + bytes; a result byte; varint ply count; then the
+// move indexes packed least significant bit first, padded to a byte. A FEN
+// tag gives the starting position. Files are written in one pass and read
+// through a memory mapping, so any game can be decoded on its own.
+class GameArchive {
+public:
+    // Streams games into an archive; only the game offsets stay in memory
+    class Writer {
+    private:
+        std::ofstream out;
+        std::vector<uint64_t> offsets;
+        std::vector<uint8_t> buffer;  // The game being encoded
+
+    public:
+        explicit Writer(const std::string& path);
+        bool isOpen() const { return static_cast<bool>(out); }
+
+        // Encode a game. Returns false, writing nothing, if a move doesn't
+        // resolve in the position it is played from.
+        bool add(const PgnGame& game);
+        bool finish();  // Writes the index and the header
+
+        size_t gameCount() const { return offsets.size() - 1; }
+    };
+
+    static const char MAGIC[8];
+
+    bool open(const std::string& path);
+    bool isOpen() const { return file.isOpen(); }
+
+    size_t gameCount() const { return games; }
+    size_t size() const { return file.size(); }
+
+    // Decode a game with its moves in SAN, as PgnReader would have read it
+    bool readGame(size_t index, PgnGame& game) const;
+
+    // Decode only the moves, and the starting position into start
+    bool readMoves(size_t index, Board& start, std::vector<Move>& moves) const;
+
+private:
+    MappedFile file;
+    const uint64_t* offsets = nullptr;
+    size_t games = 0;
+
+    // Tags and result go into header when it isn't null
+    bool decode(size_t index, PgnGame* header, Board& start, std::vector<Move>& moves) const;
+};
+
+#endif // GAME_ARCHIVE_H
@@ -0,0 +1,61 @@
+#ifndef LARGE_PAGES_H
+#define LARGE_PAGES_H
+
+#include <cstddef>
+
+// Zeroed memory for big tables, backed by 2 MB pages where the system has
+// them. A transposition table probe lands on a random page, so with 4 KB
+// pages nearly every probe of a large table also misses the TLB.
+//
+// In order of preference: explicit huge pages (MAP_HUGETLB, when the
+// administrator has reserved some in /proc/sys/vm/nr_hugepages), then
+// transparent huge pages (a 2 MB aligned mapping with MADV_HUGEPAGE), then
+// ordinary memory. The fallbacks are silent; kind() tells which was used.
+//
+// Pages are not touched here: the kernel places each one on the NUMA node
+// of the thread that first writes it, so a table is best first written by
+// the thread that will search with it. clear() writes from threads of its
+// own, so calling it on a fresh block would place the pages on their nodes
+// instead - a fresh block is already zero and needs no clear.
+class LargePages {
+public:
+    enum class Kind {
+        NONE,         // Nothing allocated
+        NORMAL,       // Ordinary pages
+        TRANSPARENT,  // Transparent huge pages requested with madvise
+        EXPLICIT      // Reserved huge pages
+    };
+
+    static const size_t PAGE_SIZE = 2 * 1024 * 1024;
+
+    LargePages() : memory(nullptr), length(0), mappedLength(0), pageKind(Kind::NONE) {}
+    ~LargePages() { release(); }
+
+    LargePages(const LargePages&) = delete;
+    LargePages& operator=(const LargePages&) = delete;
+
+    // Replaces the current block. With allowLarge false ordinary pages are
+    // used. Returns nullptr if there isn't enough memory.
+    void* allocate(size_t bytes, bool allowLarge = true);
+    void release();
+
+    // Zero the block on up to threads threads, each writing its own slice
+    // of at least CLEAR_SLICE bytes; a single slice is zeroed by the calling
+    // thread. Pages already placed stay where they are.
+    static const size_t CLEAR_SLICE = 16 * 1024 * 1024;
+    void clear(int threads);
+
+    void* data() const { return memory; }
+    size_t size() const { return length; }
+    Kind kind() const { return pageKind; }
+
+    static const char* describe(Kind kind);
+
+private:
+    void* memory;
+    size_t length;
+    size_t mappedLength;  // Rounded up to whole pages
+    Kind pageKind;
+};
+
+#endif // LARGE_PAGES_H
@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only memory-mapped file. Pages are loaded by the OS on first access,
+// so large files can be opened instantly and only the parts used are read.
+// On platforms without mmap the file is read into memory instead.
+class MappedFile {
+private:
+    const uint8_t* data;
+    size_t length;
+    std::vector<uint8_t> fallback;  // Only used without mmap
+    
+    void close();
+
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    // Not copyable - the mapping has a single owner
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const std::string& path);
+    bool isOpen() const { return data != nullptr; }
+    
+    const uint8_t* getData() const { return data; }
+    size_t size() const { return length; }
+};
+
+#endif // MAPPED_FILE_H
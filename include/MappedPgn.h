@@ -0,0 +1,79 @@
+#ifndef MAPPED_PGN_H
+#define MAPPED_PGN_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Splits a game's text into tags and main-line SAN moves without copying:
+// every token is a view into the text. Comments, variations, NAGs and move
+// numbers are skipped, as PgnReader does. Tag values keep their escapes.
+class PgnTokenizer {
+private:
+    std::string_view text;
+    size_t position;
+    bool inMovetext;
+    std::string_view result;
+
+    void skipLine();
+
+public:
+    explicit PgnTokenizer(std::string_view game);
+
+    // Tags come first; false once the movetext starts
+    bool nextTag(std::string_view& name, std::string_view& value);
+
+    // Skips any tags not read yet. False at the result or the end of the game.
+    bool nextMove(std::string_view& san);
+
+    // After the last move: the result token, or "*" if the game has none
+    std::string_view getResult() const { return result.empty() ? "*" : result; }
+};
+
+// A position reached while replaying, handed to the callback
+struct ReplayPosition {
+    size_t game;          // Index in the file
+    int ply;              // 0 for the starting position
+    const Board& board;
+    const Move* move;     // The move just played; nullptr at ply 0
+};
+
+// A PGN file mapped into memory and indexed by game, for reading large
+// archives fast. open() finds the game boundaries on several threads; a new
+// game starts at a tag line that follows movetext. Games are views into the
+// mapping and stay valid while the MappedPgn is open.
+class MappedPgn {
+private:
+    MappedFile file;
+    std::vector<size_t> starts;  // Offset of every game, then the file size
+
+public:
+    struct ReplayStats {
+        size_t games = 0;
+        size_t positions = 0;  // Starting positions included
+        size_t failed = 0;     // Games stopped by a move that didn't resolve
+        double seconds = 0.0;
+    };
+
+    // threads <= 0 means one per hardware thread
+    bool open(const std::string& path, int threads = 0);
+
+    size_t gameCount() const { return starts.empty() ? 0 : starts.size() - 1; }
+    size_t size() const { return file.size(); }
+    std::string_view game(size_t index) const;
+
+    // Value of a tag, or an empty view
+    static std::string_view tag(std::string_view game, std::string_view name);
+
+    // Replay every game on a Board, in parallel. Each game starts from its
+    // FEN tag, or the initial position, and stops at the first move that
+    // doesn't resolve. onPosition is called for every position reached, from
+    // the worker threads - concurrently, but in order within a game.
+    ReplayStats replay(int threads, const std::function<void(const ReplayPosition&)>& onPosition) const;
+};
+
+#endif // MAPPED_PGN_H
@@ -0,0 +1,43 @@
+#ifndef MOBILITY_H
+#define MOBILITY_H
+
+#include "Board.h"
+
+// Mobility and king safety from attack bitboards (see Attacks.h).
+// Scores are in centipawns, white minus black, with separate midgame and
+// endgame parts for the tapered evaluation.
+namespace Mobility {
+    // Per safe square - not occupied by an own piece, not attacked by an
+    // enemy pawn - beyond a typical count, indexed by PieceType
+    extern const int MIDGAME_WEIGHT[6];
+    extern const int ENDGAME_WEIGHT[6];
+    extern const int BASELINE[6];
+
+    // Attack units per king zone square hit, indexed by PieceType. The
+    // penalty grows with the square of the units once two pieces attack.
+    extern const int KING_ATTACK_WEIGHT[6];
+    const int MAX_KING_DANGER = 500;
+
+    // Files next to the king (and its own) without own pawns / any pawns
+    const int SEMI_OPEN_FILE_PENALTY = 15;
+    const int OPEN_FILE_PENALTY = 25;
+
+    struct Score {
+        int midgame;
+        int endgame;
+    };
+
+    Score evaluate(const Board& board);
+    Score evaluate(const uint64_t pieces[2][6]);  // Bitboards by color (white, black) and PieceType
+    int kingDanger(int attackUnits);
+
+    // What evaluate() adds up, for fitting the weights: safe squares beyond
+    // BASELINE by PieceType, white minus black, and the king safety terms
+    struct Terms {
+        int mobility[6];
+        Score kingSafety;
+    };
+    Terms terms(const uint64_t pieces[2][6]);
+}
+
+#endif // MOBILITY_H
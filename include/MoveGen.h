@@ -0,0 +1,53 @@
+#ifndef MOVE_GEN_H
+#define MOVE_GEN_H
+
+#include "Board.h"
+#include <cstdint>
+
+// Legal move generation on bitboards, without copying the Board. Follows
+// Board's rules exactly - the same moves as Board::getAllLegalMoves, in a
+// different order - for the hot paths that need every legal move, such as
+// SAN conversion.
+namespace MoveGen {
+    const int MAX_MOVES = 256;
+
+    struct MoveList {
+        Move moves[MAX_MOVES];
+        int count = 0;
+
+        void add(const Move& move) { moves[count++] = move; }
+        int size() const { return count; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+    };
+
+    // The bitboards and state move generation needs. Squares are
+    // Zobrist::squareIndex; sides are 0 for white and 1 for black.
+    struct Position {
+        uint64_t pieces[2][6];  // By side, then PieceType
+        uint64_t colors[2];
+        int side;               // To move
+        int enPassantCol;       // -1 if none
+        bool castling[2][2];    // By side, then kingside (0) or queenside (1)
+
+        explicit Position(const Board& board);
+
+        uint64_t occupied() const { return colors[0] | colors[1]; }
+        PieceType pieceOn(int square) const;  // EMPTY if the square is
+        bool isAttacked(int square, int bySide) const;
+        bool inCheck() const;
+
+        // Play a legal move: captures, en passant, castling and promotion
+        // (queen unless R/B/N) as Board::makeMove does
+        void play(const Move& move);
+    };
+
+    // Legal moves for the side to move, with isCapture, isCastling and
+    // isEnPassant set. A promotion comes as four moves, one per piece.
+    // targets limits the destination squares.
+    void generate(const Position& position, MoveList& moves, uint64_t targets = ~0ULL);
+
+    bool hasLegalMove(const Position& position);
+}
+
+#endif // MOVE_GEN_H
@@ -0,0 +1,99 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+
+// Efficiently updatable neural network evaluation.
+//
+// The input layer is HalfKP-like: one feature per (own king square, piece,
+// square) for every piece except the kings, seen from each side. The first
+// layer's output (the accumulator) is the sum of the weight rows of the
+// active features, so a move only adds and subtracts the rows of the few
+// squares it changed - see Board::getLastChanges. A side's half has to be
+// recomputed when its own king moves.
+//
+// Inference is integer only: int16 accumulator, clipped to [0, 127] and
+// fed to an int8 hidden layer, then an int8 output neuron. The inner loops
+// run on AVX2 when the CPU has it and on plain C++ otherwise.
+namespace Nnue {
+    const int PIECE_KINDS = 10;  // Pawn to queen, own and opponent's
+    const int INPUT_SIZE = 64 * PIECE_KINDS * 64;
+    const int MAX_HIDDEN = 512;        // Accumulator width per side
+    const int MAX_OUTPUT_HIDDEN = 32;  // Width of the second layer
+    const int HIDDEN_SHIFT = 6;        // Scales the second layer's sums back to [0, 127]
+
+    // Input feature for a piece seen from one side, whose king is on kingSquare.
+    // Squares are Zobrist::squareIndex; black's view is mirrored top to bottom.
+    int featureIndex(Color perspective, int kingSquare, const Piece& piece, int square);
+
+    // Implementation of the inner loops, fixed at startup to the fastest one
+    // the CPU supports and changeable for testing and benchmarks
+    enum class Kernel { SCALAR, AVX2 };
+    bool avx2Supported();
+    Kernel getKernel();
+    bool setKernel(Kernel kernel);  // False if the CPU can't run it
+    const char* kernelName(Kernel kernel);
+
+    // First layer output for both sides (index Color::WHITE = 0, BLACK = 1)
+    struct Accumulator {
+        alignas(32) int16_t values[2][MAX_HIDDEN];
+        int kingSquare[2];
+    };
+
+    // Network weights, mapped from a file.
+    // File layout: 8-byte magic "CCNNUE1", hidden size (uint32), output
+    // hidden size (uint32), output divisor (int32), zero padding to 64 bytes,
+    // then - each section padded to a multiple of 64 bytes, native byte order:
+    //   int16 feature biases[hidden], int16 feature weights[INPUT_SIZE][hidden],
+    //   int32 hidden biases[outputHidden], int8 hidden weights[outputHidden][2 * hidden],
+    //   int32 output bias, int8 output weights[outputHidden]
+    // The hidden layer's inputs are the side to move's half, then the other.
+    class Network {
+    private:
+        MappedFile file;
+        int hiddenSize;
+        int outputHidden;
+        int outputDivisor;  // Output neuron units per centipawn
+
+        const int16_t* featureBiases;
+        const int16_t* featureWeights;
+        const int32_t* hiddenBiases;
+        const int8_t* hiddenWeights;
+        int32_t outputBias;
+        const int8_t* outputWeights;
+
+        void refreshSide(Accumulator& accumulator, const Board& board, Color perspective) const;
+
+    public:
+        static const char MAGIC[8];
+
+        Network();
+
+        // Map a network file. Returns false if it is missing or malformed.
+        bool load(const std::string& path);
+        bool isLoaded() const { return hiddenSize > 0; }
+
+        int getHiddenSize() const { return hiddenSize; }
+        int getOutputHidden() const { return outputHidden; }
+
+        // Compute an accumulator from scratch
+        void refresh(Accumulator& accumulator, const Board& board) const;
+
+        // Accumulator of a board from its parent's, using the changes of
+        // the board's last move
+        void update(Accumulator& accumulator, const Accumulator& parent, const Board& board) const;
+
+        // Centipawns from the side to move's view
+        int evaluate(const Accumulator& accumulator, Color sideToMove) const;
+        int evaluate(const Board& board) const;  // Refreshes a temporary accumulator
+    };
+
+    // Write a network with small random weights. It plays no better than
+    // chance; it exists for tests and benchmarks until a trained one is used.
+    bool writeRandomNetwork(const std::string& path, int hiddenSize, int outputHidden, uint32_t seed);
+}
+
+#endif // NNUE_H
@@ -0,0 +1,25 @@
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include "Board.h"
+#include <string>
+#include <string_view>
+
+// Standard Algebraic Notation (SAN), as used in PGN files: "e4", "Nbd7",
+// "exd5", "O-O", "e8=Q+". Both directions run on MoveGen, generating only
+// the legal moves to the destination square.
+namespace Notation {
+    // Resolve a SAN move against the position. Returns false if the text is
+    // malformed, or if it matches no legal move or more than one. A
+    // promotion without a piece letter is a queen.
+    bool fromSAN(const Board& board, std::string_view san, Move& move);
+    
+    // Write a legal move in SAN, with disambiguation and a check (+) or
+    // mate (#) suffix
+    std::string toSAN(const Board& board, const Move& move);
+    
+    // Piece letters used by SAN ('N' -> KNIGHT); EMPTY if not a piece letter
+    PieceType pieceFromLetter(char letter);
+}
+
+#endif // NOTATION_H
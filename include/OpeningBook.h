@@ -0,0 +1,53 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include "Board.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// One book entry: a move played from a position and how good it was.
+// Entries are 16 bytes; a book file stores them sorted by key, then move.
+struct BookEntry {
+    uint64_t key;      // Board::getHashKey() of the position
+    uint16_t move;     // OpeningBook::encodeMove() format
+    uint16_t weight;   // Relative probability of choosing the move
+    uint32_t games;    // Number of games that played the move here
+};
+
+static_assert(sizeof(BookEntry) == 16, "BookEntry must stay 16 bytes - it is the file format");
+
+// Binary opening book.
+// File layout: 8-byte magic "CCBOOK1", 8-byte entry count, then the sorted
+// entries in native byte order.
+class OpeningBook {
+private:
+    std::vector<BookEntry> entries;
+
+public:
+    static const char MAGIC[8];
+    
+    // Load a book file. Returns false (and leaves the book empty) on error.
+    bool load(const std::string& path);
+    
+    bool isLoaded() const { return !entries.empty(); }
+    size_t size() const { return entries.size(); }
+    
+    // All entries for a position (empty if the position isn't in the book)
+    std::vector<BookEntry> probe(uint64_t key) const;
+    
+    // Pick a legal book move for the side to move, weighted at random.
+    // Returns false if the position isn't in the book.
+    bool pickMove(const Board& board, Move& move) const;
+    
+    // Compact 16-bit move encoding: from square (6 bits), to square (6 bits),
+    // promotion piece (3 bits: 0 none, 1 knight, 2 bishop, 3 rook, 4 queen)
+    static uint16_t encodeMove(const Move& move);
+    static Move decodeMove(uint16_t code);
+    
+    // Write the file header; used by the book builder
+    static void writeHeader(std::ostream& out, uint64_t entryCount);
+};
+
+#endif // OPENING_BOOK_H
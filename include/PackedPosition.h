@@ -0,0 +1,44 @@
+#ifndef PACKED_POSITION_H
+#define PACKED_POSITION_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// A position in 32 bytes, for storing and scoring positions in bulk.
+// The occupied squares (bit = Zobrist::squareIndex) are followed by one
+// 4-bit code per occupied square in square order, low nibble first:
+// PieceType, plus 8 for black. A legal position has at most 32 pieces.
+struct PackedPosition {
+    uint64_t occupancy;
+    uint8_t pieces[16];
+    uint8_t sideToMove;     // 0 white, 1 black
+    uint8_t castling;       // Bits: white kingside, white queenside, black kingside, black queenside
+    int8_t enPassantCol;    // -1 if none
+    uint8_t halfMoveClock;  // Capped at 255
+    uint16_t fullMoveNumber;
+    uint8_t padding[2];
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition must stay 32 bytes - it is the file format");
+
+// Packed position files: 8-byte magic "CCPACK1", 8-byte record count, then
+// the records in native byte order
+namespace PackedPositions {
+    extern const char MAGIC[8];
+    const int BLACK_FLAG = 8;
+
+    // False if the board has more than 32 pieces
+    bool pack(const Board& board, PackedPosition& packed);
+    bool unpack(const PackedPosition& packed, Board& board);
+
+    void writeHeader(std::ostream& out, uint64_t count);
+
+    // The records of a mapped packed position file, without copying them.
+    // Returns false if the file isn't one.
+    bool records(const MappedFile& file, const PackedPosition*& first, size_t& count);
+}
+
+#endif // PACKED_POSITION_H
@@ -0,0 +1,65 @@
+#ifndef PAWN_STRUCTURE_H
+#define PAWN_STRUCTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pawn structure evaluation from pawn bitboards (bit = row * 8 + col,
+// row 0 is rank 8). Scores are in centipawns, positive for white.
+namespace PawnStructure {
+    const int DOUBLED_PENALTY = 10;   // Per extra pawn on a file
+    const int ISOLATED_PENALTY = 12;  // No friendly pawns on the neighbouring files
+    const int BACKWARD_PENALTY = 8;   // Can't be supported and can't safely advance
+    extern const int PASSED_BONUS[8]; // By rank, counted from the pawn's own side
+
+    int evaluate(uint64_t whitePawns, uint64_t blackPawns);
+
+    // How often each term occurs, white minus black, for fitting the
+    // weights. evaluate() is the weighted sum of these.
+    struct Terms {
+        int doubled;
+        int isolated;
+        int backward;
+        int passed[8];
+    };
+    Terms terms(uint64_t whitePawns, uint64_t blackPawns);
+}
+
+// Cache of pawn structure scores keyed by Board::getPawnKey().
+// Pawn moves are rare compared to other moves, so most probes during a
+// search hit. A new score replaces whatever was in its slot.
+class PawnHashTable {
+private:
+    struct Entry {
+        uint64_t key;
+        int32_t score;
+        int32_t padding;
+    };
+    
+    std::vector<Entry> entries;
+    uint64_t mask;
+
+public:
+    static const size_t DEFAULT_SIZE_KB = 1024;
+    
+    explicit PawnHashTable(size_t kilobytes = DEFAULT_SIZE_KB);
+    
+    void clear();
+    
+    // Cached score for a pawn key, or false if it isn't stored
+    bool probe(uint64_t key, int& score) const {
+        const Entry& entry = entries[key & mask];
+        if (entry.key != key) return false;
+        score = entry.score;
+        return true;
+    }
+    
+    void store(uint64_t key, int score) {
+        Entry& entry = entries[key & mask];
+        entry.key = key;
+        entry.score = score;
+    }
+};
+
+#endif // PAWN_STRUCTURE_H
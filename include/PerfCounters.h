@@ -0,0 +1,59 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// Hardware performance counters of the calling thread, read through Linux
+// perf_event_open: cycles, instructions, L1 data cache misses, last level
+// cache misses and branch mispredictions, counted in user space only.
+//
+// Each event is opened on its own, so a CPU or virtual machine without one
+// of them still counts the others. Where perf events aren't available at
+// all (another OS, a container without access, perf_event_paranoid too
+// high) nothing is counted and available() says so - callers print the
+// counters only when there are some. Counts are scaled up when the kernel
+// had to multiplex the events.
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        EVENT_COUNT
+    };
+
+    struct Counts {
+        double values[EVENT_COUNT] = {};
+        bool valid[EVENT_COUNT] = {};
+
+        bool any() const;
+        Counts& operator+=(const Counts& other);
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;
+    bool available(Event event) const { return fds[event] >= 0; }
+
+    // Count from zero between start and stop
+    void start();
+    Counts stop();
+
+    static const char* name(Event event);  // "cycles", "instructions", ...
+
+    // Why nothing can be counted, empty if something can
+    const std::string& problem() const { return error; }
+
+private:
+    int fds[EVENT_COUNT];
+    std::string error;
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,46 @@
+#ifndef PGN_H
+#define PGN_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One game from a PGN file: the tag pairs and the main-line moves in SAN.
+// Comments, variations, NAGs and move numbers are dropped while reading.
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::vector<std::string> moves;
+    std::string result;  // "1-0", "0-1", "1/2-1/2" or "*"
+    
+    // Value of a tag, or an empty string if the game doesn't have it
+    std::string getTag(const std::string& name) const;
+};
+
+// Reads games one at a time from a stream, so files of any size can be
+// processed without loading them into memory
+class PgnReader {
+private:
+    std::istream& input;
+    
+    // Tokenizer state carried across lines
+    int commentDepth;    // Inside {...}
+    int variationDepth;  // Inside (...)
+    
+    void parseTag(const std::string& line, PgnGame& game) const;
+    bool parseMovetext(const std::string& line, PgnGame& game);  // true when the result was found
+
+public:
+    explicit PgnReader(std::istream& in);
+    
+    // Read the next game. Returns false when the input is exhausted.
+    bool readGame(PgnGame& game);
+};
+
+// Write a game in PGN export format: tags, a blank line, then the movetext
+// with move numbers, wrapped to 80 columns. A "FEN" tag sets where the move
+// numbering starts.
+void writePgnGame(std::ostream& out, const PgnGame& game);
+
+#endif // PGN_H
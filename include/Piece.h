@@ -2,6 +2,7 @@
 #define PIECE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Enum for piece colors - in C++, enums help with type safety
@@ -36,6 +37,13 @@ struct Move {
         : fromRow(fr), fromCol(fc), toRow(tr), toCol(tc), 
           isCapture(false), isCastling(false), isEnPassant(false), 
           promotionPiece(PieceType::EMPTY) {}
+    Move() : Move(0, 0, 0, 0) {}
+};
+
+// Unicode symbols by [color][PieceType], for rendering without allocating
+constexpr std::string_view PIECE_SYMBOLS[2][6] = {
+    {"♙", "♖", "♘", "♗", "♕", "♔"},
+    {"♟", "♜", "♞", "♝", "♛", "♚"}
 };
 
 // Class representing a chess piece
@@ -58,6 +66,12 @@ public:
     // Get Unicode symbol for display
     std::string getSymbol() const;
     
+    // Same symbol as a view into PIECE_SYMBOLS - a space for empty squares
+    std::string_view getSymbolView() const {
+        if (type == PieceType::EMPTY || color == Color::NONE) return " ";
+        return PIECE_SYMBOLS[static_cast<int>(color)][static_cast<int>(type)];
+    }
+    
     // Get piece value for AI evaluation
     int getValue() const;
     
@@ -0,0 +1,47 @@
+#ifndef PIECE_SQUARE_TABLES_H
+#define PIECE_SQUARE_TABLES_H
+
+#include "Piece.h"
+
+// Material plus piece-square bonuses, separately for the midgame and the
+// endgame. Board keeps running sums of both and a game phase counter up to
+// date as pieces move; the evaluation blends the two sums by phase
+// ("tapered evaluation"), so a king that should hide behind its pawns with
+// queens on the board walks to the centre once they are gone.
+//
+// Values are for the piece's own side; squares use Zobrist::squareIndex.
+namespace PieceSquareTables {
+    // Phase contributed by each piece; all minor and major pieces on the
+    // board add up to MAX_PHASE (pure midgame), none gives 0 (pure endgame)
+    const int MAX_PHASE = 24;
+
+    // Material plus bonus for every piece, built once. Indexed by color
+    // (white, black), PieceType and square, for code scoring many pieces.
+    struct ScoreTable {
+        int midgame[2][6][64];
+        int endgame[2][6][64];
+        int phase[6];
+    };
+    const ScoreTable& table();
+
+    int midgame(PieceType type, Color color, int square);
+    int endgame(PieceType type, Color color, int square);
+    int phaseWeight(PieceType type);
+
+    // Blend a midgame and an endgame score by phase (more than MAX_PHASE
+    // after promotions counts as MAX_PHASE)
+    inline int taper(int midgameScore, int endgameScore, int phase) {
+        if (phase > MAX_PHASE) phase = MAX_PHASE;
+        return (midgameScore * phase + endgameScore * (MAX_PHASE - phase)) / MAX_PHASE;
+    }
+
+    // Material by PieceType; the king is never captured
+    extern const int MIDGAME_VALUE[6];
+    extern const int ENDGAME_VALUE[6];
+
+    // Bonus tables from white's point of view, row 0 = rank 8
+    extern const int MIDGAME_BONUS[6][8][8];  // Indexed by PieceType
+    extern const int ENDGAME_BONUS[6][8][8];
+}
+
+#endif // PIECE_SQUARE_TABLES_H
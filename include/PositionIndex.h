@@ -0,0 +1,108 @@
+#ifndef POSITION_INDEX_H
+#define POSITION_INDEX_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include "MappedPgn.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// A game archive indexed by position: for every position reached, the moves
+// played from it and how those games ended. Built once from a PGN file,
+// then memory-mapped, so a lookup reads one or two small blocks.
+//
+// File layout: header, compressed blocks, then the block directory (the
+// first key of every block, followed by blockCount + 1 block offsets).
+// Entries are sorted by key, then move. Within a block each entry is a run
+// of varints: key delta from the previous entry (from the block's first key
+// for the first entry), move, games, white wins, draws, black wins.
+class PositionIndex {
+public:
+    // One move played from a position, with the results from white's view.
+    // Games that ended without a result count in games only; a game that
+    // plays the same move from a repeated position counts each time.
+    struct MoveStats {
+        uint16_t move;  // OpeningBook::encodeMove() format
+        uint32_t games;
+        uint32_t whiteWins;
+        uint32_t draws;
+        uint32_t blackWins;
+    };
+
+    // A (key, move) pair with its counts, as the builder sorts and writes them
+    struct Record {
+        uint64_t key;  // Board::getHashKey() before the move
+        MoveStats stats;
+    };
+
+    // Streams sorted records into an index file with bounded memory
+    class Writer {
+    private:
+        std::ofstream out;
+        std::vector<uint8_t> block;
+        std::vector<uint64_t> firstKeys;
+        std::vector<uint64_t> offsets;
+        uint64_t previousKey = 0;
+        uint64_t entries = 0;
+        uint64_t games;
+        int blockCount = 0;  // Entries in the current block
+
+        void flushBlock();
+
+    public:
+        Writer(const std::string& path, uint64_t games);
+        bool isOpen() const { return static_cast<bool>(out); }
+
+        // Records must come in (key, move) order, each pair once
+        void add(const Record& record);
+        bool finish();  // Writes the directory and the header
+    };
+
+    struct BuildOptions {
+        int threads = 0;             // <= 0: one per hardware thread
+        int maxPly = 0;              // Positions per game; 0 for all
+        size_t memoryMB = 256;       // Records held in memory before spilling a run
+        std::string tempDir = ".";
+    };
+
+    struct BuildStats {
+        size_t games = 0;
+        size_t positions = 0;
+        size_t entries = 0;
+        size_t runs = 0;
+        double seconds = 0.0;
+    };
+
+    static const char MAGIC[8];
+    static const uint32_t BLOCK_ENTRIES = 64;
+
+    bool open(const std::string& path);
+    bool isOpen() const { return file.isOpen(); }
+
+    size_t size() const { return entries; }  // (position, move) pairs
+    size_t gameCount() const { return games; }
+
+    // Moves played from the position, most played first; empty if it
+    // was never reached. Keys can collide, so callers that replay a move
+    // should check it is legal.
+    std::vector<MoveStats> lookup(uint64_t key) const;
+    std::vector<MoveStats> lookup(const Board& board) const { return lookup(board.getHashKey()); }
+
+    // Replay the archive on all threads, sort the records in runs on disk
+    // and merge them into an index file
+    static bool build(const MappedPgn& archive, const std::string& path, const BuildOptions& options,
+                      BuildStats& stats);
+
+private:
+    MappedFile file;
+    const uint64_t* firstKeys = nullptr;
+    const uint64_t* offsets = nullptr;
+    size_t entries = 0;
+    size_t games = 0;
+    size_t blockCount = 0;
+};
+
+#endif // POSITION_INDEX_H
@@ -0,0 +1,70 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <ostream>
+#include <vector>
+
+// Build with SEARCH_STATS=0 to compile the counters out of the search.
+// Node counts and iteration timings are always kept - the search needs
+// them for its own limits.
+#ifndef SEARCH_STATS
+#define SEARCH_STATS 1
+#endif
+
+// One completed iteration of iterative deepening
+struct IterationStats {
+    int depth;
+    long long nodes;         // Nodes searched in this iteration alone
+    double milliseconds;     // Time spent on this iteration
+    double branchingFactor;  // Nodes relative to the previous iteration (0 for the first)
+};
+
+// What happened during one AI::getBestMove call
+struct SearchStats {
+    static const bool ENABLED = SEARCH_STATS != 0;
+    static const int CUTOFF_SLOTS = 8;  // Beta cutoffs by move index; the last slot is "7 or later"
+    
+    long long nodes;
+    long long qnodes;       // Quiescence nodes (the search has no quiescence stage yet, so 0)
+    long long ttProbes;
+    long long ttHits;
+    long long ttCutoffs;    // Hits whose stored bound ended the node
+    long long pawnProbes;   // Pawn structure cache lookups
+    long long pawnHits;
+    long long betaCutoffs[CUTOFF_SLOTS];
+    int peakPly;            // Deepest ply reached, counting from the root
+    double milliseconds;
+    std::vector<IterationStats> iterations;
+    
+    SearchStats() { reset(); }
+    void reset();
+    
+    // Recording hooks for the search; empty when statistics are disabled
+    void recordPly(int ply) {
+        if (ENABLED && ply > peakPly) peakPly = ply;
+    }
+    void recordProbe(bool hit) {
+        if (ENABLED) { ++ttProbes; ttHits += hit; }
+    }
+    void recordTTCutoff() {
+        if (ENABLED) ++ttCutoffs;
+    }
+    void recordPawnProbe(bool hit) {
+        if (ENABLED) { ++pawnProbes; pawnHits += hit; }
+    }
+    void recordBetaCutoff(int moveIndex) {
+        if (ENABLED) ++betaCutoffs[moveIndex < CUTOFF_SLOTS ? moveIndex : CUTOFF_SLOTS - 1];
+    }
+    
+    // Summaries
+    int getDepth() const { return iterations.empty() ? 0 : iterations.back().depth; }
+    long long getNodesPerSecond() const;
+    double getTTHitRate() const;         // 0..1
+    double getPawnHitRate() const;       // 0..1
+    double getFirstMoveCutoffRate() const;  // Share of beta cutoffs on the first move, 0..1
+    
+    // Multi-line human readable report
+    void print(std::ostream& out) const;
+};
+
+#endif // SEARCH_STATS_H
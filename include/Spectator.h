@@ -0,0 +1,81 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include "BoardRenderer.h"
+#include "PackedPosition.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// A position as a game thread hands it to the spectator
+struct BoardSnapshot {
+    PackedPosition position;
+    int game;        // 1-based game number
+    int ply;
+    char result[8];  // Empty while the game is running
+};
+
+// Shows several running games at once, tiled across the terminal.
+//
+// Game threads attach() to get a board of their own and publish() snapshots
+// to it through a lock-free single-producer/single-consumer queue; a full
+// queue drops the snapshot, so a game never waits. One render thread drains
+// the queues at a capped frame rate, keeps only the newest snapshot of each
+// board and repaints just the squares that changed, in one write per frame.
+class Spectator {
+public:
+    static const int TILE_WIDTH = 20;    // Rank digit, 8 two-column squares, gap
+    static const int TILE_HEIGHT = 10;   // Title, 8 ranks, gap
+    static const int TILES_PER_ROW = 80 / TILE_WIDTH;
+    static const size_t QUEUE_SIZE = 64;
+
+    // A negative fd renders without writing (for tests)
+    Spectator(int boards, int framesPerSecond, int fd = 1);
+    ~Spectator();  // Stops the render thread
+
+    Spectator(const Spectator&) = delete;
+    Spectator& operator=(const Spectator&) = delete;
+
+    void start();
+    // Draws the last snapshots and leaves the cursor under the tiles
+    void stop();
+
+    // Game threads. attach() returns -1 while every board shows another game;
+    // the board is the caller's until detach().
+    int attach();
+    void detach(int board);
+    bool publish(int board, const BoardSnapshot& snapshot);  // False if dropped
+
+    int getBoardCount() const { return static_cast<int>(boards.size()); }
+    uint64_t getFramesDrawn() const { return framesDrawn; }
+    uint64_t getDropped() const { return dropped; }
+
+private:
+    struct Tile {
+        SpscQueue<BoardSnapshot, QUEUE_SIZE> queue;
+        std::atomic<bool> attached{false};
+
+        // Render thread only
+        BoardSnapshot latest{};
+        bool changed = false;
+        Piece shown[64];
+    };
+
+    std::vector<std::unique_ptr<Tile>> boards;
+    int frameMicroseconds;
+    BoardRenderer renderer;
+    std::thread renderThread;
+    std::atomic<bool> running;
+    bool onScreen;
+    std::atomic<uint64_t> framesDrawn;
+    std::atomic<uint64_t> dropped;
+
+    void renderLoop();
+    void drawFrame();
+    void drawTile(int index, Tile& tile, bool whole);
+};
+
+#endif // SPECTATOR_H
@@ -0,0 +1,62 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Endgame tablebases for positions with up to four pieces (kings included).
+//
+// Each material signature ("KQK", "KRKP", ...) has one table holding the
+// exact result for every placement of its pieces: win, draw or loss for the
+// side to move, and the distance to mate. Tables are built by retrograde
+// analysis - starting from the mates and working backwards one ply at a time -
+// and stored run-length compressed in blocks. Files are memory-mapped at
+// probe time, so only the blocks a search touches are ever read.
+//
+// The signature lists the stronger side first; positions where black has
+// the stronger material are probed with the colors swapped.
+// Castling and en passant are not covered.
+class Tablebase {
+public:
+    enum class Result { UNKNOWN, WIN, DRAW, LOSS };  // From the side to move's view
+
+    struct ProbeResult {
+        Result result;
+        int pliesToMate;  // 0 for draws; 0 for LOSS means checkmated now
+    };
+
+    static const int MAX_PIECES = 4;
+    static const char* const FILE_EXTENSION;  // ".cctb"
+
+    Tablebase();
+    ~Tablebase();
+
+    // Map all table files found in a directory. Returns the number loaded.
+    int load(const std::string& directory);
+
+    int getTableCount() const { return static_cast<int>(tables.size()); }
+    int getMaxPieces() const { return maxPieces; }
+
+    // Look up a position. UNKNOWN if no table covers it.
+    ProbeResult probe(const Board& board) const;
+
+    // Generate a table (and any smaller tables it depends on that are not
+    // already in the directory) and write it to the directory.
+    static bool generate(const std::string& signature, const std::string& directory,
+                         int threads, std::ostream& log);
+
+    // Every canonical signature with 3 up to maxPieces pieces
+    static std::vector<std::string> allSignatures(int maxPieces);
+
+private:
+    struct MappedTable;
+    std::map<std::string, std::unique_ptr<MappedTable>> tables;
+    int maxPieces;
+};
+
+#endif // TABLEBASE_H
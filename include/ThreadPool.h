@@ -0,0 +1,62 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool.
+// Every worker has its own task deque. A worker takes tasks from the back of
+// its own deque and, when that runs dry, steals from the front of the others,
+// so long and short tasks balance out across cores. Tasks submitted from a
+// worker go to that worker's own deque.
+// Workers can be pinned to a core each, so a search keeps its caches and
+// the memory it first touched stays on its NUMA node.
+class ThreadPool {
+private:
+    struct TaskQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+    
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue;
+    
+    // Sleeping and completion tracking
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t queuedTasks;   // In a deque, not yet started
+    size_t pendingTasks;  // Submitted and not finished
+    bool stopping;
+    bool pinned;
+    
+    bool takeTask(size_t id, std::function<void()>& task);
+    void workerLoop(size_t id);
+
+public:
+    // threads <= 0 means one per hardware thread. Pinned workers run on
+    // core (worker index % hardware threads); where that isn't supported
+    // they run unpinned.
+    explicit ThreadPool(int threads = 0, bool pinned = false);
+    ~ThreadPool();  // Finishes all submitted tasks first
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    void submit(std::function<void()> task);
+    void wait();  // Block until every submitted task has finished
+    
+    int size() const { return static_cast<int>(workers.size()); }
+    
+    // Restrict the calling thread to one core; false if it can't be done
+    static bool pinCurrentThread(int core);
+};
+
+#endif // THREAD_POOL_H
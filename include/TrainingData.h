@@ -0,0 +1,70 @@
+#ifndef TRAINING_DATA_H
+#define TRAINING_DATA_H
+
+#include "AsyncFileWriter.h"
+#include "Board.h"
+#include "MappedFile.h"
+#include "PackedPosition.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A scored position from a finished game, for fitting the evaluation.
+// The board is stored as in PackedPosition (occupied squares, then a 4-bit
+// piece code per occupied square); the half-move clock is left out to make
+// room for the search score and the game result.
+struct TrainingPosition {
+    uint64_t occupancy;
+    uint8_t pieces[16];
+    int16_t score;          // Search score in centipawns, white's view
+    int8_t result;          // 1 white won, 0 draw, -1 black won
+    uint8_t sideToMove;     // 0 white, 1 black
+    uint8_t castling;       // As in PackedPosition
+    int8_t enPassantCol;    // -1 if none
+    uint16_t fullMoveNumber;
+};
+
+static_assert(sizeof(TrainingPosition) == 32, "TrainingPosition must stay 32 bytes - it is the file format");
+
+// Training data files: 8-byte magic "CCTRAIN", 8-byte record count, then
+// the records in native byte order, so a mapped file can be used in place
+namespace TrainingData {
+    extern const char MAGIC[8];
+
+    // Scores beyond this are clamped (mate scores don't fit in 16 bits)
+    const int MAX_SCORE = 32000;
+
+    // False if the board has more than 32 pieces
+    bool pack(const Board& board, int score, int result, TrainingPosition& position);
+    bool unpack(const TrainingPosition& position, Board& board);
+
+    // The board alone, for code that scores PackedPositions (half-move clock 0)
+    void toPacked(const TrainingPosition& position, PackedPosition& packed);
+
+    // The records of a mapped training data file, without copying them.
+    // Returns false if the file isn't one.
+    bool records(const MappedFile& file, const TrainingPosition*& first, size_t& count);
+
+    // Streams records to a file through an AsyncFileWriter; the count in
+    // the header is filled in by finish()
+    class Writer {
+    private:
+        std::string path;
+        AsyncFileWriter out;
+        uint64_t count;
+
+    public:
+        explicit Writer(const std::string& path);
+        bool isOpen() const { return out.isOpen(); }
+
+        void add(const TrainingPosition& position) {
+            out.write(&position, sizeof(position));
+            ++count;
+        }
+        bool finish();
+
+        uint64_t size() const { return count; }
+    };
+}
+
+#endif // TRAINING_DATA_H
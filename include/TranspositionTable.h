@@ -0,0 +1,85 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "LargePages.h"
+#include "Piece.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// What a stored score says about the true value of the position
+enum class Bound : uint8_t {
+    NONE,   // Empty slot
+    EXACT,  // Score is the value
+    LOWER,  // Value >= score (the search failed high)
+    UPPER   // Value <= score (the search failed low)
+};
+
+// One search result. 16 bytes, so four entries share a cache line.
+struct TTEntry {
+    uint64_t key;     // Board::getHashKey() of the position
+    int32_t score;
+    uint16_t move;    // OpeningBook::encodeMove() format, 0 if none
+    int8_t depth;     // Remaining depth the score was searched to
+    Bound bound;
+};
+
+static_assert(sizeof(TTEntry) == 16, "TTEntry should stay 16 bytes");
+
+// Transposition table: remembers search results by position key, so a
+// position reached again (by another move order, or in the next iteration
+// of iterative deepening) is not searched twice, and the best move found
+// last time can be tried first.
+// The size is rounded down to a power of two entries; a new result
+// replaces whatever was in its slot unless that is a deeper result for the
+// same position. The entries live in LargePages memory (2 MB pages where
+// the system has them, see setLargePages). They are left untouched until
+// the first store - clear() skips a table nothing was stored in - so each
+// page is placed on the NUMA node of the thread that searches with it.
+//
+// A snapshot keeps the deep entries across runs: a 32-byte header (magic,
+// entry count, checksum of the entries, the minimum depth kept and the side
+// whose view the scores are from), then the entries as they are in memory,
+// so a snapshot file can be mapped and read in place.
+class TranspositionTable {
+private:
+    LargePages memory;
+    TTEntry* entries;
+    size_t count;
+    uint64_t mask;
+    bool zeroed;  // Nothing stored since the memory was allocated or cleared
+
+public:
+    static const size_t DEFAULT_SIZE_MB = 16;
+    static const int SNAPSHOT_MIN_DEPTH = 2;  // Shallower results are quick to find again
+    static const char SNAPSHOT_MAGIC[8];
+    
+    explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB);
+    
+    void resize(size_t megabytes);
+    void clear();  // On several threads for large tables; nothing to do while zeroed
+    void prefault();  // Write every page now, on this thread, instead of during a search
+    
+    size_t size() const { return count; }
+    LargePages::Kind pageKind() const { return memory.kind(); }
+    
+    // Whether tables allocated from now on may use huge pages (default yes)
+    static void setLargePages(bool enabled);
+    
+    // The entry for a position, or nullptr if it isn't stored
+    const TTEntry* probe(uint64_t key) const;
+    
+    void store(uint64_t key, int score, int depth, Bound bound, uint16_t move);
+    
+    // Write the entries searched to at least minDepth; scores are from
+    // perspective's point of view. Returns the number written, -1 on error.
+    long long save(const std::string& path, int minDepth, Color perspective) const;
+    
+    // Add a snapshot's entries to the table, where they are deeper than what
+    // their slot holds. Scores are negated for a snapshot taken from the
+    // other side's view. Returns the number loaded, -1 if the file is
+    // missing, not a snapshot or fails its checksum.
+    long long load(const std::string& path, Color perspective);
+};
+
+#endif // TRANSPOSITION_TABLE_H
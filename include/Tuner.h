@@ -0,0 +1,97 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include "ThreadPool.h"
+#include "TrainingData.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Texel tuning of the hand-written evaluation against game results.
+//
+// Once the game phase is known the evaluation is linear in its weights:
+// material, piece-square bonuses and mobility are blended by phase, the
+// pawn structure terms are added as they are, and king safety (not linear)
+// is kept fixed. Every position is reduced once to the terms it contains,
+// so scoring it with new weights is a short dot product, and the gradient
+// of the loss is exact. The loss is the cross-entropy between
+// sigmoid(scale * eval) and the target, the game result optionally blended
+// with the search score.
+namespace Tuner {
+    // Weight layout. Tapered weights come in (midgame, endgame) pairs at
+    // 2 * pair and 2 * pair + 1; the untapered pawn weights follow them.
+    const int MATERIAL_PAIRS = 0;                 // By PieceType, without the king
+    const int BONUS_PAIRS = MATERIAL_PAIRS + 5;   // By PieceType and square, white's view
+    const int MOBILITY_PAIRS = BONUS_PAIRS + 6 * 64;  // By PieceType
+    const int PAIR_COUNT = MOBILITY_PAIRS + 6;
+    const int DOUBLED = 2 * PAIR_COUNT;           // Penalties, as in PawnStructure
+    const int ISOLATED = DOUBLED + 1;
+    const int BACKWARD = DOUBLED + 2;
+    const int PASSED = DOUBLED + 3;               // By rank
+    const int WEIGHT_COUNT = PASSED + 8;
+
+    // The weights the evaluation uses now
+    std::vector<double> currentWeights();
+
+    // Training positions reduced to their terms, held in memory
+    class Dataset {
+    public:
+        static const size_t CHUNK_POSITIONS = 16384;  // Positions per task
+
+        // Corrupt records are skipped
+        void load(const TrainingPosition* positions, size_t count, ThreadPool& pool);
+        size_t size() const { return positionCount; }
+
+        // Evaluation of one position with these weights, white's view
+        double evaluate(size_t index, const std::vector<double>& weights) const;
+
+        // Aim at lambda * result + (1 - lambda) * sigmoid(scale * search score)
+        void setTargets(double scale, double lambda);
+
+        // Mean loss over all positions. When gradient isn't null it is
+        // replaced by the gradient of the loss with respect to the weights.
+        double loss(const std::vector<double>& weights, double scale, ThreadPool& pool,
+                    std::vector<double>* gradient) const;
+
+        // Scale for which the weights best predict the results
+        double fitScale(const std::vector<double>& weights, ThreadPool& pool);
+
+    private:
+        // Weight index (the pair for tapered terms) and how often it counts
+        struct Term {
+            uint16_t weight;
+            int16_t count;
+        };
+
+        struct Position {
+            uint32_t firstTerm;
+            uint8_t pairTerms;   // Tapered terms first,
+            uint8_t plainTerms;  // then the untapered ones
+            uint16_t padding;
+            float phase;         // Midgame share, 0 to 1
+            float fixed;         // King safety, already tapered
+            float result;        // 1 white won, 0.5 draw, 0 black won
+            float score;         // Search score, white's view
+            float target;
+        };
+
+        struct Chunk {
+            std::vector<Term> terms;
+            std::vector<Position> positions;
+        };
+
+        std::vector<Chunk> chunks;
+        size_t positionCount = 0;
+
+        static double evaluate(const Term* terms, const Position& position, const double* weights);
+        double chunkLoss(const Chunk& chunk, const std::vector<double>& weights, double scale,
+                         double* gradient) const;
+    };
+
+    // The weights as the C++ tables of PieceSquareTables.cpp, Mobility.cpp
+    // and PawnStructure, rounded
+    void writeTables(std::ostream& out, const std::vector<double>& weights);
+}
+
+#endif // TUNER_H
@@ -0,0 +1,21 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Piece.h"
+#include <cstdint>
+
+// Zobrist hashing - every (piece, square) pair gets a random 64-bit key and a
+// position's key is the XOR of the keys of everything on the board.
+// The keys are generated from a fixed seed, so position keys are stable across
+// runs and builds. Files that store keys (opening books etc.) depend on that.
+namespace Zobrist {
+    // Square index used by all keys: row * 8 + col (row 0 is rank 8)
+    inline int squareIndex(int row, int col) { return row * 8 + col; }
+
+    uint64_t pieceKey(PieceType type, Color color, int square);
+    uint64_t sideKey();                 // XORed in when black is to move
+    uint64_t castlingKey(int right);    // 0 = white O-O, 1 = white O-O-O, 2 = black O-O, 3 = black O-O-O
+    uint64_t enPassantKey(int col);
+}
+
+#endif // ZOBRIST_H
@@ -1,11 +1,158 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
+#include "include/Batch.h"
+#include "include/Bench.h"
 #include "include/Game.h"
+#include "include/Profiler.h"
 
-int main() {
-    std::cout << "Welcome to Console Chess!" << std::endl;
+// --batch: play move lists from a file or stdin without the interface
+int runBatch(const std::string& path) {
+    std::ios::sync_with_stdio(false);
+    
+    std::ifstream file;
+    if (!path.empty() && path != "-") {
+        file.open(path);
+        if (!file) {
+            std::cerr << "Could not open move list: " << path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& input = file.is_open() ? static_cast<std::istream&>(file) : std::cin;
+    
+    Batch::Summary summary = Batch::run(input, std::cout, std::cerr);
+    std::cout.flush();
+    std::cerr << "Played " << summary.games << " games, " << summary.moves << " moves in " << std::fixed
+              << std::setprecision(3) << summary.seconds << " s (" << std::setprecision(0)
+              << (summary.seconds > 0 ? summary.moves / summary.seconds : 0.0) << " moves/s)";
+    if (summary.failed > 0) std::cerr << ", " << summary.failed << " stopped early";
+    std::cerr << std::endl;
+    return summary.failed == 0 ? 0 : 1;
+}
+
+// bench: search the built-in positions; the node count is the signature
+int runBench(int argc, char* argv[]) {
+    int depth = Bench::DEFAULT_DEPTH;
+    bool json = false;
+    bool counters = false;
+    std::string profilePath;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) {
+            depth = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg == "--counters") {
+            counters = true;
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " bench [--depth N] [--json] [--counters] [--profile <file>]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    
+    std::unique_ptr<PerfCounters> hardware;
+    if (counters) {
+        hardware = std::make_unique<PerfCounters>();
+        if (!hardware->available()) {
+            std::cerr << "Hardware counters unavailable (" << hardware->problem() << "), timing only" << std::endl;
+            hardware.reset();
+        }
+    }
+    
+    if (!profilePath.empty() && !Profiler::ENABLED) {
+        std::cerr << "Profiling is compiled out - build with PROFILE=1 (after make clean)" << std::endl;
+        return 1;
+    }
+    
+    // Progress goes to stderr so the JSON on stdout can be piped as it is
+    Profiler::reset();
+    Bench::Result result = Bench::run(depth, &std::cerr, hardware.get());
+    if (json) {
+        Bench::writeJson(result, std::cout);
+    } else {
+        Bench::printReport(result, std::cout);
+    }
+    
+    if (!profilePath.empty()) {
+        std::ofstream trace(profilePath);
+        if (!trace) {
+            std::cerr << "Could not write trace: " << profilePath << std::endl;
+            return 1;
+        }
+        Profiler::writeChromeTrace(trace);
+        std::ostream& out = json ? std::cerr : std::cout;
+        out << "\n";
+        Profiler::printFlatProfile(out);
+        out << "Chrome trace written to " << profilePath << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "bench") return runBench(argc, argv);
     
     Game game;
+    bool batch = false;
+    std::string batchPath;
+    
+    // Command line options
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--book" && i + 1 < argc) {
+            std::string path = argv[++i];
+            if (!game.loadOpeningBook(path)) {
+                std::cerr << "Could not load opening book: " << path << std::endl;
+                return 1;
+            }
+        } else if (arg == "--tb" && i + 1 < argc) {
+            std::string directory = argv[++i];
+            if (game.loadTablebases(directory) == 0) {
+                std::cerr << "No tablebase files found in: " << directory << std::endl;
+                return 1;
+            }
+        } else if (arg == "--nnue" && i + 1 < argc) {
+            std::string path = argv[++i];
+            if (!game.loadNetwork(path)) {
+                std::cerr << "Could not load network: " << path << std::endl;
+                return 1;
+            }
+        } else if (arg == "--index" && i + 1 < argc) {
+            std::string path = argv[++i];
+            if (!game.loadPositionIndex(path)) {
+                std::cerr << "Could not open position index: " << path << std::endl;
+                return 1;
+            }
+        } else if (arg == "--hash" && i + 1 < argc) {
+            std::string path = argv[++i];
+            if (!game.loadHashSnapshot(path)) {
+                std::cerr << "Not a usable transposition table snapshot: " << path << std::endl;
+                return 1;
+            }
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') batchPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--book <file>] [--tb <directory>] [--nnue <file>] [--index <file>]"
+                      << " [--hash <file>]\n"
+                      << "       " << argv[0] << " --batch [moves file]   Play move lists without the interface\n"
+                      << "       " << argv[0] << " bench [--depth N] [--json] [--counters] [--profile <file>]"
+                      << "   Search speed on fixed positions"
+                      << std::endl;
+            return 1;
+        }
+    }
+    
+    if (batch) return runBatch(batchPath);
+    
+    std::cout << "Welcome to Console Chess!" << std::endl;
+    
     game.run();
     
     return 0;
@@ -1,80 +1,20 @@
 #include "../include/AI.h"
+#include "../include/Mobility.h"
+#include "../include/PieceSquareTables.h"
+#include "../include/Profiler.h"
 #include <algorithm>
 #include <random>
 #include <climits>
 
-// Position bonus tables for different pieces (simplified)
-const int AI::PAWN_POSITION_BONUS[8][8] = {
-    {0,  0,  0,  0,  0,  0,  0,  0},
-    {50, 50, 50, 50, 50, 50, 50, 50},
-    {10, 10, 20, 30, 30, 20, 10, 10},
-    {5,  5, 10, 25, 25, 10,  5,  5},
-    {0,  0,  0, 20, 20,  0,  0,  0},
-    {5, -5,-10,  0,  0,-10, -5,  5},
-    {5, 10, 10,-20,-20, 10, 10,  5},
-    {0,  0,  0,  0,  0,  0,  0,  0}
-};
-
-const int AI::KNIGHT_POSITION_BONUS[8][8] = {
-    {-50,-40,-30,-30,-30,-30,-40,-50},
-    {-40,-20,  0,  0,  0,  0,-20,-40},
-    {-30,  0, 10, 15, 15, 10,  0,-30},
-    {-30,  5, 15, 20, 20, 15,  5,-30},
-    {-30,  0, 15, 20, 20, 15,  0,-30},
-    {-30,  5, 10, 15, 15, 10,  5,-30},
-    {-40,-20,  0,  5,  5,  0,-20,-40},
-    {-50,-40,-30,-30,-30,-30,-40,-50}
-};
-
-const int AI::BISHOP_POSITION_BONUS[8][8] = {
-    {-20,-10,-10,-10,-10,-10,-10,-20},
-    {-10,  0,  0,  0,  0,  0,  0,-10},
-    {-10,  0,  5, 10, 10,  5,  0,-10},
-    {-10,  5,  5, 10, 10,  5,  5,-10},
-    {-10,  0, 10, 10, 10, 10,  0,-10},
-    {-10, 10, 10, 10, 10, 10, 10,-10},
-    {-10,  5,  0,  0,  0,  0,  5,-10},
-    {-20,-10,-10,-10,-10,-10,-10,-20}
-};
-
-const int AI::ROOK_POSITION_BONUS[8][8] = {
-    {0,  0,  0,  0,  0,  0,  0,  0},
-    {5, 10, 10, 10, 10, 10, 10,  5},
-    {-5,  0,  0,  0,  0,  0,  0, -5},
-    {-5,  0,  0,  0,  0,  0,  0, -5},
-    {-5,  0,  0,  0,  0,  0,  0, -5},
-    {-5,  0,  0,  0,  0,  0,  0, -5},
-    {-5,  0,  0,  0,  0,  0,  0, -5},
-    {0,  0,  0,  5,  5,  0,  0,  0}
-};
-
-const int AI::QUEEN_POSITION_BONUS[8][8] = {
-    {-20,-10,-10, -5, -5,-10,-10,-20},
-    {-10,  0,  0,  0,  0,  0,  0,-10},
-    {-10,  0,  5,  5,  5,  5,  0,-10},
-    {-5,  0,  5,  5,  5,  5,  0, -5},
-    {0,  0,  5,  5,  5,  5,  0, -5},
-    {-10,  5,  5,  5,  5,  5,  0,-10},
-    {-10,  0,  5,  0,  0,  0,  0,-10},
-    {-20,-10,-10, -5, -5,-10,-10,-20}
-};
-
-const int AI::KING_POSITION_BONUS[8][8] = {
-    {-30,-40,-40,-50,-50,-40,-40,-30},
-    {-30,-40,-40,-50,-50,-40,-40,-30},
-    {-30,-40,-40,-50,-50,-40,-40,-30},
-    {-30,-40,-40,-50,-50,-40,-40,-30},
-    {-20,-30,-30,-40,-40,-30,-30,-20},
-    {-10,-20,-20,-20,-20,-20,-20,-10},
-    {20, 20,  0,  0,  0,  0, 20, 20},
-    {20, 30, 10,  0,  0, 10, 30, 20}
-};
-
 // Constructor
-AI::AI(AILevel level, Color color) : difficulty(level), aiColor(color) {}
+AI::AI(AILevel level, Color color)
+    : difficulty(level), aiColor(color), searchDepth(0), timeLimitMs(0), nodeLimit(0),
+      stopped(false), limitsActive(false) {}
 
 // Main AI method - returns the best move
 Move AI::getBestMove(const Board& board) {
+    PROFILE_SCOPE("AI::getBestMove");
+    stats.reset();
     std::vector<Move> legalMoves = board.getAllLegalMoves(aiColor);
     
     if (legalMoves.empty()) {
@@ -82,46 +22,171 @@ Move AI::getBestMove(const Board& board) {
         return Move(0, 0, 0, 0);
     }
     
+    // Play from the opening book while we can (the easy level stays random)
+    if (difficulty != AILevel::EASY && openingBook) {
+        Move bookMove(0, 0, 0, 0);
+        if (openingBook->pickMove(board, bookMove)) {
+            return bookMove;
+        }
+    }
+    
     switch (difficulty) {
         case AILevel::EASY:
             return getRandomMove(board);
             
         case AILevel::MEDIUM:
-        case AILevel::HARD: {
-            int maxDepth = (difficulty == AILevel::MEDIUM) ? 2 : 3;
-            
-            Move bestMove = legalMoves[0];
-            int bestScore = INT_MIN;
-            
-            // Order moves for better pruning
-            orderMoves(legalMoves, board);
+        case AILevel::HARD:
+            return searchRoot(board, legalMoves);
+    }
+    
+    return legalMoves[0];  // Fallback
+}
+
+// Iterative deepening: search depth 1, 2, 3, ... until the depth limit or
+// the budget is reached. Each iteration starts with the previous best move,
+// and the transposition table carries move ordering between iterations.
+Move AI::searchRoot(const Board& board, std::vector<Move>& moves) {
+    bool hasBudget = timeLimitMs > 0 || nodeLimit > 0;
+    int maxDepth = (difficulty == AILevel::MEDIUM) ? 2 : 3;
+    if (searchDepth > 0) {
+        maxDepth = searchDepth;
+    } else if (hasBudget) {
+        maxDepth = MAX_SEARCH_DEPTH;
+    }
+    
+    stopped = false;
+    limitsActive = false;
+    searchStart = std::chrono::steady_clock::now();
+    
+    if (network) {
+        network->refresh(accumulators[0], board);
+    }
+    
+    orderMoves(moves, board);
+    Move bestMove = moves[0];
+    
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        limitsActive = hasBudget && depth > 1;
+        long long nodesBefore = stats.nodes;
+        double iterationStart = elapsedMilliseconds();
+        
+        // Previous best move first
+        uint16_t previousBest = OpeningBook::encodeMove(bestMove);
+        std::stable_partition(moves.begin(), moves.end(), [previousBest](const Move& move) {
+            return OpeningBook::encodeMove(move) == previousBest;
+        });
+        
+        Move iterationBest = moves[0];
+        int bestScore = INT_MIN;
+        int alpha = INT_MIN;
+        
+        for (const Move& move : moves) {
+            // Make a copy of the board to test the move
+            Board testBoard = board;
+            testBoard.makeMove(move);
+            updateAccumulator(testBoard, 1);
             
-            for (const Move& move : legalMoves) {
-                // Make a copy of the board to test the move
-                Board testBoard = board;
-                testBoard.makeMove(move);
-                
-                // Use minimax to evaluate the position
-                int score = minimax(testBoard, maxDepth - 1, false, INT_MIN, INT_MAX);
-                
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestMove = move;
-                }
+            int score = minimax(testBoard, depth - 1, 1, false, alpha, INT_MAX);
+            if (stopped) {
+                break;
             }
             
-            return bestMove;
+            if (score > bestScore) {
+                bestScore = score;
+                iterationBest = move;
+            }
+            alpha = std::max(alpha, score);
+        }
+        
+        if (stopped) {
+            break;  // Unfinished iteration - keep the last complete one
+        }
+        
+        bestMove = iterationBest;
+        
+        long long iterationNodes = stats.nodes - nodesBefore;
+        double branchingFactor = 0.0;
+        if (!stats.iterations.empty() && stats.iterations.back().nodes > 0) {
+            branchingFactor = static_cast<double>(iterationNodes) / stats.iterations.back().nodes;
+        }
+        stats.iterations.push_back(IterationStats{depth, iterationNodes,
+                                                  elapsedMilliseconds() - iterationStart, branchingFactor});
+        
+        if (iterationCallback) {
+            iterationCallback(SearchIteration{depth, bestMove, bestScore, stats.nodes, elapsedMilliseconds()});
+        }
+        
+        // Nothing to gain from searching deeper
+        if (bestScore >= INT_MAX - 1000 || (hasBudget && moves.size() == 1)) {
+            break;
         }
     }
     
-    return legalMoves[0];  // Fallback
+    stats.milliseconds = elapsedMilliseconds();
+    return bestMove;
+}
+
+double AI::elapsedMilliseconds() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - searchStart).count();
+}
+
+// Stop the search once the node or time budget is used up
+void AI::checkLimits() {
+    if (nodeLimit > 0 && stats.nodes >= nodeLimit) {
+        stopped = true;
+    }
+    // Reading the clock is slow compared to a node, so only do it now and then
+    if (timeLimitMs > 0 && (stats.nodes & 1023) == 0 && elapsedMilliseconds() >= timeLimitMs) {
+        stopped = true;
+    }
 }
 
 // Minimax algorithm with alpha-beta pruning
-int AI::minimax(Board& board, int depth, bool isMaximizing, int alpha, int beta) {
+int AI::minimax(Board& board, int depth, int ply, bool isMaximizing, int alpha, int beta) {
+    ++stats.nodes;
+    stats.recordPly(ply);
+    if (limitsActive) {
+        checkLimits();
+        if (stopped) {
+            return 0;
+        }
+    }
+    
+    // Exact result from the tablebases once the material is low enough
+    if (tablebase && board.countPieces() <= tablebase->getMaxPieces()) {
+        Tablebase::ProbeResult probe = tablebase->probe(board);
+        if (probe.result != Tablebase::Result::UNKNOWN) {
+            int score = 0;
+            if (probe.result == Tablebase::Result::WIN) {
+                score = TABLEBASE_WIN - probe.pliesToMate;
+            } else if (probe.result == Tablebase::Result::LOSS) {
+                score = -(TABLEBASE_WIN - probe.pliesToMate);
+            }
+            // The probe is from the side to move's view; the AI maximizes
+            return isMaximizing ? score : -score;
+        }
+    }
+    
     // Base case: reached maximum depth or game over
     if (depth == 0) {
-        return evaluateBoard(board);
+        return evaluateBoard(board, ply);
+    }
+    
+    // A result from an earlier search may settle this position already
+    uint64_t key = board.getHashKey();
+    uint16_t hashMove = 0;
+    const TTEntry* entry = transpositionTable.probe(key);
+    stats.recordProbe(entry != nullptr);
+    if (entry) {
+        hashMove = entry->move;
+        if (entry->depth >= depth) {
+            if (entry->bound == Bound::EXACT ||
+                (entry->bound == Bound::LOWER && entry->score >= beta) ||
+                (entry->bound == Bound::UPPER && entry->score <= alpha)) {
+                stats.recordTTCutoff();
+                return entry->score;
+            }
+        }
     }
     
     Color currentPlayer = board.getGameState().currentPlayer;
@@ -143,67 +208,80 @@ int AI::minimax(Board& board, int depth, bool isMaximizing, int alpha, int beta)
     }
     
     // Order moves for better pruning
-    orderMoves(moves, board);
+    orderMoves(moves, board, hashMove);
     
-    if (isMaximizing) {
-        int maxEval = INT_MIN;
+    int originalAlpha = alpha;
+    int originalBeta = beta;
+    int bestEval = isMaximizing ? INT_MIN : INT_MAX;
+    uint16_t bestMove = 0;
+    
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const Move& move = moves[i];
+        Board testBoard = board;
+        testBoard.makeMove(move);
+        updateAccumulator(testBoard, ply + 1);
         
-        for (const Move& move : moves) {
-            Board testBoard = board;
-            testBoard.makeMove(move);
-            
-            int eval = minimax(testBoard, depth - 1, false, alpha, beta);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-            
-            if (beta <= alpha) {
-                break;  // Alpha-beta pruning
-            }
+        int eval = minimax(testBoard, depth - 1, ply + 1, !isMaximizing, alpha, beta);
+        if (stopped) {
+            return 0;
         }
         
-        return maxEval;
-    } else {
-        int minEval = INT_MAX;
-        
-        for (const Move& move : moves) {
-            Board testBoard = board;
-            testBoard.makeMove(move);
-            
-            int eval = minimax(testBoard, depth - 1, true, alpha, beta);
-            minEval = std::min(minEval, eval);
+        if (isMaximizing ? eval > bestEval : eval < bestEval) {
+            bestEval = eval;
+            bestMove = OpeningBook::encodeMove(move);
+        }
+        if (isMaximizing) {
+            alpha = std::max(alpha, eval);
+        } else {
             beta = std::min(beta, eval);
-            
-            if (beta <= alpha) {
-                break;  // Alpha-beta pruning
-            }
         }
         
-        return minEval;
+        if (beta <= alpha) {
+            stats.recordBetaCutoff(static_cast<int>(i));
+            break;  // Alpha-beta pruning
+        }
+    }
+    
+    Bound bound = Bound::EXACT;
+    if (bestEval <= originalAlpha) {
+        bound = Bound::UPPER;
+    } else if (bestEval >= originalBeta) {
+        bound = Bound::LOWER;
+    }
+    transpositionTable.store(key, bestEval, depth, bound, bestMove);
+    
+    return bestEval;
+}
+
+void AI::setNetwork(std::shared_ptr<const Nnue::Network> net) {
+    network = net;
+    if (network) {
+        accumulators.resize(MAX_SEARCH_DEPTH + 1);
+    } else {
+        accumulators.clear();
     }
 }
 
-// Evaluate the board position
-int AI::evaluateBoard(const Board& board) const {
-    int score = 0;
-    
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            const Piece& piece = board.getPiece(row, col);
-            if (!piece.isEmpty()) {
-                int pieceValue = piece.getValue();
-                int positionBonus = evaluatePiecePosition(piece.getType(), piece.getColor(), row, col);
-                
-                int totalValue = pieceValue + positionBonus;
-                
-                if (piece.getColor() == Color::WHITE) {
-                    score += totalValue;
-                } else {
-                    score -= totalValue;
-                }
-            }
-        }
+// Copy-make keeps every ply's board, so each ply has its own accumulator and
+// "unmaking" a move is just returning to the parent's
+void AI::updateAccumulator(const Board& board, int ply) {
+    if (network) {
+        network->update(accumulators[ply], accumulators[ply - 1], board);
+    }
+}
+
+// Evaluate the board position from the AI's point of view, with the
+// network if one is set
+int AI::evaluateBoard(const Board& board, int ply) {
+    PROFILE_SCOPE("AI::evaluateBoard");
+    if (network) {
+        Color sideToMove = board.getGameState().currentPlayer;
+        int score = network->evaluate(accumulators[ply], sideToMove);
+        return sideToMove == aiColor ? score : -score;
     }
     
+    int score = evaluateClassical(board);
+    
     // Adjust score based on AI color
     if (aiColor == Color::BLACK) {
         score = -score;
@@ -212,39 +290,42 @@ int AI::evaluateBoard(const Board& board) const {
     return score;
 }
 
-// Evaluate piece position bonus
-int AI::evaluatePiecePosition(PieceType piece, Color color, int row, int col) const {
-    int bonus = 0;
-    int adjustedRow = (color == Color::BLACK) ? 7 - row : row;  // Flip for black pieces
-    
-    switch (piece) {
-        case PieceType::PAWN:
-            bonus = PAWN_POSITION_BONUS[adjustedRow][col];
-            break;
-        case PieceType::KNIGHT:
-            bonus = KNIGHT_POSITION_BONUS[adjustedRow][col];
-            break;
-        case PieceType::BISHOP:
-            bonus = BISHOP_POSITION_BONUS[adjustedRow][col];
-            break;
-        case PieceType::ROOK:
-            bonus = ROOK_POSITION_BONUS[adjustedRow][col];
-            break;
-        case PieceType::QUEEN:
-            bonus = QUEEN_POSITION_BONUS[adjustedRow][col];
-            break;
-        case PieceType::KING:
-            bonus = KING_POSITION_BONUS[adjustedRow][col];
-            break;
-        default:
-            bonus = 0;
+// Hand-written evaluation, white's view. Material and piece-square sums are
+// kept up to date by the board; mobility and king safety come from attack
+// bitboards, and the pawn structure score is cached.
+int AI::evaluateClassical(const Board& board) {
+    Mobility::Score mobility = Mobility::evaluate(board);
+    int score = PieceSquareTables::taper(board.getMidgameScore() + mobility.midgame,
+                                         board.getEndgameScore() + mobility.endgame, board.getPhase());
+    return score + evaluatePawns(board);
+}
+
+int AI::staticEvaluation(const Board& board) {
+    if (network) {
+        int score = network->evaluate(board);
+        return board.getGameState().currentPlayer == Color::WHITE ? score : -score;
     }
+    return evaluateClassical(board);
+}
+
+// Pawn structure changes far less often than the rest of the position,
+// so its score is looked up by pawn key before computing it
+int AI::evaluatePawns(const Board& board) {
+    uint64_t key = board.getPawnKey();
+    int score = 0;
+    bool hit = pawnTable.probe(key, score);
+    stats.recordPawnProbe(hit);
     
-    return bonus;
+    if (!hit) {
+        score = PawnStructure::evaluate(board.getPawnBitboard(Color::WHITE), board.getPawnBitboard(Color::BLACK));
+        pawnTable.store(key, score);
+    }
+    return score;
 }
 
-// Order moves for better alpha-beta pruning (captures first)
-void AI::orderMoves(std::vector<Move>& moves, const Board& board) const {
+// Order moves for better alpha-beta pruning (hash move, then captures)
+void AI::orderMoves(std::vector<Move>& moves, const Board& board, uint16_t firstMove) const {
+    PROFILE_SCOPE("AI::orderMoves");
     std::sort(moves.begin(), moves.end(), [&board](const Move& a, const Move& b) {
         const Piece& targetA = board.getPiece(a.toRow, a.toCol);
         const Piece& targetB = board.getPiece(b.toRow, b.toCol);
@@ -260,6 +341,12 @@ void AI::orderMoves(std::vector<Move>& moves, const Board& board) const {
         
         return false;  // Equal priority
     });
+    
+    if (firstMove != 0) {
+        std::stable_partition(moves.begin(), moves.end(), [firstMove](const Move& move) {
+            return OpeningBook::encodeMove(move) == firstMove;
+        });
+    }
 }
 
 // Get random legal move (for easy difficulty)
@@ -270,8 +357,8 @@ Move AI::getRandomMove(const Board& board) const {
         return Move(0, 0, 0, 0);  // No legal moves
     }
     
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    thread_local std::random_device rd;
+    thread_local std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, legalMoves.size() - 1);
     
     return legalMoves[dis(gen)];
@@ -0,0 +1,92 @@
+#include "../include/AsyncFileWriter.h"
+#include <algorithm>
+
+AsyncFileWriter::AsyncFileWriter(size_t bufferSize)
+    : file(nullptr), bufferSize(std::max<size_t>(1, bufferSize)), bytesWritten(0), writePending(false),
+      stopping(false), failed(false) {}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    // The buffers do the buffering
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    filling.reserve(bufferSize);
+    writing.reserve(bufferSize);
+    bytesWritten = 0;
+    writePending = false;
+    stopping = false;
+    failed = false;
+    writer = std::thread(&AsyncFileWriter::writerLoop, this);
+    return true;
+}
+
+void AsyncFileWriter::write(const void* data, size_t size) {
+    if (!file) return;
+    const char* bytes = static_cast<const char*>(data);
+    bytesWritten += size;
+    while (size > 0) {
+        size_t space = bufferSize - filling.size();
+        if (space == 0) {
+            handOver();
+            continue;
+        }
+        size_t count = std::min(space, size);
+        filling.insert(filling.end(), bytes, bytes + count);
+        bytes += count;
+        size -= count;
+    }
+}
+
+void AsyncFileWriter::handOver() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return !writePending; });
+    std::swap(filling, writing);
+    filling.clear();
+    writePending = true;
+    changed.notify_all();
+}
+
+void AsyncFileWriter::flush() {
+    if (!file) return;
+    if (!filling.empty()) handOver();
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return !writePending; });
+}
+
+bool AsyncFileWriter::close() {
+    if (!file) return !failed;
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+
+    if (std::fclose(file) != 0) failed = true;
+    file = nullptr;
+    return !failed;
+}
+
+void AsyncFileWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return writePending || stopping; });
+        if (!writePending) return;  // Stopping, and everything is written
+
+        // The buffer is ours until writePending is cleared
+        lock.unlock();
+        bool written = std::fwrite(writing.data(), 1, writing.size(), file) == writing.size();
+        lock.lock();
+
+        if (!written) failed = true;
+        writePending = false;
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,94 @@
+#include "../include/Attacks.h"
+
+namespace {
+
+const uint64_t FILE_H = Attacks::FILE_A << 7;
+
+// Ray directions as (row, col) steps. The first four run towards higher
+// square numbers, so their nearest blocker is the lowest set bit.
+enum Direction { SOUTH, EAST, SOUTH_EAST, SOUTH_WEST, NORTH, WEST, NORTH_EAST, NORTH_WEST };
+const int ROW_STEP[8] = {1, 0, 1, 1, -1, 0, -1, -1};
+const int COL_STEP[8] = {0, 1, 1, -1, 0, -1, 1, -1};
+
+// Leaper attacks and empty-board rays for every square, built once
+struct AttackTable {
+    uint64_t knight[64];
+    uint64_t king[64];
+    uint64_t rays[8][64];
+
+    static uint64_t bit(int row, int col) {
+        return (row >= 0 && row < 8 && col >= 0 && col < 8) ? 1ULL << (row * 8 + col) : 0;
+    }
+
+    AttackTable() {
+        const int knightRows[8] = {-2, -2, -1, -1, 1, 1, 2, 2};
+        const int knightCols[8] = {-1, 1, -2, 2, -2, 2, -1, 1};
+        for (int square = 0; square < 64; ++square) {
+            int row = square / 8;
+            int col = square % 8;
+            knight[square] = 0;
+            king[square] = 0;
+            for (int i = 0; i < 8; ++i) {
+                knight[square] |= bit(row + knightRows[i], col + knightCols[i]);
+                king[square] |= bit(row + ROW_STEP[i], col + COL_STEP[i]);
+            }
+            for (int direction = 0; direction < 8; ++direction) {
+                rays[direction][square] = 0;
+                for (int r = row + ROW_STEP[direction], c = col + COL_STEP[direction]; bit(r, c) != 0;
+                     r += ROW_STEP[direction], c += COL_STEP[direction]) {
+                    rays[direction][square] |= bit(r, c);
+                }
+            }
+        }
+    }
+};
+
+const AttackTable& table() {
+    static const AttackTable instance;
+    return instance;
+}
+
+// Ray up to and including its first blocker
+uint64_t ray(const AttackTable& tables, int direction, int square, uint64_t occupied) {
+    uint64_t attacks = tables.rays[direction][square];
+    uint64_t blockers = attacks & occupied;
+    if (blockers) {
+        int blocker = direction < NORTH ? __builtin_ctzll(blockers) : 63 - __builtin_clzll(blockers);
+        attacks ^= tables.rays[direction][blocker];
+    }
+    return attacks;
+}
+
+} // namespace
+
+namespace Attacks {
+
+uint64_t knight(int square) {
+    return table().knight[square];
+}
+
+uint64_t king(int square) {
+    return table().king[square];
+}
+
+// White pawns attack towards row 0, black pawns towards row 7
+uint64_t pawns(uint64_t pawns, Color color) {
+    if (color == Color::WHITE) {
+        return ((pawns >> 7) & ~FILE_A) | ((pawns >> 9) & ~FILE_H);
+    }
+    return ((pawns << 9) & ~FILE_A) | ((pawns << 7) & ~FILE_H);
+}
+
+uint64_t bishop(int square, uint64_t occupied) {
+    const AttackTable& tables = table();
+    return ray(tables, SOUTH_EAST, square, occupied) | ray(tables, SOUTH_WEST, square, occupied) |
+           ray(tables, NORTH_EAST, square, occupied) | ray(tables, NORTH_WEST, square, occupied);
+}
+
+uint64_t rook(int square, uint64_t occupied) {
+    const AttackTable& tables = table();
+    return ray(tables, SOUTH, square, occupied) | ray(tables, EAST, square, occupied) |
+           ray(tables, NORTH, square, occupied) | ray(tables, WEST, square, occupied);
+}
+
+} // namespace Attacks
@@ -0,0 +1,143 @@
+#include "../include/Batch.h"
+#include "../include/Notation.h"
+#include "../include/Utils.h"
+#include <cctype>
+#include <chrono>
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view trimView(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// Next whitespace-separated token, consumed from text
+std::string_view nextToken(std::string_view& text) {
+    size_t start = 0;
+    while (start < text.size() && isSpace(text[start])) ++start;
+    size_t end = start;
+    while (end < text.size() && !isSpace(text[end])) ++end;
+    std::string_view token = text.substr(start, end - start);
+    text.remove_prefix(end);
+    return token;
+}
+
+bool isSquare(std::string_view text, size_t at) {
+    return at + 1 < text.size() && text[at] >= 'a' && text[at] <= 'h' && text[at + 1] >= '1' && text[at + 1] <= '8';
+}
+
+// "e2e4", "e2-e4", "e7e8q", "e7e8=Q"
+bool parseCoordinates(std::string_view token, Move& move) {
+    if (!isSquare(token, 0)) return false;
+    size_t to = (token.size() > 2 && token[2] == '-') ? 3 : 2;
+    if (!isSquare(token, to)) return false;
+
+    size_t rest = to + 2;
+    PieceType promotion = PieceType::EMPTY;
+    if (rest < token.size() && token[rest] == '=') ++rest;
+    if (rest < token.size()) {
+        promotion = Notation::pieceFromLetter(static_cast<char>(std::toupper(static_cast<unsigned char>(token[rest]))));
+        if (promotion == PieceType::EMPTY || promotion == PieceType::KING) return false;
+        ++rest;
+    }
+    if (rest != token.size()) return false;
+
+    move = Move(ChessUtils::rankToRow(token[1]), ChessUtils::fileToCol(token[0]),
+                ChessUtils::rankToRow(token[to + 1]), ChessUtils::fileToCol(token[to]));
+    move.promotionPiece = promotion;
+    return true;
+}
+
+bool isResultMarker(std::string_view token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+// "12." or "12..." alone, or glued to the move as in "12.e4"; castling
+// written with zeros also starts with a digit but has no dot
+std::string_view skipMoveNumber(std::string_view token) {
+    size_t digits = 0;
+    while (digits < token.size() && std::isdigit(static_cast<unsigned char>(token[digits]))) ++digits;
+    if (digits == 0 || digits == token.size() || token[digits] != '.') return token;
+    while (digits < token.size() && token[digits] == '.') ++digits;
+    return token.substr(digits);
+}
+
+} // namespace
+
+namespace Batch {
+
+bool playMoves(Board& board, std::string_view moves, uint64_t& played, std::string& error) {
+    played = 0;
+    while (true) {
+        std::string_view token = nextToken(moves);
+        if (token.empty()) return true;
+        if (isResultMarker(token)) continue;
+        token = skipMoveNumber(token);
+        if (token.empty()) continue;
+
+        std::string_view plain = token;
+        while (!plain.empty() && (plain.back() == '+' || plain.back() == '#')) plain.remove_suffix(1);
+
+        Move move(0, 0, 0, 0);
+        bool parsed = parseCoordinates(plain, move) || Notation::fromSAN(board, token, move);
+        if (!parsed || !board.makeMove(move)) {
+            error = (parsed ? "illegal move '" : "illegal or unreadable move '") + std::string(token) + "' after " +
+                    std::to_string(played) + " moves";
+            return false;
+        }
+        ++played;
+    }
+}
+
+std::string result(const Board& board) {
+    Color toMove = board.getGameState().currentPlayer;
+    if (board.isCheckmate(toMove)) return toMove == Color::WHITE ? "0-1" : "1-0";
+    if (board.isStalemate(toMove) || board.isDraw()) return "1/2-1/2";
+    return "*";
+}
+
+Summary run(std::istream& input, std::ostream& output, std::ostream& errors) {
+    Summary summary;
+    auto start = std::chrono::steady_clock::now();
+
+    Board board;
+    std::string line;
+    std::string error;
+    while (std::getline(input, line)) {
+        std::string_view text = trimView(line);
+        if (text.empty() || text[0] == '#' || text[0] == '[') continue;
+        ++summary.games;
+
+        std::string_view moves = text;
+        if (text.substr(0, 4) == "fen ") {
+            size_t split = text.find(" moves");
+            std::string fen(trimView(text.substr(4, split == std::string_view::npos ? split : split - 4)));
+            if (!board.loadFEN(fen)) {
+                errors << "Game " << summary.games << ": bad FEN '" << fen << "'\n";
+                ++summary.failed;
+                continue;
+            }
+            moves = split == std::string_view::npos ? std::string_view() : text.substr(split + 6);
+        } else {
+            board.resetToStartingPosition();
+        }
+
+        uint64_t played = 0;
+        if (!playMoves(board, moves, played, error)) {
+            errors << "Game " << summary.games << ": " << error << '\n';
+            ++summary.failed;
+        }
+        summary.moves += played;
+        output << result(board) << ' ' << board.toFEN() << '\n';
+    }
+
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return summary;
+}
+
+} // namespace Batch
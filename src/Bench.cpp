@@ -0,0 +1,170 @@
+#include "../include/Bench.h"
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/Notation.h"
+#include <chrono>
+#include <iomanip>
+
+namespace Bench {
+
+namespace {
+
+// Changing this list changes the signature
+const std::vector<std::string> POSITIONS = {
+    // Openings
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+    "rnbqkb1r/pppppppp/5n2/8/2PP4/8/PP2PPPP/RNBQKBNR b KQkq c3 0 2",
+    "r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "rnbqk2r/ppp1bppp/4pn2/3p2B1/2PP4/2N5/PP2PPPP/R2QKBNR w KQkq - 4 5",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "rnbqkb1r/pp3ppp/4pn2/2pp4/3P4/2PBPN2/PP3PPP/RNBQK2R b KQkq - 1 5",
+    "rnbqk2r/ppppppbp/5np1/8/2PP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 2 4",
+    "rnbqkbnr/pp2pppp/2p5/3p4/3PP3/8/PPP2PPP/RNBQKBNR w KQkq d6 0 3",
+    // Middlegames
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/ppp2ppp/2np1n2/2b1p3/2B1P3/2NP1N2/PPP2PPP/R1BQ1RK1 w - - 0 7",
+    "r2q1rk1/pb1nbppp/1p2pn2/2pp4/3P4/1P2PNP1/PBPNQPBP/R4RK1 w - - 2 10",
+    "2rq1rk1/pp1bppbp/3p1np1/4n3/3NP3/1BN1BP2/PPPQ2PP/2KR3R w - - 7 12",
+    "r1bqk2r/pp2bppp/2n1pn2/2pp4/3P4/2PBPN2/PP1N1PPP/R1BQK2R w KQkq - 2 7",
+    "r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1",
+    "2r3k1/pp1b1ppp/4pn2/q2p4/3P4/P1PBP3/2Q2PPP/R3K2R w KQ - 0 17",
+    "r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w - - 0 14",
+    "3r1rk1/p1q2pp1/1pnbp2p/2p5/2P1N3/1P3NP1/PB2QP1P/3RR1K1 w - - 0 19",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4R1K b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/2qnbppp/p1b1p3/1p2P3/5P2/P1NB4/1PPQ2PP/2KR3R w - - 0 17",
+    "r1b1kb1r/1p1n1ppp/p2ppn2/6BB/2qNP3/2N5/PPP2PPP/R2Q1RK1 w kq - 2 11",
+    // Checks and sharp positions
+    "rnbqk1nr/pppp1ppp/8/4p3/1b1PP3/8/PPP2PPP/RNBQKBNR w KQkq - 1 3",
+    "rnbqkbnr/ppppp2p/5p2/6p1/4P3/8/PPPP1PPP/RNBQKBNR w KQkq g6 0 3",
+    "r1b1k2r/ppppnppp/2n2q2/2b5/3NP3/2P1B3/PP3PPP/RN1QKB1R w KQkq - 0 7",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "5rk1/1ppb3p/p1pb4/6q1/3P1p1r/2P1R2P/PP1BQ1P1/5RKN w - - 0 1",
+    // Endgames
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/8/4k3/8/8/4P3/4K3 w - - 0 1",
+    "8/8/1p1k4/1P6/2K5/8/8/8 w - - 0 1",
+    "8/5pk1/6p1/8/8/6P1/5PK1/8 w - - 0 1",
+    "4k3/8/8/8/8/8/8/R3K3 w Q - 0 1",
+    "8/8/4k3/8/2R5/8/4K3/3r4 w - - 0 1",
+    "8/3k4/8/2B5/8/8/5N2/3K4 w - - 0 1",
+    "6k1/5p2/6p1/8/8/1q6/5PPP/3Q2K1 w - - 0 1",
+    "8/p4pk1/1p4p1/8/8/1P4P1/P4PK1/8 w - - 0 1",
+    "8/8/3k4/3p4/3P4/3K4/8/8 w - - 0 1",
+    "2k5/8/8/8/8/8/5r2/3R2K1 b - - 0 1",
+    "8/8/8/5k2/8/3B4/4K1p1/8 w - - 0 1",
+    "R7/P4k2/8/8/8/8/6K1/r7 w - - 0 1",
+    // Promotions
+    "8/P7/8/8/8/8/6k1/4K3 w - - 0 1",
+    "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+};
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+const std::vector<std::string>& positions() {
+    return POSITIONS;
+}
+
+Result run(int depth, std::ostream* progress, PerfCounters* counters) {
+    Result result;
+    result.depth = depth;
+
+    for (size_t i = 0; i < POSITIONS.size(); ++i) {
+        PositionResult position;
+        position.fen = POSITIONS[i];
+
+        Board board;
+        board.loadFEN(position.fen);
+        AI ai(AILevel::HARD, board.getGameState().currentPlayer);
+        ai.setSearchDepth(depth);
+
+        if (counters) counters->start();
+        auto start = std::chrono::steady_clock::now();
+        Move move = ai.getBestMove(board);
+        position.milliseconds = millisecondsSince(start);
+        if (counters) result.counters += counters->stop();
+        position.nodes = ai.getLastSearchStats().nodes;
+        position.bestMove = Notation::toSAN(board, move);
+
+        result.nodes += position.nodes;
+        result.milliseconds += position.milliseconds;
+        if (progress) {
+            *progress << "Position " << std::setw(2) << i + 1 << "/" << POSITIONS.size() << "  "
+                      << std::left << std::setw(8) << position.bestMove << std::right << std::setw(10)
+                      << position.nodes << " nodes" << std::endl;
+        }
+        result.positions.push_back(position);
+    }
+    return result;
+}
+
+void printReport(const Result& result, std::ostream& out) {
+    out << "===========================\n"
+        << std::fixed << std::setprecision(0)
+        << "Depth          : " << result.depth << "\n"
+        << "Positions      : " << result.positions.size() << "\n"
+        << "Total time (ms): " << result.milliseconds << "\n"
+        << "Nodes searched : " << result.nodes << "\n"
+        << "Nodes/second   : " << result.nodesPerSecond() << std::endl;
+
+    if (!result.counters.any() || result.nodes == 0) return;
+    out << std::setprecision(2);
+    for (int i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+        if (!result.counters.valid[i]) continue;
+        std::string label = std::string(PerfCounters::name(static_cast<PerfCounters::Event>(i))) + "/node";
+        out << std::left << std::setw(15) << label << std::right << ": " << result.counters.values[i] / result.nodes
+            << "\n";
+    }
+    const double* values = result.counters.values;
+    if (result.counters.valid[PerfCounters::CYCLES] && result.counters.valid[PerfCounters::INSTRUCTIONS] &&
+        values[PerfCounters::CYCLES] > 0) {
+        out << "Instructions/cycle: " << values[PerfCounters::INSTRUCTIONS] / values[PerfCounters::CYCLES] << "\n";
+    }
+    out.flush();
+}
+
+// FENs and SAN need no escaping
+void writeJson(const Result& result, std::ostream& out) {
+    out << std::fixed << std::setprecision(3)
+        << "{\n"
+        << "  \"depth\": " << result.depth << ",\n"
+        << "  \"nodes\": " << result.nodes << ",\n"
+        << "  \"milliseconds\": " << result.milliseconds << ",\n"
+        << "  \"nps\": " << std::setprecision(0) << result.nodesPerSecond() << ",\n";
+    if (result.counters.any()) {
+        // Totals over all searches; divide by nodes for the cost per node
+        out << "  \"counters\": {";
+        bool first = true;
+        for (int i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+            if (!result.counters.valid[i]) continue;
+            out << (first ? "" : ", ") << "\"" << PerfCounters::name(static_cast<PerfCounters::Event>(i))
+                << "\": " << result.counters.values[i];
+            first = false;
+        }
+        out << "},\n";
+    }
+    out << "  \"positions\": [\n";
+    for (size_t i = 0; i < result.positions.size(); ++i) {
+        const PositionResult& position = result.positions[i];
+        out << "    {\"fen\": \"" << position.fen << "\", \"bestMove\": \"" << position.bestMove
+            << "\", \"nodes\": " << position.nodes << ", \"milliseconds\": " << std::setprecision(3)
+            << position.milliseconds << "}" << (i + 1 < result.positions.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n"
+        << "}" << std::endl;
+}
+
+} // namespace Bench
@@ -1,11 +1,20 @@
 #include "../include/Board.h"
+#include "../include/BoardRenderer.h"
+#include "../include/PieceSquareTables.h"
+#include "../include/Profiler.h"
 #include "../include/Utils.h"
+#include "../include/Zobrist.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <cctype>
 
 // Constructor - initialize board to starting position
-Board::Board() {
+Board::Board()
+    : pieceKey(0), pawnKey(0), pieceBitboards{}, colorBitboards{0, 0}, midgameScore(0), endgameScore(0), phase(0),
+      changeCount(0) {
     // Initialize 8x8 board with empty pieces
     board.resize(8, std::vector<Piece>(8, Piece()));
     resetToStartingPosition();
@@ -16,38 +25,38 @@ void Board::resetToStartingPosition() {
     // Clear board
     for (int row = 0; row < 8; ++row) {
         for (int col = 0; col < 8; ++col) {
-            board[row][col] = Piece();
+            placePiece(row, col, Piece());
         }
     }
     
     // Place white pieces (bottom of board, rows 6-7)
-    board[7][0] = Piece(PieceType::ROOK, Color::WHITE);
-    board[7][1] = Piece(PieceType::KNIGHT, Color::WHITE);
-    board[7][2] = Piece(PieceType::BISHOP, Color::WHITE);
-    board[7][3] = Piece(PieceType::QUEEN, Color::WHITE);
-    board[7][4] = Piece(PieceType::KING, Color::WHITE);
-    board[7][5] = Piece(PieceType::BISHOP, Color::WHITE);
-    board[7][6] = Piece(PieceType::KNIGHT, Color::WHITE);
-    board[7][7] = Piece(PieceType::ROOK, Color::WHITE);
+    placePiece(7, 0, Piece(PieceType::ROOK, Color::WHITE));
+    placePiece(7, 1, Piece(PieceType::KNIGHT, Color::WHITE));
+    placePiece(7, 2, Piece(PieceType::BISHOP, Color::WHITE));
+    placePiece(7, 3, Piece(PieceType::QUEEN, Color::WHITE));
+    placePiece(7, 4, Piece(PieceType::KING, Color::WHITE));
+    placePiece(7, 5, Piece(PieceType::BISHOP, Color::WHITE));
+    placePiece(7, 6, Piece(PieceType::KNIGHT, Color::WHITE));
+    placePiece(7, 7, Piece(PieceType::ROOK, Color::WHITE));
     
     // White pawns
     for (int col = 0; col < 8; ++col) {
-        board[6][col] = Piece(PieceType::PAWN, Color::WHITE);
+        placePiece(6, col, Piece(PieceType::PAWN, Color::WHITE));
     }
     
     // Place black pieces (top of board, rows 0-1)
-    board[0][0] = Piece(PieceType::ROOK, Color::BLACK);
-    board[0][1] = Piece(PieceType::KNIGHT, Color::BLACK);
-    board[0][2] = Piece(PieceType::BISHOP, Color::BLACK);
-    board[0][3] = Piece(PieceType::QUEEN, Color::BLACK);
-    board[0][4] = Piece(PieceType::KING, Color::BLACK);
-    board[0][5] = Piece(PieceType::BISHOP, Color::BLACK);
-    board[0][6] = Piece(PieceType::KNIGHT, Color::BLACK);
-    board[0][7] = Piece(PieceType::ROOK, Color::BLACK);
+    placePiece(0, 0, Piece(PieceType::ROOK, Color::BLACK));
+    placePiece(0, 1, Piece(PieceType::KNIGHT, Color::BLACK));
+    placePiece(0, 2, Piece(PieceType::BISHOP, Color::BLACK));
+    placePiece(0, 3, Piece(PieceType::QUEEN, Color::BLACK));
+    placePiece(0, 4, Piece(PieceType::KING, Color::BLACK));
+    placePiece(0, 5, Piece(PieceType::BISHOP, Color::BLACK));
+    placePiece(0, 6, Piece(PieceType::KNIGHT, Color::BLACK));
+    placePiece(0, 7, Piece(PieceType::ROOK, Color::BLACK));
     
     // Black pawns
     for (int col = 0; col < 8; ++col) {
-        board[1][col] = Piece(PieceType::PAWN, Color::BLACK);
+        placePiece(1, col, Piece(PieceType::PAWN, Color::BLACK));
     }
     
     // Reset game state
@@ -65,15 +74,81 @@ const Piece& Board::getPiece(int row, int col) const {
 
 void Board::setPiece(int row, int col, const Piece& piece) {
     if (isOnBoard(row, col)) {
-        board[row][col] = piece;
+        placePiece(row, col, piece);
     }
 }
 
+// Every change to a square goes through here, so the incremental keys,
+// pawn bitboards and evaluation sums always match the board
+void Board::placePiece(int row, int col, const Piece& piece) {
+    int square = Zobrist::squareIndex(row, col);
+    
+    const Piece& old = board[row][col];
+    if (!old.isEmpty()) {
+        int sign = old.getColor() == Color::WHITE ? 1 : -1;
+        midgameScore -= sign * PieceSquareTables::midgame(old.getType(), old.getColor(), square);
+        endgameScore -= sign * PieceSquareTables::endgame(old.getType(), old.getColor(), square);
+        phase -= PieceSquareTables::phaseWeight(old.getType());
+        
+        uint64_t key = Zobrist::pieceKey(old.getType(), old.getColor(), square);
+        pieceKey ^= key;
+        if (old.getType() == PieceType::PAWN) {
+            pawnKey ^= key;
+        }
+        int side = old.getColor() == Color::WHITE ? 0 : 1;
+        pieceBitboards[side][static_cast<int>(old.getType())] &= ~(1ULL << square);
+        colorBitboards[side] &= ~(1ULL << square);
+    }
+    
+    if (!piece.isEmpty()) {
+        int sign = piece.getColor() == Color::WHITE ? 1 : -1;
+        midgameScore += sign * PieceSquareTables::midgame(piece.getType(), piece.getColor(), square);
+        endgameScore += sign * PieceSquareTables::endgame(piece.getType(), piece.getColor(), square);
+        phase += PieceSquareTables::phaseWeight(piece.getType());
+        
+        uint64_t key = Zobrist::pieceKey(piece.getType(), piece.getColor(), square);
+        pieceKey ^= key;
+        if (piece.getType() == PieceType::PAWN) {
+            pawnKey ^= key;
+        }
+        int side = piece.getColor() == Color::WHITE ? 0 : 1;
+        pieceBitboards[side][static_cast<int>(piece.getType())] |= 1ULL << square;
+        colorBitboards[side] |= 1ULL << square;
+    }
+    
+    if (changeCount < MAX_CHANGES) {
+        changes[changeCount] = SquareChange{square, old, piece};
+    }
+    if (changeCount <= MAX_CHANGES) {
+        ++changeCount;
+    }
+    
+    board[row][col] = piece;
+}
+
+// Move a piece, leaving its square empty
+void Board::movePiece(int fromRow, int fromCol, int toRow, int toCol) {
+    Piece piece = board[fromRow][fromCol];
+    placePiece(fromRow, fromCol, Piece());
+    placePiece(toRow, toCol, piece);
+}
+
 // Check if coordinates are on the board
 bool Board::isOnBoard(int row, int col) const {
     return row >= 0 && row < 8 && col >= 0 && col < 8;
 }
 
+// Count the pieces on the board
+int Board::countPieces() const {
+    int count = 0;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            if (!board[row][col].isEmpty()) ++count;
+        }
+    }
+    return count;
+}
+
 // Check if path is clear for sliding pieces (rook, bishop, queen)
 bool Board::isPathClear(int fromRow, int fromCol, int toRow, int toCol) const {
     int deltaRow = toRow - fromRow;
@@ -124,16 +199,61 @@ bool Board::isInCheck(Color color) const {
     
     // Check if any enemy piece can attack the king
     Color enemyColor = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    return isSquareAttacked(kingRow, kingCol, enemyColor);
+}
+
+// Check if any piece of the given color attacks a square.
+// Unlike isValidMove this does not care whose turn it is, so it works for
+// the side to move as well as for the opponent.
+bool Board::isSquareAttacked(int row, int col, Color byColor) const {
+    // Pawns attack diagonally forward, so look one row "behind" the square
+    int pawnRow = (byColor == Color::WHITE) ? row + 1 : row - 1;
+    for (int deltaCol : {-1, 1}) {
+        const Piece& piece = getPiece(pawnRow, col + deltaCol);
+        if (piece.getType() == PieceType::PAWN && piece.getColor() == byColor) {
+            return true;
+        }
+    }
     
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            const Piece& piece = board[row][col];
-            if (piece.getColor() == enemyColor && !piece.isEmpty()) {
-                Move attackMove(row, col, kingRow, kingCol);
-                if (isValidMove(attackMove)) {
-                    return true;
+    // Knights and kings jump, so only the target square matters
+    static const int knightOffsets[8][2] = {
+        {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}
+    };
+    static const int kingOffsets[8][2] = {
+        {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}
+    };
+    for (const auto& offset : knightOffsets) {
+        const Piece& piece = getPiece(row + offset[0], col + offset[1]);
+        if (piece.getType() == PieceType::KNIGHT && piece.getColor() == byColor) {
+            return true;
+        }
+    }
+    for (const auto& offset : kingOffsets) {
+        const Piece& piece = getPiece(row + offset[0], col + offset[1]);
+        if (piece.getType() == PieceType::KING && piece.getColor() == byColor) {
+            return true;
+        }
+    }
+    
+    // Sliding pieces - walk each ray until the first piece
+    for (const auto& offset : kingOffsets) {
+        bool diagonal = offset[0] != 0 && offset[1] != 0;
+        int currentRow = row + offset[0];
+        int currentCol = col + offset[1];
+        
+        while (isOnBoard(currentRow, currentCol)) {
+            const Piece& piece = board[currentRow][currentCol];
+            if (!piece.isEmpty()) {
+                if (piece.getColor() == byColor) {
+                    PieceType type = piece.getType();
+                    if (type == PieceType::QUEEN) return true;
+                    if (diagonal && type == PieceType::BISHOP) return true;
+                    if (!diagonal && type == PieceType::ROOK) return true;
                 }
+                break;  // Ray is blocked
             }
+            currentRow += offset[0];
+            currentCol += offset[1];
         }
     }
     
@@ -160,6 +280,12 @@ bool Board::isValidMove(const Move& move) const {
         return false;
     }
     
+    // Castling is the only two-square king move and has its own rules
+    if (fromPiece.getType() == PieceType::KING && move.fromRow == move.toRow &&
+        std::abs(move.toCol - move.fromCol) == 2) {
+        return isValidCastling(move);
+    }
+    
     // Check basic piece movement rules
     if (!fromPiece.canMoveTo(move.fromRow, move.fromCol, move.toRow, move.toCol)) {
         return false;
@@ -182,6 +308,12 @@ bool Board::isValidMove(const Move& move) const {
         if (deltaCol == 0 && !toPiece.isEmpty()) {
             return false;
         }
+
+        // A double step can't jump over a piece
+        if (deltaCol == 0 && std::abs(move.toRow - move.fromRow) == 2 &&
+            !board[(move.fromRow + move.toRow) / 2][move.fromCol].isEmpty()) {
+            return false;
+        }
         
         // Diagonal move - must be capturing or en passant
         if (deltaCol != 0) {
@@ -202,14 +334,54 @@ bool Board::isValidMove(const Move& move) const {
     return true;
 }
 
+// Validate castling: rights, empty squares between king and rook, and the king
+// may not castle out of, through or into check
+bool Board::isValidCastling(const Move& move) const {
+    const Piece& king = board[move.fromRow][move.fromCol];
+    Color color = king.getColor();
+    int homeRow = (color == Color::WHITE) ? 7 : 0;
+    
+    if (move.fromRow != homeRow || move.fromCol != 4) return false;
+    
+    bool kingside = move.toCol > move.fromCol;
+    bool hasRight;
+    if (color == Color::WHITE) {
+        hasRight = kingside ? gameState.whiteCanCastleKingside : gameState.whiteCanCastleQueenside;
+    } else {
+        hasRight = kingside ? gameState.blackCanCastleKingside : gameState.blackCanCastleQueenside;
+    }
+    if (!hasRight) return false;
+    
+    int rookCol = kingside ? 7 : 0;
+    const Piece& rook = board[homeRow][rookCol];
+    if (rook.getType() != PieceType::ROOK || rook.getColor() != color) return false;
+    
+    if (!isPathClear(homeRow, move.fromCol, homeRow, rookCol)) return false;
+    
+    Color enemyColor = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    int step = kingside ? 1 : -1;
+    for (int col = move.fromCol; col != move.toCol + step; col += step) {
+        if (isSquareAttacked(homeRow, col, enemyColor)) return false;
+    }
+    
+    return true;
+}
+
 // Check if making a move would leave the king in check
 bool Board::wouldBeInCheck(Color color, const Move& move) const {
+    PROFILE_SCOPE("Board::wouldBeInCheck");
     // Make a copy of the board to test the move
     Board testBoard = *this;
     
+    // En passant also removes the pawn beside the destination square
+    const Piece& movingPiece = board[move.fromRow][move.fromCol];
+    if (movingPiece.getType() == PieceType::PAWN && move.fromCol != move.toCol &&
+        board[move.toRow][move.toCol].isEmpty()) {
+        testBoard.placePiece(move.fromRow, move.toCol, Piece());
+    }
+    
     // Make the move on the test board
-    testBoard.board[move.toRow][move.toCol] = testBoard.board[move.fromRow][move.fromCol];
-    testBoard.board[move.fromRow][move.fromCol] = Piece();
+    testBoard.movePiece(move.fromRow, move.fromCol, move.toRow, move.toCol);
     
     // Check if king is in check after the move
     return testBoard.isInCheck(color);
@@ -227,115 +399,44 @@ std::string Board::getSquareName(int row, int col) const {
 
 // Display the board
 void Board::display() const {
-    using namespace ChessUtils;
-    
-    // Calculate centering offset (assuming terminal width of 80 characters)
-    const int boardWidth = 37;  // Adjusted for simpler layout
-    const int terminalWidth = 80;
-    const int centerOffset = (terminalWidth - boardWidth) / 2;
-    std::string indent(centerOffset, ' ');
-    
-    std::cout << "\n";
-    
-    // Top border with file labels
-    std::cout << indent << "   ";
-    for (char file = 'a'; file <= 'h'; ++file) {
-        std::cout << " " << file << "  ";
-    }
-    std::cout << "\n";
-    
-    std::cout << indent << "  ┌";
-    for (int i = 0; i < 8; ++i) {
-        std::cout << "───";
-        if (i < 7) std::cout << "┬";
-    }
-    std::cout << "┐\n";
-    
-    for (int row = 0; row < 8; ++row) {
-        // Rank number on the left
-        std::cout << indent << ChessUtils::rowToRank(row) << " │";
-        
-        for (int col = 0; col < 8; ++col) {
-            // Alternate square colors
-            bool isLightSquare = (row + col) % 2 == 0;
-            
-            // Set square background color
-            if (isLightSquare) {
-                std::cout << "\033[47m\033[30m";  // White background, black text
-            } else {
-                std::cout << "\033[46m\033[30m";  // Cyan background, black text
-            }
-            
-            // Print piece with padding
-            std::cout << " " << board[row][col].getSymbol() << " ";
-            
-            // Reset colors before border
-            std::cout << "\033[0m";
-            
-            std::cout << "│";
-        }
-        
-        // Rank number on the right
-        std::cout << " " << ChessUtils::rowToRank(row) << "\n";
-        
-        // Middle borders (except after last row)
-        if (row < 7) {
-            std::cout << indent << "  ├";
-            for (int i = 0; i < 8; ++i) {
-                std::cout << "───";
-                if (i < 7) std::cout << "┼";
-            }
-            std::cout << "┤\n";
-        }
-    }
-    
-    // Bottom border
-    std::cout << indent << "  └";
-    for (int i = 0; i < 8; ++i) {
-        std::cout << "───";
-        if (i < 7) std::cout << "┴";
-    }
-    std::cout << "┘\n";
-    
-    // Bottom file labels
-    std::cout << indent << "   ";
-    for (char file = 'a'; file <= 'h'; ++file) {
-        std::cout << " " << file << "  ";
-    }
-    std::cout << "\n\n";
-    
-    // Display current player (centered)
-    std::string playerText = "Current player: ";
-    playerText += (gameState.currentPlayer == Color::WHITE ? "White" : "Black");
-    int playerOffset = (terminalWidth - playerText.length()) / 2;
-    std::cout << std::string(playerOffset, ' ') << playerText << std::endl;
+    BoardRenderer renderer;
+    renderer.drawBoard(*this);
+    renderer.flush();
 }
 
 // Make a move on the board
 bool Board::makeMove(const Move& move) {
+    PROFILE_SCOPE("Board::makeMove");
     if (!isValidMove(move)) return false;
     
-    const Piece& movingPiece = board[move.fromRow][move.fromCol];
-    const Piece& capturedPiece = board[move.toRow][move.toCol];
+    changeCount = 0;
+    
+    // Copies, not references - the squares are overwritten below
+    const Piece movingPiece = board[move.fromRow][move.fromCol];
+    const Piece capturedPiece = board[move.toRow][move.toCol];
     
     // Handle en passant capture
     if (movingPiece.getType() == PieceType::PAWN && 
         move.fromCol != move.toCol && capturedPiece.isEmpty()) {
         // En passant capture - remove the captured pawn
         int capturedPawnRow = (movingPiece.getColor() == Color::WHITE) ? move.toRow + 1 : move.toRow - 1;
-        board[capturedPawnRow][move.toCol] = Piece();
+        placePiece(capturedPawnRow, move.toCol, Piece());
     }
     
     // Make the move
-    board[move.toRow][move.toCol] = board[move.fromRow][move.fromCol];
-    board[move.fromRow][move.fromCol] = Piece();
+    movePiece(move.fromRow, move.fromCol, move.toRow, move.toCol);
     
     // Handle pawn promotion
     if (movingPiece.getType() == PieceType::PAWN) {
         if ((movingPiece.getColor() == Color::WHITE && move.toRow == 0) ||
             (movingPiece.getColor() == Color::BLACK && move.toRow == 7)) {
-            // Promote to queen by default (can be extended for user choice)
-            board[move.toRow][move.toCol] = Piece(PieceType::QUEEN, movingPiece.getColor());
+            // Promote to the requested piece, queen by default
+            PieceType promotion = move.promotionPiece;
+            if (promotion != PieceType::ROOK && promotion != PieceType::BISHOP &&
+                promotion != PieceType::KNIGHT) {
+                promotion = PieceType::QUEEN;
+            }
+            placePiece(move.toRow, move.toCol, Piece(promotion, movingPiece.getColor()));
         }
     }
     
@@ -343,11 +444,9 @@ bool Board::makeMove(const Move& move) {
     if (movingPiece.getType() == PieceType::KING && abs(move.toCol - move.fromCol) == 2) {
         // Castling - move the rook too
         if (move.toCol > move.fromCol) {  // Kingside castling
-            board[move.toRow][5] = board[move.toRow][7];  // Move rook to f-file
-            board[move.toRow][7] = Piece();  // Clear rook's original position
+            movePiece(move.toRow, 7, move.toRow, 5);  // Move rook to f-file
         } else {  // Queenside castling
-            board[move.toRow][3] = board[move.toRow][0];  // Move rook to d-file
-            board[move.toRow][0] = Piece();  // Clear rook's original position
+            movePiece(move.toRow, 0, move.toRow, 3);  // Move rook to d-file
         }
     }
     
@@ -383,6 +482,14 @@ void Board::updateGameState(const Move& move, const Piece& movingPiece, const Pi
         }
     }
     
+    // Capturing a rook on its starting square also removes that castling right
+    if (capturedPiece.getType() == PieceType::ROOK) {
+        if (move.toRow == 7 && move.toCol == 0) gameState.whiteCanCastleQueenside = false;
+        if (move.toRow == 7 && move.toCol == 7) gameState.whiteCanCastleKingside = false;
+        if (move.toRow == 0 && move.toCol == 0) gameState.blackCanCastleQueenside = false;
+        if (move.toRow == 0 && move.toCol == 7) gameState.blackCanCastleKingside = false;
+    }
+    
     // Update en passant
     gameState.enPassantCol = -1;  // Reset en passant
     if (movingPiece.getType() == PieceType::PAWN && abs(move.toRow - move.fromRow) == 2) {
@@ -403,6 +510,7 @@ void Board::updateGameState(const Move& move, const Piece& movingPiece, const Pi
 
 // Get all legal moves for a color
 std::vector<Move> Board::getAllLegalMoves(Color color) const {
+    PROFILE_SCOPE("Board::getAllLegalMoves");
     std::vector<Move> legalMoves;
     
     for (int row = 0; row < 8; ++row) {
@@ -458,10 +566,37 @@ bool Board::isStalemate(Color color) const {
 
 // Check for draw conditions
 bool Board::isDraw() const {
-    // 50-move rule
-    if (gameState.halfMoveClock >= 50) return true;
+    // 50-move rule (50 moves by each side)
+    if (gameState.halfMoveClock >= 100) return true;
+    
+    // Insufficient material: bare kings, a single minor piece, or bishops
+    // that all stand on the same square color
+    int minorPieces = 0;
+    int knights = 0;
+    int bishopSquareColors = 0;  // Bit 0 = light squares, bit 1 = dark squares
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            switch (board[row][col].getType()) {
+                case PieceType::PAWN:
+                case PieceType::ROOK:
+                case PieceType::QUEEN:
+                    return false;
+                case PieceType::KNIGHT:
+                    ++minorPieces;
+                    ++knights;
+                    break;
+                case PieceType::BISHOP:
+                    ++minorPieces;
+                    bishopSquareColors |= ((row + col) % 2 == 0) ? 1 : 2;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (minorPieces <= 1) return true;
+    if (knights == 0 && bishopSquareColors != 3) return true;
     
-    // TODO: Add insufficient material check
     // TODO: Add threefold repetition check
     
     return false;
@@ -486,3 +621,139 @@ int Board::evaluatePosition() const {
     
     return score;
 }
+
+
+// Compute the Zobrist key of the current position
+uint64_t Board::getHashKey() const {
+    uint64_t key = pieceKey;  // Kept up to date by placePiece
+    
+    if (gameState.currentPlayer == Color::BLACK) key ^= Zobrist::sideKey();
+    if (gameState.whiteCanCastleKingside) key ^= Zobrist::castlingKey(0);
+    if (gameState.whiteCanCastleQueenside) key ^= Zobrist::castlingKey(1);
+    if (gameState.blackCanCastleKingside) key ^= Zobrist::castlingKey(2);
+    if (gameState.blackCanCastleQueenside) key ^= Zobrist::castlingKey(3);
+    if (gameState.enPassantCol != -1) key ^= Zobrist::enPassantKey(gameState.enPassantCol);
+    
+    return key;
+}
+
+// Set up a position from a FEN string
+bool Board::loadFEN(const std::string& fen) {
+    std::istringstream fields(fen);
+    std::string placement, side, castling, enPassant;
+    if (!(fields >> placement >> side >> castling >> enPassant)) return false;
+    
+    Board result;
+    result.gameState = GameState();
+    
+    // Piece placement, rank 8 first
+    int row = 0;
+    int col = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (col != 8 || row == 7) return false;
+            ++row;
+            col = 0;
+        } else if (c >= '1' && c <= '8') {
+            for (int i = 0; i < c - '0'; ++i) {
+                if (col > 7) return false;
+                result.placePiece(row, col++, Piece());
+            }
+        } else {
+            static const std::string letters = "PRNBQK";
+            static const PieceType types[] = {
+                PieceType::PAWN, PieceType::ROOK, PieceType::KNIGHT,
+                PieceType::BISHOP, PieceType::QUEEN, PieceType::KING
+            };
+            size_t index = letters.find(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+            if (index == std::string::npos || col > 7 || row > 7) return false;
+            Color color = std::isupper(static_cast<unsigned char>(c)) ? Color::WHITE : Color::BLACK;
+            result.placePiece(row, col++, Piece(types[index], color));
+        }
+    }
+    if (row != 7 || col != 8) return false;
+    
+    // Exactly one king each - the rest of the engine relies on it
+    int whiteKings = 0;
+    int blackKings = 0;
+    for (const auto& rank : result.board) {
+        for (const Piece& piece : rank) {
+            if (piece.getType() != PieceType::KING) continue;
+            (piece.getColor() == Color::WHITE ? whiteKings : blackKings)++;
+        }
+    }
+    if (whiteKings != 1 || blackKings != 1) return false;
+    
+    // Side to move
+    if (side == "w") result.gameState.currentPlayer = Color::WHITE;
+    else if (side == "b") result.gameState.currentPlayer = Color::BLACK;
+    else return false;
+    
+    // Castling rights
+    result.gameState.whiteCanCastleKingside = castling.find('K') != std::string::npos;
+    result.gameState.whiteCanCastleQueenside = castling.find('Q') != std::string::npos;
+    result.gameState.blackCanCastleKingside = castling.find('k') != std::string::npos;
+    result.gameState.blackCanCastleQueenside = castling.find('q') != std::string::npos;
+    
+    // En passant target square - we only track its file
+    if (enPassant != "-") {
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h') return false;
+        result.gameState.enPassantCol = ChessUtils::fileToCol(enPassant[0]);
+    }
+    
+    // Optional move counters
+    int halfMoveClock = 0;
+    int fullMoveNumber = 1;
+    if (fields >> halfMoveClock) {
+        result.gameState.halfMoveClock = halfMoveClock;
+        if (fields >> fullMoveNumber) result.gameState.fullMoveNumber = std::max(1, fullMoveNumber);
+    }
+    
+    *this = result;
+    return true;
+}
+
+// Write the position as a FEN string
+std::string Board::toFEN() const {
+    std::string fen;
+    
+    for (int row = 0; row < 8; ++row) {
+        int emptyCount = 0;
+        for (int col = 0; col < 8; ++col) {
+            const Piece& piece = board[row][col];
+            if (piece.isEmpty()) {
+                ++emptyCount;
+                continue;
+            }
+            if (emptyCount > 0) {
+                fen += static_cast<char>('0' + emptyCount);
+                emptyCount = 0;
+            }
+            char letter = "PRNBQK"[static_cast<int>(piece.getType())];
+            fen += (piece.getColor() == Color::WHITE) ? letter : static_cast<char>(std::tolower(letter));
+        }
+        if (emptyCount > 0) fen += static_cast<char>('0' + emptyCount);
+        if (row < 7) fen += '/';
+    }
+    
+    fen += (gameState.currentPlayer == Color::WHITE) ? " w " : " b ";
+    
+    std::string castling;
+    if (gameState.whiteCanCastleKingside) castling += 'K';
+    if (gameState.whiteCanCastleQueenside) castling += 'Q';
+    if (gameState.blackCanCastleKingside) castling += 'k';
+    if (gameState.blackCanCastleQueenside) castling += 'q';
+    fen += castling.empty() ? "-" : castling;
+    
+    // The target square is behind the pawn that just moved two squares
+    if (gameState.enPassantCol != -1) {
+        fen += ' ';
+        fen += ChessUtils::colToFile(gameState.enPassantCol);
+        fen += (gameState.currentPlayer == Color::WHITE) ? '6' : '3';
+    } else {
+        fen += " -";
+    }
+    
+    fen += " " + std::to_string(gameState.halfMoveClock) + " " + std::to_string(gameState.fullMoveNumber);
+    return fen;
+}
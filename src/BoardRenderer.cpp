@@ -0,0 +1,224 @@
+#include "../include/BoardRenderer.h"
+#include "../include/Zobrist.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+// Board layout, centered on an 80 column terminal (columns count characters
+// as the terminal shows them, not bytes)
+const int TERMINAL_WIDTH = 80;
+const int BOARD_WIDTH = 37;
+const int INDENT = (TERMINAL_WIDTH - BOARD_WIDTH) / 2;
+const int FIRST_RANK_LINE = 3;               // Board lines above rank 8
+const int FIRST_SQUARE_COLUMN = INDENT + 3;  // Columns before the a-file: "8 │"
+const int STATUS_LINE = BoardRenderer::BOARD_LINES - 1;
+
+const char SPACES[] = "                                        ";
+const char FILE_LABELS[] = "    a   b   c   d   e   f   g   h  \n";
+const char TOP_BORDER[] = "  ┌───┬───┬───┬───┬───┬───┬───┬───┐\n";
+const char MIDDLE_BORDER[] = "  ├───┼───┼───┼───┼───┼───┼───┼───┤\n";
+const char BOTTOM_BORDER[] = "  └───┴───┴───┴───┴───┴───┴───┴───┘\n";
+const char LIGHT_SQUARE[] = "\033[47m\033[30m";  // White background, black text
+const char DARK_SQUARE[] = "\033[46m\033[30m";   // Cyan background, black text
+const char RESET[] = "\033[0m";
+
+std::string_view indent() {
+    return std::string_view(SPACES, INDENT);
+}
+
+} // namespace
+
+BoardRenderer::BoardRenderer(int fd)
+    : length(0), fd(fd), onScreen(false), boardLine(0), linesBelow(0), column(0),
+      screenLines(DEFAULT_SCREEN_LINES), squaresDrawn(0) {}
+
+void BoardRenderer::append(std::string_view text) {
+    while (!text.empty()) {
+        if (length == BUFFER_SIZE) flush();
+        size_t size = std::min(text.size(), BUFFER_SIZE - length);
+        std::memcpy(buffer + length, text.data(), size);
+        length += size;
+        text.remove_prefix(size);
+    }
+}
+
+void BoardRenderer::appendNumber(int value) {
+    char digits[12];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0 && count < 11);
+    std::reverse(digits, digits + count);
+    append(std::string_view(digits, count));
+}
+
+// One 3-column square, colors reset afterwards so borders stay plain
+void BoardRenderer::appendSquare(int row, int col, const Piece& piece) {
+    append((row + col) % 2 == 0 ? LIGHT_SQUARE : DARK_SQUARE);
+    append(" ");
+    append(piece.getSymbolView());
+    append(" ");
+    append(RESET);
+}
+
+void BoardRenderer::appendStatus(const Board& board) {
+    std::string_view player = board.getGameState().currentPlayer == Color::WHITE ? "White" : "Black";
+    std::string_view label = "Current player: ";
+    append(std::string_view(SPACES, (TERMINAL_WIDTH - label.size() - player.size()) / 2));
+    append(label);
+    append(player);
+    append("\n");
+}
+
+// ANSI positions are 1-based
+void BoardRenderer::moveCursor(int line, int column) {
+    append("\033[");
+    appendNumber(line + 1);
+    append(";");
+    appendNumber(column + 1);
+    append("H");
+}
+
+void BoardRenderer::drawBoard(const Board& board) {
+    append("\n");
+    append(indent());
+    append(FILE_LABELS);
+    append(indent());
+    append(TOP_BORDER);
+
+    for (int row = 0; row < 8; ++row) {
+        char rank = static_cast<char>('8' - row);
+        append(indent());
+        append(std::string_view(&rank, 1));
+        append(" │");
+        for (int col = 0; col < 8; ++col) {
+            const Piece& piece = board.getPiece(row, col);
+            appendSquare(row, col, piece);
+            append("│");
+            shown[Zobrist::squareIndex(row, col)] = piece;
+        }
+        append(" ");
+        append(std::string_view(&rank, 1));
+        append("\n");
+
+        append(indent());
+        append(row < 7 ? MIDDLE_BORDER : BOTTOM_BORDER);
+    }
+
+    append(indent());
+    append(FILE_LABELS);
+    append("\n");
+    appendStatus(board);
+    squaresDrawn = 64;
+}
+
+// Columns as the terminal counts them: UTF-8 continuation bytes take none,
+// and a full line wraps when the next character arrives
+void BoardRenderer::printedBelow(std::string_view text) {
+    for (char c : text) {
+        if (c == '\n') {
+            ++linesBelow;
+            column = 0;
+        } else if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            if (column == TERMINAL_WIDTH) {
+                ++linesBelow;
+                column = 0;
+            }
+            ++column;
+        }
+    }
+}
+
+// Asked every frame, so a resized window is noticed
+int BoardRenderer::screenHeight() const {
+#ifndef _WIN32
+    winsize size;
+    if (fd >= 0 && ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_row > 0) {
+        return size.ws_row;
+    }
+#endif
+    return screenLines;
+}
+
+// After a frame the cursor is on the line under the status line; anything
+// that took it past the last line scrolled the screen
+bool BoardRenderer::mayHaveScrolled() const {
+    return boardLine + BOARD_LINES + linesBelow >= screenHeight();
+}
+
+void BoardRenderer::drawScreen(const Board& board, std::string_view newHeader) {
+    append("\033[2J\033[H");
+    append(newHeader);
+    drawBoard(board);
+
+    header.assign(newHeader.data(), newHeader.size());
+    boardLine = static_cast<int>(std::count(newHeader.begin(), newHeader.end(), '\n'));
+    linesBelow = 0;
+    column = 0;
+    onScreen = true;
+}
+
+void BoardRenderer::updateScreen(const Board& board, std::string_view newHeader) {
+    if (!onScreen || newHeader != header || mayHaveScrolled()) {
+        drawScreen(board, newHeader);
+        return;
+    }
+
+    squaresDrawn = 0;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Piece& piece = board.getPiece(row, col);
+            Piece& old = shown[Zobrist::squareIndex(row, col)];
+            if (piece.getType() == old.getType() && piece.getColor() == old.getColor()) continue;
+
+            moveCursor(boardLine + FIRST_RANK_LINE + 2 * row, FIRST_SQUARE_COLUMN + 4 * col);
+            appendSquare(row, col, piece);
+            old = piece;
+            ++squaresDrawn;
+        }
+    }
+
+    // The status line, and clear anything printed under it since
+    moveCursor(boardLine + STATUS_LINE, 0);
+    append("\033[J");
+    appendStatus(board);
+    linesBelow = 0;
+    column = 0;
+}
+
+bool BoardRenderer::flush() {
+    size_t size = length;
+    length = 0;
+    if (fd < 0 || size == 0) return true;
+
+    // Anything already printed through the streams goes first
+    std::cout.flush();
+    std::fflush(stdout);
+
+    size_t written = 0;
+    while (written < size) {
+#ifdef _WIN32
+        int result = _write(fd, buffer + written, static_cast<unsigned int>(size - written));
+#else
+        ssize_t result = ::write(fd, buffer + written, size - written);
+#endif
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
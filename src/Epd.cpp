@@ -0,0 +1,90 @@
+#include "../include/Epd.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+    bool isNumber(const std::string& text) {
+        return !text.empty() && std::all_of(text.begin(), text.end(),
+            [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    }
+    
+    std::string trim(const std::string& text) {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) return "";
+        size_t last = text.find_last_not_of(" \t\r\n");
+        return text.substr(first, last - first + 1);
+    }
+}
+
+std::string EpdRecord::getOperation(const std::string& opcode) const {
+    for (const auto& operation : operations) {
+        if (operation.first == opcode) return operation.second;
+    }
+    return "";
+}
+
+bool EpdRecord::hasOperation(const std::string& opcode) const {
+    for (const auto& operation : operations) {
+        if (operation.first == opcode) return true;
+    }
+    return false;
+}
+
+bool parseEpd(const std::string& line, EpdRecord& record) {
+    std::string text = trim(line);
+    if (text.empty() || text[0] == '#') return false;
+    
+    std::istringstream stream(text);
+    std::string placement, side, castling, enPassant;
+    if (!(stream >> placement >> side >> castling >> enPassant)) return false;
+    
+    record.fen = placement + " " + side + " " + castling + " " + enPassant;
+    record.operations.clear();
+    
+    std::string rest;
+    std::getline(stream, rest);
+    
+    // A FEN line has the move counters here instead of operations
+    std::istringstream counters(rest);
+    std::string halfMoves, fullMoves, extra;
+    if (counters >> halfMoves >> fullMoves && isNumber(halfMoves) && isNumber(fullMoves) &&
+        !(counters >> extra)) {
+        record.fen += " " + halfMoves + " " + fullMoves;
+        return true;
+    }
+    
+    // Operations end with ';' - except inside a quoted string
+    std::string current;
+    bool inQuotes = false;
+    auto finishOperation = [&record](const std::string& operation) {
+        std::string op = trim(operation);
+        if (op.empty()) return;
+        size_t space = op.find_first_of(" \t");
+        std::string opcode = op.substr(0, space);
+        std::string operands = space == std::string::npos ? "" : trim(op.substr(space));
+        if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"') {
+            operands = operands.substr(1, operands.size() - 2);
+        }
+        record.operations.emplace_back(opcode, operands);
+    };
+    
+    for (char c : rest) {
+        if (c == '"') inQuotes = !inQuotes;
+        if (c == ';' && !inQuotes) {
+            finishOperation(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    finishOperation(current);
+    
+    // Move counters can be given as the hmvc and fmvn operations
+    std::string halfMoveClock = record.getOperation("hmvc");
+    std::string fullMoveNumber = record.getOperation("fmvn");
+    record.fen += " " + (isNumber(halfMoveClock) ? halfMoveClock : "0");
+    record.fen += " " + (isNumber(fullMoveNumber) ? fullMoveNumber : "1");
+    
+    return true;
+}
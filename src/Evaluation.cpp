@@ -0,0 +1,96 @@
+#include "../include/Evaluation.h"
+#include "../include/Mobility.h"
+#include "../include/PawnStructure.h"
+#include "../include/PieceSquareTables.h"
+#include "../include/Zobrist.h"
+#include <algorithm>
+
+namespace {
+
+// Columns of one chunk
+struct BatchColumns {
+    int midgame[Evaluation::BATCH_CHUNK];
+    int endgame[Evaluation::BATCH_CHUNK];
+    int phase[Evaluation::BATCH_CHUNK];
+    int pawns[Evaluation::BATCH_CHUNK];
+};
+
+// Stored positions from the same games share most pawn structures; each
+// thread keeps its own cache, keyed like Board::getPawnKey
+int pawnScore(uint64_t whitePawns, uint64_t blackPawns) {
+    thread_local PawnHashTable cache(256);
+
+    uint64_t key = 0;
+    for (uint64_t bits = whitePawns; bits; bits &= bits - 1) {
+        key ^= Zobrist::pieceKey(PieceType::PAWN, Color::WHITE, __builtin_ctzll(bits));
+    }
+    for (uint64_t bits = blackPawns; bits; bits &= bits - 1) {
+        key ^= Zobrist::pieceKey(PieceType::PAWN, Color::BLACK, __builtin_ctzll(bits));
+    }
+
+    int score = 0;
+    if (!cache.probe(key, score)) {
+        score = PawnStructure::evaluate(whitePawns, blackPawns);
+        cache.store(key, score);
+    }
+    return score;
+}
+
+// Pass one: decode and score everything that needs the pieces
+void fillColumns(const PackedPosition* positions, size_t count, BatchColumns& columns) {
+    const PieceSquareTables::ScoreTable& table = PieceSquareTables::table();
+    const int PAWN = static_cast<int>(PieceType::PAWN);
+
+    for (size_t i = 0; i < count; ++i) {
+        const PackedPosition& position = positions[i];
+        uint64_t pieces[2][6] = {};
+        int midgame = 0;
+        int endgame = 0;
+        int phase = 0;
+
+        int index = 0;
+        for (uint64_t bits = position.occupancy; bits && index < 32; bits &= bits - 1, ++index) {
+            int code = (position.pieces[index / 2] >> (index % 2 * 4)) & 15;
+            int type = code & 7;
+            if (type > static_cast<int>(PieceType::KING)) continue;  // Corrupt record
+
+            int side = (code & PackedPositions::BLACK_FLAG) ? 1 : 0;
+            int square = __builtin_ctzll(bits);
+            int sign = side == 0 ? 1 : -1;
+            pieces[side][type] |= 1ULL << square;
+            midgame += sign * table.midgame[side][type][square];
+            endgame += sign * table.endgame[side][type][square];
+            phase += table.phase[type];
+        }
+
+        Mobility::Score mobility = Mobility::evaluate(pieces);
+        columns.midgame[i] = midgame + mobility.midgame;
+        columns.endgame[i] = endgame + mobility.endgame;
+        columns.phase[i] = std::min(phase, PieceSquareTables::MAX_PHASE);
+        columns.pawns[i] = pawnScore(pieces[0][PAWN], pieces[1][PAWN]);
+    }
+}
+
+} // namespace
+
+namespace Evaluation {
+
+void evaluateBatch(const PackedPosition* positions, size_t count, int* scores) {
+    BatchColumns columns;
+    const int maxPhase = PieceSquareTables::MAX_PHASE;
+
+    for (size_t start = 0; start < count; start += BATCH_CHUNK) {
+        size_t size = std::min(BATCH_CHUNK, count - start);
+        fillColumns(positions + start, size, columns);
+
+        // Pass two: PieceSquareTables::taper over whole columns
+        int* out = scores + start;
+        for (size_t i = 0; i < size; ++i) {
+            int phase = columns.phase[i];
+            out[i] = (columns.midgame[i] * phase + columns.endgame[i] * (maxPhase - phase)) / maxPhase +
+                     columns.pawns[i];
+        }
+    }
+}
+
+} // namespace Evaluation
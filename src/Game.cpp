@@ -1,8 +1,11 @@
 #include "../include/Game.h"
+#include "../include/Notation.h"
 #include "../include/Utils.h"
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <limits>
+#include <sstream>
 
 // Constructor
 Game::Game() : currentMode(GameMode::PLAYER_VS_PLAYER), gameRunning(false) {
@@ -70,11 +73,19 @@ void Game::showMainMenu() {
         case 2:
             currentMode = GameMode::PLAYER_VS_AI_WHITE;
             ai = std::make_unique<AI>(AILevel::MEDIUM, Color::BLACK);
+            ai->setOpeningBook(openingBook);
+            ai->setTablebase(tablebase);
+            ai->setNetwork(network);
+            if (!hashPath.empty()) ai->loadHash(hashPath);
             startNewGame();
             break;
         case 3:
             currentMode = GameMode::PLAYER_VS_AI_BLACK;
             ai = std::make_unique<AI>(AILevel::MEDIUM, Color::WHITE);
+            ai->setOpeningBook(openingBook);
+            ai->setTablebase(tablebase);
+            ai->setNetwork(network);
+            if (!hashPath.empty()) ai->loadHash(hashPath);
             startNewGame();
             break;
         case 4:
@@ -102,6 +113,8 @@ void Game::startNewGame() {
 
 // Player vs Player game loop
 void Game::playPlayerVsPlayer() {
+    renderer.invalidate();  // The menu has the screen
+    
     while (!checkGameEnd()) {
         displayGameState();
         
@@ -115,7 +128,7 @@ void Game::playPlayerVsPlayer() {
         if (executeMove(playerMove)) {
             // Move was successful, continue
         } else {
-            std::cout << "Invalid move! Please try again.\n";
+            print("Invalid move! Please try again.\n");
             waitForEnter();
         }
     }
@@ -125,6 +138,8 @@ void Game::playPlayerVsPlayer() {
 
 // Player vs AI game loop
 void Game::playPlayerVsAI() {
+    renderer.invalidate();  // The menu has the screen
+    
     while (!checkGameEnd()) {
         displayGameState();
         
@@ -140,21 +155,26 @@ void Game::playPlayerVsAI() {
             }
             
             if (!executeMove(playerMove)) {
-                std::cout << "Invalid move! Please try again.\n";
+                print("Invalid move! Please try again.\n");
                 waitForEnter();
                 continue;
             }
         } else {
             // AI's turn
-            std::cout << "AI is thinking...\n";
+            print("AI is thinking...\n");
             Move aiMove = ai->getBestMove(board);
             
             if (executeMove(aiMove)) {
-                std::cout << "AI moves: " << ChessUtils::moveToString(
-                    aiMove.fromRow, aiMove.fromCol, aiMove.toRow, aiMove.toCol) << "\n";
+                print("AI moves: " + ChessUtils::moveToString(
+                    aiMove.fromRow, aiMove.fromCol, aiMove.toRow, aiMove.toCol) + "\n");
+                const SearchStats& stats = ai->getLastSearchStats();
+                if (!stats.iterations.empty()) {
+                    print("Searched " + std::to_string(stats.getDepth()) + " plies, " + std::to_string(stats.nodes) +
+                          " positions in " + std::to_string(static_cast<int>(stats.milliseconds)) + " ms\n");
+                }
                 waitForEnter();
             } else {
-                std::cout << "AI made an invalid move! This shouldn't happen.\n";
+                print("AI made an invalid move! This shouldn't happen.\n");
                 waitForEnter();
                 break;
             }
@@ -167,21 +187,54 @@ void Game::playPlayerVsAI() {
 // Get player move input
 Move Game::getPlayerMove() {
     while (true) {
-        std::string input = ChessUtils::getInput("Enter your move (e.g., 'e2 e4') or 'quit' to return to menu: ");
+        const std::string prompt = "Enter your move (e.g., 'e2 e4') or 'quit' to return to menu: ";
+        std::string input = ChessUtils::getInput(prompt);
+        renderer.printedBelow(prompt + input + "\n");  // The terminal echoed the input
         
         if (ChessUtils::toLowerCase(input) == "quit") {
             return Move(-1, -1, -1, -1);  // Special move to indicate quit
         }
+        if (ChessUtils::toLowerCase(input).rfind("hash", 0) == 0) {
+            handleHashCommand(input);
+            continue;
+        }
         
         Move move(0, 0, 0, 0);
         if (parsePlayerInput(input, move)) {
             return move;
         } else {
-            std::cout << "Invalid input format. Please use format like 'e2 e4'.\n";
+            print("Invalid input format. Please use format like 'e2 e4'.\n");
         }
     }
 }
 
+// "hash save [file]" / "hash load [file]": keep the AI's search results
+// between runs. The file defaults to the one given with --hash.
+void Game::handleHashCommand(const std::string& input) {
+    std::istringstream words(input);
+    std::string command, action, path;
+    words >> command >> action >> path;
+    action = ChessUtils::toLowerCase(action);
+    if (path.empty()) path = hashPath;
+    
+    if ((action != "save" && action != "load") || path.empty()) {
+        print("Usage: hash save [file] or hash load [file] (the file defaults to --hash)\n");
+        return;
+    }
+    if (!ai) {
+        print("There is no AI in this game.\n");
+        return;
+    }
+    
+    long long count = action == "save" ? ai->saveHash(path) : ai->loadHash(path);
+    if (count < 0) {
+        print("Could not " + action + " " + path + "\n");
+    } else {
+        print((action == "save" ? "Saved " : "Loaded ") + std::to_string(count) + " search results " +
+              (action == "save" ? "to " : "from ") + path + "\n");
+    }
+}
+
 // Parse player input into a move
 bool Game::parsePlayerInput(const std::string& input, Move& move) {
     int fromRow, fromCol, toRow, toCol;
@@ -204,33 +257,70 @@ bool Game::executeMove(const Move& move) {
 
 // Display current game state
 void Game::displayGameState() {
-    ChessUtils::clearScreen();
-    
-    // Show game mode
-    std::cout << "Mode: ";
+    std::string_view header;
     switch (currentMode) {
         case GameMode::PLAYER_VS_PLAYER:
-            std::cout << "Player vs Player";
+            header = "Mode: Player vs Player\n\n";
             break;
         case GameMode::PLAYER_VS_AI_WHITE:
-            std::cout << "Player (White) vs AI (Black)";
+            header = "Mode: Player (White) vs AI (Black)\n\n";
             break;
         case GameMode::PLAYER_VS_AI_BLACK:
-            std::cout << "Player (Black) vs AI (White)";
+            header = "Mode: Player (Black) vs AI (White)\n\n";
             break;
     }
-    std::cout << "\n\n";
     
-    // Display the board
-    board.display();
+    // Mode and board in one write; after the first turn only the squares
+    // that changed are redrawn
+    renderer.updateScreen(board, header);
+    renderer.flush();
     
     // Show game status
     Color currentPlayer = board.getGameState().currentPlayer;
     if (board.isInCheck(currentPlayer)) {
-        std::cout << "\n*** CHECK! ***\n";
+        print("\n*** CHECK! ***\n");
     }
     
-    std::cout << "\n";
+    displayArchiveStats();
+    print("\n");
+}
+
+// Everything printed under the board during a game goes through here, so
+// the renderer knows when it may have scrolled the screen
+void Game::print(const std::string& text) {
+    std::cout << text;
+    renderer.printedBelow(text);
+}
+
+// How often the archive reached this position and the moves played most,
+// scored for the side to move
+void Game::displayArchiveStats() {
+    if (!positionIndex) return;
+    
+    std::vector<PositionIndex::MoveStats> moves = positionIndex->lookup(board);
+    uint32_t games = 0;
+    for (const PositionIndex::MoveStats& stats : moves) games += stats.games;
+    if (games == 0) {
+        print("\nArchive: position not reached\n");
+        return;
+    }
+    
+    bool white = board.getGameState().currentPlayer == Color::WHITE;
+    std::ostringstream line;
+    line << "\nArchive: " << games << (games == 1 ? " game" : " games");
+    const size_t shown = 5;
+    size_t listed = 0;
+    for (const PositionIndex::MoveStats& stats : moves) {
+        Move move = OpeningBook::decodeMove(stats.move);
+        if (listed == shown || !board.isValidMove(move)) continue;  // Key collisions
+        
+        uint32_t decided = stats.whiteWins + stats.draws + stats.blackWins;
+        uint32_t wins = white ? stats.whiteWins : stats.blackWins;
+        line << (listed++ == 0 ? " - " : ", ") << Notation::toSAN(board, move) << ' ' << stats.games;
+        if (decided > 0) line << " (" << (200ULL * wins + 100ULL * stats.draws) / (2ULL * decided) << "%)";
+    }
+    line << "\n";
+    print(line.str());
 }
 
 // Check if game has ended
@@ -260,14 +350,14 @@ void Game::handleGameEnd() {
     
     if (board.isCheckmate(currentPlayer)) {
         Color winner = (currentPlayer == Color::WHITE) ? Color::BLACK : Color::WHITE;
-        std::cout << "CHECKMATE! " << (winner == Color::WHITE ? "White" : "Black") << " wins!\n";
+        print(std::string("CHECKMATE! ") + (winner == Color::WHITE ? "White" : "Black") + " wins!\n");
     } else if (board.isStalemate(currentPlayer)) {
-        std::cout << "STALEMATE! The game is a draw.\n";
+        print("STALEMATE! The game is a draw.\n");
     } else if (board.isDraw()) {
-        std::cout << "DRAW! The game ends in a draw.\n";
+        print("DRAW! The game ends in a draw.\n");
     }
     
-    std::cout << "\nGame Over!\n";
+    print("\nGame Over!\n");
     waitForEnter();
 }
 
@@ -327,7 +417,7 @@ void Game::showAbout() {
 
 // Wait for user to press Enter
 void Game::waitForEnter() {
-    std::cout << "Press Enter to continue...";
+    print("Press Enter to continue...");
     std::cout.flush();
     
     if (std::cin.eof()) {
@@ -337,6 +427,78 @@ void Game::waitForEnter() {
     // Clear any pending input and wait for enter
     std::cin.clear();
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    renderer.printedBelow("\n");  // Echoed with the input
+}
+
+// Load an opening book for the AI to use
+bool Game::loadOpeningBook(const std::string& path) {
+    auto book = std::make_shared<OpeningBook>();
+    if (!book->load(path)) {
+        return false;
+    }
+    
+    openingBook = book;
+    if (ai) {
+        ai->setOpeningBook(openingBook);
+    }
+    return true;
+}
+
+// Map the endgame tablebases in a directory for the AI to probe
+int Game::loadTablebases(const std::string& directory) {
+    auto tables = std::make_shared<Tablebase>();
+    int count = tables->load(directory);
+    if (count == 0) {
+        return 0;
+    }
+    
+    tablebase = tables;
+    if (ai) {
+        ai->setTablebase(tablebase);
+    }
+    return count;
+}
+
+// Map a neural network for the AI to evaluate with
+bool Game::loadNetwork(const std::string& path) {
+    auto net = std::make_shared<Nnue::Network>();
+    if (!net->load(path)) {
+        return false;
+    }
+    
+    network = net;
+    if (ai) {
+        ai->setNetwork(network);
+    }
+    return true;
+}
+
+// Search results saved by an earlier run, loaded into every AI we create.
+// A file that doesn't exist yet is fine - "hash save" will create it.
+bool Game::loadHashSnapshot(const std::string& path) {
+    if (std::ifstream(path).good()) {
+        TranspositionTable check(1);
+        if (check.load(path, Color::WHITE) < 0) {
+            return false;
+        }
+    }
+    
+    hashPath = path;
+    if (ai) {
+        ai->loadHash(hashPath);
+    }
+    return true;
+}
+
+// Map a position index for the statistics shown under the board
+bool Game::loadPositionIndex(const std::string& path) {
+    auto index = std::make_shared<PositionIndex>();
+    if (!index->open(path)) {
+        return false;
+    }
+    
+    positionIndex = index;
+    return true;
 }
 
 // Quit the game
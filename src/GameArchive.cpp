@@ -0,0 +1,247 @@
+#include "../include/GameArchive.h"
+#include "../include/MoveGen.h"
+#include "../include/Notation.h"
+#include "../include/Varint.h"
+#include <algorithm>
+#include <cstring>
+
+const char GameArchive::MAGIC[8] = {'C', 'C', 'G', 'A', 'M', 'E', '1', '\0'};
+
+namespace {
+
+struct ArchiveHeader {
+    char magic[8];
+    uint64_t games;
+    uint64_t indexOffset;  // From the start of the file; 8-byte aligned
+};
+
+static_assert(sizeof(ArchiveHeader) == 24, "ArchiveHeader is part of the file format");
+
+const char* const RESULTS[4] = {"*", "1-0", "0-1", "1/2-1/2"};
+
+int resultCode(const std::string& result) {
+    for (int code = 1; code < 4; ++code) {
+        if (result == RESULTS[code]) return code;
+    }
+    return 0;
+}
+
+// Bits needed for an index into a list of count moves
+int indexBits(int count) {
+    return count <= 1 ? 0 : 32 - __builtin_clz(static_cast<uint32_t>(count - 1));
+}
+
+void putString(std::vector<uint8_t>& out, const std::string& text) {
+    Varint::put(out, text.size());
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+bool getString(const uint8_t*& in, const uint8_t* end, std::string& text) {
+    uint64_t length = 0;
+    if (!Varint::get(in, end, length) || length > static_cast<uint64_t>(end - in)) return false;
+    text.assign(reinterpret_cast<const char*>(in), length);
+    in += length;
+    return true;
+}
+
+// Packs values least significant bit first
+class BitWriter {
+private:
+    std::vector<uint8_t>& out;
+    uint64_t bits = 0;
+    int count = 0;
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void put(uint32_t value, int width) {
+        bits |= static_cast<uint64_t>(value) << count;
+        count += width;
+        while (count >= 8) {
+            out.push_back(static_cast<uint8_t>(bits));
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    void flush() {
+        if (count > 0) out.push_back(static_cast<uint8_t>(bits));
+        bits = 0;
+        count = 0;
+    }
+};
+
+class BitReader {
+private:
+    const uint8_t* in;
+    const uint8_t* end;
+    uint64_t bits = 0;
+    int count = 0;
+
+public:
+    BitReader(const uint8_t* in, const uint8_t* end) : in(in), end(end) {}
+
+    bool get(int width, uint32_t& value) {
+        while (count < width) {
+            if (in == end) return false;
+            bits |= static_cast<uint64_t>(*in++) << count;
+            count += 8;
+        }
+        value = static_cast<uint32_t>(bits & ((1ULL << width) - 1));
+        bits >>= width;
+        count -= width;
+        return true;
+    }
+};
+
+} // namespace
+
+GameArchive::Writer::Writer(const std::string& path) : out(path, std::ios::binary | std::ios::trunc) {
+    ArchiveHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offsets.push_back(sizeof(header));
+}
+
+bool GameArchive::Writer::add(const PgnGame& game) {
+    Board board;
+    std::string fen = game.getTag("FEN");
+    if (!fen.empty() && !board.loadFEN(fen)) return false;
+
+    buffer.clear();
+    Varint::put(buffer, game.tags.size());
+    for (const auto& tag : game.tags) {
+        putString(buffer, tag.first);
+        putString(buffer, tag.second);
+    }
+    buffer.push_back(static_cast<uint8_t>(resultCode(game.result)));
+    Varint::put(buffer, game.moves.size());
+
+    BitWriter bits(buffer);
+    MoveGen::MoveList legal;
+    Move move;
+    for (const std::string& san : game.moves) {
+        if (!Notation::fromSAN(board, san, move)) return false;
+
+        MoveGen::generate(MoveGen::Position(board), legal);
+        int index = 0;
+        while (index < legal.size() &&
+               !(legal.moves[index].fromRow == move.fromRow && legal.moves[index].fromCol == move.fromCol &&
+                 legal.moves[index].toRow == move.toRow && legal.moves[index].toCol == move.toCol &&
+                 legal.moves[index].promotionPiece == move.promotionPiece)) {
+            ++index;
+        }
+        if (index == legal.size()) return false;
+
+        bits.put(static_cast<uint32_t>(index), indexBits(legal.size()));
+        board.makeMove(move);
+    }
+    bits.flush();
+
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    offsets.push_back(offsets.back() + buffer.size());
+    return static_cast<bool>(out);
+}
+
+bool GameArchive::Writer::finish() {
+    // Pad so the index can be read in place as uint64_t
+    uint64_t indexOffset = (offsets.back() + 7) & ~7ULL;
+    const char padding[8] = {};
+    out.write(padding, indexOffset - offsets.back());
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    ArchiveHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.games = gameCount();
+    header.indexOffset = indexOffset;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    return !out.fail();
+}
+
+bool GameArchive::open(const std::string& path) {
+    games = 0;
+    if (!file.open(path) || file.size() < sizeof(ArchiveHeader)) return false;
+
+    ArchiveHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.indexOffset % 8 != 0 ||
+        header.indexOffset < sizeof(ArchiveHeader) || header.indexOffset > file.size()) {
+        return false;
+    }
+    // Divided rather than multiplied out, so a huge count can't wrap around
+    uint64_t indexEntries = (file.size() - header.indexOffset) / sizeof(uint64_t);
+    if (indexEntries == 0 || header.games > indexEntries - 1) return false;
+
+    // Games follow each other between the header and the index
+    offsets = reinterpret_cast<const uint64_t*>(file.getData() + header.indexOffset);
+    if (offsets[0] < sizeof(ArchiveHeader)) return false;
+    for (uint64_t i = 0; i < header.games; ++i) {
+        if (offsets[i] > offsets[i + 1]) return false;
+    }
+    if (offsets[header.games] > header.indexOffset) return false;
+    games = header.games;
+    return true;
+}
+
+bool GameArchive::decode(size_t index, PgnGame* header, Board& start, std::vector<Move>& moves) const {
+    moves.clear();
+    if (index >= games) return false;
+    const uint8_t* in = file.getData() + offsets[index];
+    const uint8_t* end = file.getData() + offsets[index + 1];
+
+    uint64_t tagCount = 0;
+    if (!Varint::get(in, end, tagCount)) return false;
+    if (header) header->tags.clear();
+    std::string fen;
+    std::string name;
+    std::string value;
+    for (uint64_t i = 0; i < tagCount; ++i) {
+        if (!getString(in, end, name) || !getString(in, end, value)) return false;
+        if (name == "FEN") fen = value;
+        if (header) header->tags.emplace_back(name, value);
+    }
+
+    uint64_t plies = 0;
+    if (in == end) return false;
+    int result = *in++;
+    if (result > 3 || !Varint::get(in, end, plies)) return false;
+    if (header) header->result = RESULTS[result];
+
+    if (fen.empty() || !start.loadFEN(fen)) start.resetToStartingPosition();
+
+    MoveGen::Position position(start);
+    MoveGen::MoveList legal;
+    BitReader bits(in, end);
+    // Forced moves take no bits, so plies may exceed the bits left - but a
+    // corrupt count mustn't reserve more than the game could hold
+    moves.reserve(std::min<uint64_t>(plies, static_cast<uint64_t>(end - in) * 8));
+    for (uint64_t ply = 0; ply < plies; ++ply) {
+        MoveGen::generate(position, legal);
+        uint32_t choice = 0;
+        if (!bits.get(indexBits(legal.size()), choice) || choice >= static_cast<uint32_t>(legal.size())) {
+            return false;
+        }
+        moves.push_back(legal.moves[choice]);
+        position.play(legal.moves[choice]);
+    }
+    return true;
+}
+
+bool GameArchive::readMoves(size_t index, Board& start, std::vector<Move>& moves) const {
+    return decode(index, nullptr, start, moves);
+}
+
+bool GameArchive::readGame(size_t index, PgnGame& game) const {
+    Board board;
+    std::vector<Move> moves;
+    if (!decode(index, &game, board, moves)) return false;
+
+    game.moves.clear();
+    game.moves.reserve(moves.size());
+    for (const Move& move : moves) {
+        game.moves.push_back(Notation::toSAN(board, move));
+        board.makeMove(move);
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+#include "../include/LargePages.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+#endif
+
+namespace {
+
+size_t roundUp(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+} // namespace
+
+void* LargePages::allocate(size_t bytes, bool allowLarge) {
+    release();
+    if (bytes == 0) return nullptr;
+
+    #ifndef _WIN32
+        // Huge pages only pay off once the block spans several of them
+        bool large = allowLarge && bytes >= PAGE_SIZE;
+
+        #ifdef MAP_HUGETLB
+            if (large) {
+                size_t rounded = roundUp(bytes, PAGE_SIZE);
+                void* mapping = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (mapping != MAP_FAILED) {
+                    memory = mapping;
+                    mappedLength = rounded;
+                    pageKind = Kind::EXPLICIT;
+                }
+            }
+        #endif
+
+        if (!memory) {
+            // Over-allocate by a page so the block can start on a 2 MB
+            // boundary, where the kernel can back it with huge pages
+            size_t rounded = large ? roundUp(bytes, PAGE_SIZE) + PAGE_SIZE : bytes;
+            void* mapping = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED) return nullptr;
+
+            pageKind = Kind::NORMAL;
+            if (large) {
+                char* start = static_cast<char*>(mapping);
+                char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<size_t>(start), PAGE_SIZE));
+                size_t head = static_cast<size_t>(aligned - start);
+                size_t body = roundUp(bytes, PAGE_SIZE);
+                if (head > 0) munmap(start, head);
+                if (rounded - head > body) munmap(aligned + body, rounded - head - body);
+                mapping = aligned;
+                rounded = body;
+                #ifdef MADV_HUGEPAGE
+                    if (madvise(mapping, rounded, MADV_HUGEPAGE) == 0) pageKind = Kind::TRANSPARENT;
+                #endif
+            }
+            memory = mapping;
+            mappedLength = rounded;
+        }
+    #else
+        (void)allowLarge;
+        memory = std::calloc(1, bytes);
+        if (!memory) return nullptr;
+        mappedLength = bytes;
+        pageKind = Kind::NORMAL;
+    #endif
+
+    length = bytes;
+    return memory;
+}
+
+void LargePages::release() {
+    if (!memory) return;
+    #ifndef _WIN32
+        munmap(memory, mappedLength);
+    #else
+        std::free(memory);
+    #endif
+    memory = nullptr;
+    length = 0;
+    mappedLength = 0;
+    pageKind = Kind::NONE;
+}
+
+void LargePages::clear(int threads) {
+    if (!memory) return;
+
+    // Below a slice per thread starting them costs more than it saves
+    size_t maxThreads = std::max<size_t>(1, length / CLEAR_SLICE);
+    size_t count = std::min<size_t>(std::max(1, threads), maxThreads);
+    if (count == 1) {
+        std::memset(memory, 0, length);
+        return;
+    }
+
+    size_t slice = roundUp(length / count, PAGE_SIZE);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < count; ++i) {
+        size_t begin = std::min(length, i * slice);
+        size_t end = std::min(length, begin + slice);
+        if (begin == end) break;
+        workers.emplace_back([this, begin, end] {
+            std::memset(static_cast<char*>(memory) + begin, 0, end - begin);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+const char* LargePages::describe(Kind kind) {
+    switch (kind) {
+        case Kind::NORMAL: return "normal pages";
+        case Kind::TRANSPARENT: return "transparent huge pages";
+        case Kind::EXPLICIT: return "explicit huge pages";
+        default: return "none";
+    }
+}
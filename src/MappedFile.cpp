@@ -0,0 +1,66 @@
+#include "../include/MappedFile.h"
+#include <fstream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), length(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    
+    #ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // The mapping stays valid after closing the descriptor
+        if (mapping == MAP_FAILED) return false;
+        
+        data = static_cast<const uint8_t*>(mapping);
+        length = static_cast<size_t>(info.st_size);
+    #else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        
+        fallback.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(fallback.data()), fallback.size());
+        if (!file || fallback.empty()) {
+            fallback.clear();
+            return false;
+        }
+        
+        data = fallback.data();
+        length = fallback.size();
+    #endif
+    
+    return true;
+}
+
+void MappedFile::close() {
+    #ifndef _WIN32
+        if (data) {
+            munmap(const_cast<uint8_t*>(data), length);
+        }
+    #else
+        fallback.clear();
+    #endif
+    
+    data = nullptr;
+    length = 0;
+}
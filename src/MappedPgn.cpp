@@ -0,0 +1,257 @@
+#include "../include/MappedPgn.h"
+#include "../include/Notation.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool endsToken(char c) {
+    return isSpace(c) || c == '{' || c == '(' || c == ')' || c == ';';
+}
+
+// A tag line that follows movetext (or nothing) starts a game. Looks back
+// past blank lines to the previous line with content.
+bool isGameStart(const char* data, size_t offset) {
+    size_t lineStart = offset;
+    while (lineStart > 0) {
+        size_t lineEnd = lineStart - 1;  // The '\n' ending the previous line
+        lineStart = lineEnd;
+        while (lineStart > 0 && data[lineStart - 1] != '\n') --lineStart;
+
+        size_t first = lineStart;
+        while (first < lineEnd && isSpace(data[first])) ++first;
+        if (first < lineEnd) return data[first] != '[';
+    }
+    return true;
+}
+
+// Game starts in [begin, end) - tag lines only begin right after a newline
+void findStarts(const char* data, size_t begin, size_t end, std::vector<size_t>& found) {
+    size_t offset = begin;
+    if (offset > 0) {
+        const void* newline = std::memchr(data + offset - 1, '\n', end - (offset - 1));
+        if (!newline) return;
+        offset = static_cast<const char*>(newline) - data + 1;
+    }
+    while (offset < end) {
+        if (data[offset] == '[' && isGameStart(data, offset)) found.push_back(offset);
+        const void* newline = std::memchr(data + offset, '\n', end - offset);
+        if (!newline) break;
+        offset = static_cast<const char*>(newline) - data + 1;
+    }
+}
+
+} // namespace
+
+PgnTokenizer::PgnTokenizer(std::string_view game) : text(game), position(0), inMovetext(false) {}
+
+void PgnTokenizer::skipLine() {
+    size_t newline = text.find('\n', position);
+    position = newline == std::string_view::npos ? text.size() : newline + 1;
+}
+
+bool PgnTokenizer::nextTag(std::string_view& name, std::string_view& value) {
+    while (!inMovetext) {
+        while (position < text.size() && isSpace(text[position])) ++position;
+        if (position == text.size()) return false;
+
+        char c = text[position];
+        if (c == '%') {
+            skipLine();  // Escape line
+            continue;
+        }
+        if (c != '[') {
+            inMovetext = true;
+            return false;
+        }
+
+        size_t lineEnd = text.find('\n', position);
+        std::string_view line = text.substr(position, lineEnd == std::string_view::npos ? lineEnd : lineEnd - position);
+        skipLine();
+
+        size_t nameEnd = line.find_first_of(" \t\"", 1);
+        size_t valueStart = line.find('"');
+        size_t valueEnd = line.rfind('"');
+        if (nameEnd == std::string_view::npos || valueStart == std::string_view::npos || valueEnd <= valueStart) {
+            continue;  // Malformed tag - ignore it
+        }
+        name = line.substr(1, nameEnd - 1);
+        value = line.substr(valueStart + 1, valueEnd - valueStart - 1);
+        return true;
+    }
+    return false;
+}
+
+bool PgnTokenizer::nextMove(std::string_view& san) {
+    std::string_view name;
+    std::string_view value;
+    while (nextTag(name, value)) {}
+
+    int variationDepth = 0;
+    while (position < text.size()) {
+        char c = text[position];
+        if (isSpace(c)) {
+            ++position;
+            continue;
+        }
+        if (c == '{') {
+            size_t close = text.find('}', position);
+            position = close == std::string_view::npos ? text.size() : close + 1;
+            continue;
+        }
+        if (c == ';' || (c == '%' && (position == 0 || text[position - 1] == '\n'))) {
+            skipLine();  // Rest-of-line comment or escape line
+            continue;
+        }
+        if (c == '(') {
+            ++variationDepth;
+            ++position;
+            continue;
+        }
+        if (c == ')') {
+            if (variationDepth > 0) --variationDepth;
+            ++position;
+            continue;
+        }
+
+        size_t start = position;
+        while (position < text.size() && !endsToken(text[position])) ++position;
+        std::string_view token = text.substr(start, position - start);
+
+        if (variationDepth > 0 || token[0] == '$') continue;  // Side line or numeric annotation glyph
+
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+            result = token;
+            position = text.size();
+            return false;
+        }
+
+        // Strip a leading move number: "12." "12..." or "12.Nf3"
+        size_t digits = 0;
+        while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9') ++digits;
+        if (digits > 0 && digits < token.size() && token[digits] == '.') {
+            while (digits < token.size() && token[digits] == '.') ++digits;
+            token.remove_prefix(digits);
+        } else if (digits == token.size()) {
+            continue;  // Bare move number without dots
+        }
+
+        if (!token.empty()) {
+            san = token;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MappedPgn::open(const std::string& path, int threads) {
+    starts.clear();
+    if (!file.open(path)) return false;
+
+    const char* data = reinterpret_cast<const char*>(file.getData());
+    size_t length = file.size();
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // One slice per thread; a slice owns the tag lines that begin inside it
+    const size_t minimumSlice = 1 << 20;
+    size_t slices = std::max<size_t>(1, std::min<size_t>(threads, length / minimumSlice));
+    std::vector<std::vector<size_t>> found(slices);
+    {
+        ThreadPool pool(static_cast<int>(slices));
+        for (size_t i = 0; i < slices; ++i) {
+            pool.submit([&, i] {
+                findStarts(data, length * i / slices, length * (i + 1) / slices, found[i]);
+            });
+        }
+        pool.wait();
+    }
+
+    // Movetext before the first tag line is a game too
+    starts.push_back(0);
+    for (const auto& slice : found) {
+        for (size_t offset : slice) {
+            if (offset != starts.back()) starts.push_back(offset);
+        }
+    }
+    starts.push_back(length);
+
+    if (starts.size() > 2 && std::all_of(data, data + starts[1], isSpace)) {
+        starts.erase(starts.begin());  // Only blank lines before the first tags
+    }
+    return true;
+}
+
+std::string_view MappedPgn::game(size_t index) const {
+    if (index >= gameCount()) return std::string_view();
+    const char* data = reinterpret_cast<const char*>(file.getData());
+    return std::string_view(data + starts[index], starts[index + 1] - starts[index]);
+}
+
+std::string_view MappedPgn::tag(std::string_view game, std::string_view name) {
+    PgnTokenizer tokens(game);
+    std::string_view tagName;
+    std::string_view value;
+    while (tokens.nextTag(tagName, value)) {
+        if (tagName == name) return value;
+    }
+    return std::string_view();
+}
+
+MappedPgn::ReplayStats MappedPgn::replay(int threads, const std::function<void(const ReplayPosition&)>& onPosition) const {
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> positions(0);
+    std::atomic<size_t> failed(0);
+
+    size_t count = gameCount();
+    ThreadPool pool(threads);
+    const size_t gamesPerTask = std::max<size_t>(16, count / (static_cast<size_t>(pool.size()) * 16 + 1));
+
+    for (size_t first = 0; first < count; first += gamesPerTask) {
+        size_t last = std::min(count, first + gamesPerTask);
+        pool.submit([&, first, last] {
+            Board board;
+            size_t reached = 0;
+            size_t stopped = 0;
+            for (size_t index = first; index < last; ++index) {
+                std::string_view text = game(index);
+                std::string_view fen = tag(text, "FEN");
+                if (fen.empty() || !board.loadFEN(std::string(fen))) board.resetToStartingPosition();
+
+                int ply = 0;
+                if (onPosition) onPosition(ReplayPosition{index, ply, board, nullptr});
+                ++reached;
+
+                PgnTokenizer tokens(text);
+                std::string_view san;
+                Move move(0, 0, 0, 0);
+                while (tokens.nextMove(san)) {
+                    if (!Notation::fromSAN(board, san, move) || !board.makeMove(move)) {
+                        ++stopped;
+                        break;
+                    }
+                    ++ply;
+                    if (onPosition) onPosition(ReplayPosition{index, ply, board, &move});
+                    ++reached;
+                }
+            }
+            positions += reached;
+            failed += stopped;
+        });
+    }
+    pool.wait();
+
+    ReplayStats stats;
+    stats.games = count;
+    stats.positions = positions;
+    stats.failed = failed;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,138 @@
+#include "../include/Mobility.h"
+#include "../include/Attacks.h"
+#include <algorithm>
+
+namespace Mobility {
+
+//                                 P  R  N  B  Q  K
+const int MIDGAME_WEIGHT[6]     = {0, 3, 4, 5, 1, 0};
+const int ENDGAME_WEIGHT[6]     = {0, 4, 4, 5, 2, 0};
+const int BASELINE[6]           = {0, 7, 4, 6, 14, 0};
+const int KING_ATTACK_WEIGHT[6] = {0, 3, 2, 2, 5, 0};
+
+int kingDanger(int attackUnits) {
+    return std::min(attackUnits * attackUnits / 4, MAX_KING_DANGER);
+}
+
+} // namespace Mobility
+
+namespace {
+
+const PieceType MOBILE_PIECES[4] = {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN};
+
+uint64_t attacksFrom(PieceType type, int square, uint64_t occupied) {
+    switch (type) {
+        case PieceType::KNIGHT: return Attacks::knight(square);
+        case PieceType::BISHOP: return Attacks::bishop(square, occupied);
+        case PieceType::ROOK:   return Attacks::rook(square, occupied);
+        default:                return Attacks::queen(square, occupied);
+    }
+}
+
+// Terms for one side: its pieces' mobility and pressure on the enemy king,
+// minus the weaknesses around its own king. Mobility is also added to
+// counts (signed by side) when it isn't null.
+POPCNT_CLONES
+Mobility::Score evaluateSide(const uint64_t pieces[2][6], uint64_t occupied, int side, int* counts = nullptr) {
+    const uint64_t* own = pieces[side];
+    const uint64_t* enemy = pieces[1 - side];
+    const int PAWN = static_cast<int>(PieceType::PAWN);
+    const int KING = static_cast<int>(PieceType::KING);
+
+    uint64_t ownPieces = 0;
+    for (int type = 0; type < 6; ++type) ownPieces |= own[type];
+    uint64_t enemyPawnAttacks = Attacks::pawns(enemy[PAWN], side == 0 ? Color::BLACK : Color::WHITE);
+    uint64_t safe = ~ownPieces & ~enemyPawnAttacks;
+
+    uint64_t enemyKing = enemy[KING];
+    uint64_t kingZone = enemyKing ? Attacks::king(__builtin_ctzll(enemyKing)) | enemyKing : 0;
+
+    Mobility::Score score = {0, 0};
+    int attackers = 0;
+    int attackUnits = 0;
+
+    for (PieceType type : MOBILE_PIECES) {
+        int index = static_cast<int>(type);
+        uint64_t remaining = own[index];
+        while (remaining) {
+            int square = __builtin_ctzll(remaining);
+            remaining &= remaining - 1;
+
+            uint64_t attacks = attacksFrom(type, square, occupied);
+            int mobility = Attacks::count(attacks & safe) - Mobility::BASELINE[index];
+            score.midgame += mobility * Mobility::MIDGAME_WEIGHT[index];
+            score.endgame += mobility * Mobility::ENDGAME_WEIGHT[index];
+            if (counts) counts[index] += side == 0 ? mobility : -mobility;
+
+            uint64_t zoneHits = attacks & kingZone;
+            if (zoneHits) {
+                ++attackers;
+                attackUnits += Attacks::count(zoneHits) * Mobility::KING_ATTACK_WEIGHT[index];
+            }
+        }
+    }
+
+    // A lone attacker is rarely dangerous
+    if (attackers >= 2) {
+        score.midgame += Mobility::kingDanger(attackUnits);
+    }
+
+    // Files without pawns on and next to our own king, whatever enemy
+    // pieces are left to use them (the term is midgame only, so it fades
+    // with the material)
+    uint64_t ownKing = own[KING];
+    if (ownKing) {
+        int kingCol = __builtin_ctzll(ownKing) % 8;
+        uint64_t ownPawns = own[PAWN];
+        uint64_t allPawns = ownPawns | enemy[PAWN];
+        for (int col = std::max(0, kingCol - 1); col <= std::min(7, kingCol + 1); ++col) {
+            uint64_t file = Attacks::fileMask(col);
+            if (!(allPawns & file)) {
+                score.midgame -= Mobility::OPEN_FILE_PENALTY;
+            } else if (!(ownPawns & file)) {
+                score.midgame -= Mobility::SEMI_OPEN_FILE_PENALTY;
+            }
+        }
+    }
+
+    return score;
+}
+
+} // namespace
+
+namespace Mobility {
+
+Score evaluate(const uint64_t pieces[2][6]) {
+    uint64_t occupied = 0;
+    for (int type = 0; type < 6; ++type) occupied |= pieces[0][type] | pieces[1][type];
+    
+    Score white = evaluateSide(pieces, occupied, 0);
+    Score black = evaluateSide(pieces, occupied, 1);
+    return Score{white.midgame - black.midgame, white.endgame - black.endgame};
+}
+
+Terms terms(const uint64_t pieces[2][6]) {
+    uint64_t occupied = 0;
+    for (int type = 0; type < 6; ++type) occupied |= pieces[0][type] | pieces[1][type];
+
+    Terms terms = {};
+    Score white = evaluateSide(pieces, occupied, 0, terms.mobility);
+    Score black = evaluateSide(pieces, occupied, 1, terms.mobility);
+    terms.kingSafety = Score{white.midgame - black.midgame, white.endgame - black.endgame};
+    for (int type = 0; type < 6; ++type) {
+        terms.kingSafety.midgame -= terms.mobility[type] * MIDGAME_WEIGHT[type];
+        terms.kingSafety.endgame -= terms.mobility[type] * ENDGAME_WEIGHT[type];
+    }
+    return terms;
+}
+
+Score evaluate(const Board& board) {
+    uint64_t pieces[2][6];
+    for (int type = 0; type < 6; ++type) {
+        pieces[0][type] = board.getPieceBitboard(Color::WHITE, static_cast<PieceType>(type));
+        pieces[1][type] = board.getPieceBitboard(Color::BLACK, static_cast<PieceType>(type));
+    }
+    return evaluate(pieces);
+}
+
+} // namespace Mobility
@@ -0,0 +1,318 @@
+#include "../include/MoveGen.h"
+#include "../include/Attacks.h"
+#include <cstdlib>
+
+namespace {
+
+const int KINGSIDE = 0;
+const int QUEENSIDE = 1;
+const PieceType PROMOTIONS[4] = {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT};
+
+inline uint64_t bit(int square) { return 1ULL << square; }
+inline int lowest(uint64_t bits) { return __builtin_ctzll(bits); }
+inline int index(PieceType type) { return static_cast<int>(type); }
+
+// Own pieces standing alone between our king and an enemy slider
+uint64_t pinnedPieces(const MoveGen::Position& position, int kingSquare) {
+    const int us = position.side;
+    const uint64_t* enemy = position.pieces[1 - us];
+    uint64_t occupied = position.occupied();
+    uint64_t queens = enemy[index(PieceType::QUEEN)];
+    uint64_t rooks = Attacks::rook(kingSquare, 0) & (enemy[index(PieceType::ROOK)] | queens);
+    uint64_t bishops = Attacks::bishop(kingSquare, 0) & (enemy[index(PieceType::BISHOP)] | queens);
+
+    uint64_t pinned = 0;
+    for (uint64_t snipers = rooks | bishops; snipers; snipers &= snipers - 1) {
+        int sniper = lowest(snipers);
+        uint64_t between = (rooks & bit(sniper))
+            ? Attacks::rook(kingSquare, bit(sniper)) & Attacks::rook(sniper, bit(kingSquare))
+            : Attacks::bishop(kingSquare, bit(sniper)) & Attacks::bishop(sniper, bit(kingSquare));
+        between &= occupied;
+        if (between && !(between & (between - 1))) pinned |= between & position.colors[us];  // Exactly one piece
+    }
+    return pinned;
+}
+
+// Collects legal moves; with firstOnly it stops at the first one
+struct Generator {
+    const MoveGen::Position& position;
+    MoveGen::MoveList* moves;
+    bool firstOnly;
+    bool found = false;
+    int kingSquare = -1;
+    bool inCheck = false;
+    uint64_t pinned = 0;
+
+    Generator(const MoveGen::Position& position, MoveGen::MoveList* moves, bool firstOnly)
+        : position(position), moves(moves), firstOnly(firstOnly) {
+        uint64_t king = position.pieces[position.side][index(PieceType::KING)];
+        if (king != 0) {
+            kingSquare = lowest(king);
+            inCheck = position.isAttacked(kingSquare, 1 - position.side);
+            pinned = pinnedPieces(position, kingSquare);
+        }
+    }
+
+    bool done() const { return firstOnly && found; }
+
+    // Out of check, only king moves, pinned pieces and en passant (which
+    // empties two squares on the king's rank) can expose the king
+    bool needsTest(int from, bool enPassant) const {
+        return inCheck || enPassant || from == kingSquare || (pinned & bit(from));
+    }
+
+    void keep(const Move& move) {
+        found = true;
+        if (moves) moves->add(move);
+    }
+
+    // Keep the move if it doesn't leave our king attacked
+    void tryMove(const Move& move) {
+        MoveGen::Position after = position;
+        after.play(move);
+        uint64_t king = after.pieces[position.side][index(PieceType::KING)];
+        if (king != 0 && after.isAttacked(lowest(king), 1 - position.side)) return;
+        keep(move);
+    }
+
+    void add(int from, int to, bool capture, bool enPassant = false) {
+        Move move(from / 8, from % 8, to / 8, to % 8);
+        move.isCapture = capture;
+        move.isEnPassant = enPassant;
+        if (needsTest(from, enPassant)) tryMove(move);
+        else keep(move);
+    }
+
+    void addPawn(int from, int to, bool capture) {
+        int lastRow = position.side == 0 ? 0 : 7;
+        if (to / 8 != lastRow) {
+            add(from, to, capture);
+            return;
+        }
+        for (PieceType promotion : PROMOTIONS) {
+            Move move(from / 8, from % 8, to / 8, to % 8);
+            move.isCapture = capture;
+            move.promotionPiece = promotion;
+            if (needsTest(from, false)) tryMove(move);
+            else keep(move);
+            if (done()) return;
+        }
+    }
+
+    void pieces(PieceType type, uint64_t targets) {
+        const int us = position.side;
+        uint64_t occupied = position.occupied();
+        uint64_t enemy = position.colors[1 - us];
+        for (uint64_t from = position.pieces[us][index(type)]; from && !done(); from &= from - 1) {
+            int square = lowest(from);
+            uint64_t attacks = 0;
+            switch (type) {
+                case PieceType::KNIGHT: attacks = Attacks::knight(square); break;
+                case PieceType::BISHOP: attacks = Attacks::bishop(square, occupied); break;
+                case PieceType::ROOK:   attacks = Attacks::rook(square, occupied); break;
+                case PieceType::QUEEN:  attacks = Attacks::queen(square, occupied); break;
+                case PieceType::KING:   attacks = Attacks::king(square); break;
+                default: break;
+            }
+            for (uint64_t to = attacks & ~position.colors[us] & targets; to && !done(); to &= to - 1) {
+                int target = lowest(to);
+                add(square, target, (enemy & bit(target)) != 0);
+            }
+        }
+    }
+
+    void pawns(uint64_t targets) {
+        const int us = position.side;
+        const Color color = us == 0 ? Color::WHITE : Color::BLACK;
+        const int forward = us == 0 ? -8 : 8;
+        const int startRow = us == 0 ? 6 : 1;
+        const int enPassantRow = us == 0 ? 3 : 4;
+        uint64_t occupied = position.occupied();
+        uint64_t enemy = position.colors[1 - us];
+
+        for (uint64_t from = position.pieces[us][index(PieceType::PAWN)]; from && !done(); from &= from - 1) {
+            int square = lowest(from);
+            int row = square / 8;
+            int col = square % 8;
+
+            int single = square + forward;
+            if (single < 0 || single >= 64) continue;  // A pawn on its last rank, from a FEN
+            if (!(occupied & bit(single))) {
+                if (targets & bit(single)) addPawn(square, single, false);
+                int twice = single + forward;
+                if (row == startRow && !(occupied & bit(twice)) && (targets & bit(twice))) {
+                    add(square, twice, false);
+                }
+            }
+
+            for (uint64_t to = Attacks::pawns(bit(square), color) & enemy & targets; to && !done(); to &= to - 1) {
+                addPawn(square, lowest(to), true);
+            }
+
+            // Board's rule: onto the empty square behind the last double step
+            if (position.enPassantCol >= 0 && row == enPassantRow && std::abs(col - position.enPassantCol) == 1) {
+                int to = square + forward + (position.enPassantCol - col);
+                if (!(occupied & bit(to)) && (targets & bit(to)) && !done()) add(square, to, true, true);
+            }
+        }
+    }
+
+    // Rights, the rook at home, nothing between king and rook, and no
+    // attacked square from the king's start to its destination
+    void castling(uint64_t targets) {
+        const int us = position.side;
+        const int homeRow = us == 0 ? 7 : 0;
+        const int kingSquare = homeRow * 8 + 4;
+        if (!(position.pieces[us][index(PieceType::KING)] & bit(kingSquare))) return;
+
+        uint64_t occupied = position.occupied();
+        for (int wing = KINGSIDE; wing <= QUEENSIDE && !done(); ++wing) {
+            if (!position.castling[us][wing]) continue;
+            int rookCol = wing == KINGSIDE ? 7 : 0;
+            int toCol = wing == KINGSIDE ? 6 : 2;
+            int step = wing == KINGSIDE ? 1 : -1;
+            if (!(targets & bit(homeRow * 8 + toCol))) continue;
+            if (!(position.pieces[us][index(PieceType::ROOK)] & bit(homeRow * 8 + rookCol))) continue;
+
+            bool clear = true;
+            for (int col = 4 + step; col != rookCol && clear; col += step) {
+                clear = !(occupied & bit(homeRow * 8 + col));
+            }
+            for (int col = 4; col != toCol + step && clear; col += step) {
+                clear = !position.isAttacked(homeRow * 8 + col, 1 - us);
+            }
+            if (!clear) continue;
+
+            Move move(homeRow, 4, homeRow, toCol);
+            move.isCastling = true;
+            keep(move);
+        }
+    }
+
+    void run(uint64_t targets) {
+        pawns(targets);
+        pieces(PieceType::KNIGHT, targets);
+        pieces(PieceType::BISHOP, targets);
+        pieces(PieceType::ROOK, targets);
+        pieces(PieceType::QUEEN, targets);
+        pieces(PieceType::KING, targets);
+        if (!done()) castling(targets);
+    }
+};
+
+} // namespace
+
+namespace MoveGen {
+
+Position::Position(const Board& board) {
+    for (int side = 0; side < 2; ++side) {
+        Color color = side == 0 ? Color::WHITE : Color::BLACK;
+        for (int type = 0; type < 6; ++type) {
+            pieces[side][type] = board.getPieceBitboard(color, static_cast<PieceType>(type));
+        }
+        colors[side] = board.getColorBitboard(color);
+    }
+    const GameState& state = board.getGameState();
+    side = state.currentPlayer == Color::WHITE ? 0 : 1;
+    enPassantCol = state.enPassantCol;
+    castling[0][KINGSIDE] = state.whiteCanCastleKingside;
+    castling[0][QUEENSIDE] = state.whiteCanCastleQueenside;
+    castling[1][KINGSIDE] = state.blackCanCastleKingside;
+    castling[1][QUEENSIDE] = state.blackCanCastleQueenside;
+}
+
+PieceType Position::pieceOn(int square) const {
+    uint64_t mask = bit(square);
+    int owner = (colors[0] & mask) ? 0 : (colors[1] & mask) ? 1 : -1;
+    if (owner < 0) return PieceType::EMPTY;
+    for (int type = 0; type < 6; ++type) {
+        if (pieces[owner][type] & mask) return static_cast<PieceType>(type);
+    }
+    return PieceType::EMPTY;
+}
+
+bool Position::isAttacked(int square, int bySide) const {
+    const uint64_t* attacker = pieces[bySide];
+    uint64_t occupied = this->occupied();
+    Color defender = bySide == 0 ? Color::BLACK : Color::WHITE;
+    if (Attacks::pawns(bit(square), defender) & attacker[index(PieceType::PAWN)]) return true;
+    if (Attacks::knight(square) & attacker[index(PieceType::KNIGHT)]) return true;
+    if (Attacks::king(square) & attacker[index(PieceType::KING)]) return true;
+    uint64_t queens = attacker[index(PieceType::QUEEN)];
+    if (Attacks::bishop(square, occupied) & (attacker[index(PieceType::BISHOP)] | queens)) return true;
+    return (Attacks::rook(square, occupied) & (attacker[index(PieceType::ROOK)] | queens)) != 0;
+}
+
+bool Position::inCheck() const {
+    uint64_t king = pieces[side][index(PieceType::KING)];
+    return king != 0 && isAttacked(lowest(king), 1 - side);
+}
+
+void Position::play(const Move& move) {
+    const int us = side;
+    const int them = 1 - us;
+    int from = move.fromRow * 8 + move.fromCol;
+    int to = move.toRow * 8 + move.toCol;
+    PieceType moving = pieceOn(from);
+    PieceType captured = (colors[them] & bit(to)) ? pieceOn(to) : PieceType::EMPTY;
+    int homeRow = us == 0 ? 7 : 0;
+    int theirHomeRow = us == 0 ? 0 : 7;
+
+    if (captured != PieceType::EMPTY) {
+        pieces[them][index(captured)] &= ~bit(to);
+        colors[them] &= ~bit(to);
+        if (captured == PieceType::ROOK && move.toRow == theirHomeRow) {
+            if (move.toCol == 7) castling[them][KINGSIDE] = false;
+            if (move.toCol == 0) castling[them][QUEENSIDE] = false;
+        }
+    } else if (moving == PieceType::PAWN && move.fromCol != move.toCol) {
+        int square = move.fromRow * 8 + move.toCol;  // En passant: the pawn beside us
+        pieces[them][index(PieceType::PAWN)] &= ~bit(square);
+        colors[them] &= ~bit(square);
+    }
+
+    uint64_t fromTo = bit(from) | bit(to);
+    colors[us] ^= fromTo;
+    pieces[us][index(moving)] ^= fromTo;
+
+    enPassantCol = -1;
+    if (moving == PieceType::PAWN) {
+        if (move.toRow == theirHomeRow) {
+            PieceType promotion = move.promotionPiece;
+            if (promotion != PieceType::ROOK && promotion != PieceType::BISHOP && promotion != PieceType::KNIGHT) {
+                promotion = PieceType::QUEEN;
+            }
+            pieces[us][index(PieceType::PAWN)] &= ~bit(to);
+            pieces[us][index(promotion)] |= bit(to);
+        } else if (std::abs(move.toRow - move.fromRow) == 2) {
+            enPassantCol = move.fromCol;
+        }
+    } else if (moving == PieceType::KING) {
+        castling[us][KINGSIDE] = false;
+        castling[us][QUEENSIDE] = false;
+        if (std::abs(move.toCol - move.fromCol) == 2) {
+            bool kingside = move.toCol > move.fromCol;
+            uint64_t rook = bit(homeRow * 8 + (kingside ? 7 : 0)) | bit(homeRow * 8 + (kingside ? 5 : 3));
+            pieces[us][index(PieceType::ROOK)] ^= rook;
+            colors[us] ^= rook;
+        }
+    } else if (moving == PieceType::ROOK && move.fromRow == homeRow) {
+        if (move.fromCol == 7) castling[us][KINGSIDE] = false;
+        if (move.fromCol == 0) castling[us][QUEENSIDE] = false;
+    }
+
+    side = them;
+}
+
+void generate(const Position& position, MoveList& moves, uint64_t targets) {
+    moves.count = 0;
+    Generator(position, &moves, false).run(targets);
+}
+
+bool hasLegalMove(const Position& position) {
+    Generator generator(position, nullptr, true);
+    generator.run(~0ULL);
+    return generator.found;
+}
+
+} // namespace MoveGen
@@ -0,0 +1,371 @@
+#include "../include/Nnue.h"
+#include "../include/Zobrist.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NNUE_X86 1
+#endif
+
+namespace {
+
+// Sections start on 64-byte boundaries so the mapped weights are aligned
+size_t padded(size_t bytes) {
+    return (bytes + 63) & ~static_cast<size_t>(63);
+}
+
+struct FileHeader {
+    char magic[8];
+    uint32_t hiddenSize;
+    uint32_t outputHidden;
+    int32_t outputDivisor;
+    uint8_t padding[44];
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader is the file format");
+
+int sideIndex(Color color) {
+    return color == Color::WHITE ? 0 : 1;
+}
+
+// ---- Inner loops. Sizes are multiples of 32. ----
+
+void addRowScalar(int16_t* values, const int16_t* row, int size) {
+    for (int i = 0; i < size; ++i) values[i] = static_cast<int16_t>(values[i] + row[i]);
+}
+
+void subRowScalar(int16_t* values, const int16_t* row, int size) {
+    for (int i = 0; i < size; ++i) values[i] = static_cast<int16_t>(values[i] - row[i]);
+}
+
+void clipScalar(const int16_t* values, uint8_t* out, int size) {
+    for (int i = 0; i < size; ++i) {
+        out[i] = static_cast<uint8_t>(std::min<int>(std::max<int>(values[i], 0), 127));
+    }
+}
+
+int32_t dotScalar(const uint8_t* input, const int8_t* weights, int size) {
+    int32_t sum = 0;
+    for (int i = 0; i < size; ++i) sum += input[i] * weights[i];
+    return sum;
+}
+
+#ifdef NNUE_X86
+__attribute__((target("avx2")))
+void addRowAvx2(int16_t* values, const int16_t* row, int size) {
+    for (int i = 0; i < size; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), _mm256_add_epi16(v, w));
+    }
+}
+
+__attribute__((target("avx2")))
+void subRowAvx2(int16_t* values, const int16_t* row, int size) {
+    for (int i = 0; i < size; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), _mm256_sub_epi16(v, w));
+    }
+}
+
+__attribute__((target("avx2")))
+void clipAvx2(const int16_t* values, uint8_t* out, int size) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i limit = _mm256_set1_epi16(127);
+    for (int i = 0; i < size; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 16));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), limit);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), limit);
+        // packus works per 128-bit lane; put the quarters back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+}
+
+__attribute__((target("avx2")))
+int32_t dotAvx2(const uint8_t* input, const int8_t* weights, int size) {
+    // Inputs are at most 127, so the pairwise int16 sums can't saturate
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < size; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+struct Kernels {
+    Nnue::Kernel kind;
+    void (*addRow)(int16_t*, const int16_t*, int);
+    void (*subRow)(int16_t*, const int16_t*, int);
+    void (*clip)(const int16_t*, uint8_t*, int);
+    int32_t (*dot)(const uint8_t*, const int8_t*, int);
+};
+
+const Kernels SCALAR_KERNELS = {Nnue::Kernel::SCALAR, addRowScalar, subRowScalar, clipScalar, dotScalar};
+#ifdef NNUE_X86
+const Kernels AVX2_KERNELS = {Nnue::Kernel::AVX2, addRowAvx2, subRowAvx2, clipAvx2, dotAvx2};
+#endif
+
+Kernels bestKernels() {
+#ifdef NNUE_X86
+    if (Nnue::avx2Supported()) return AVX2_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+Kernels kernels = bestKernels();
+
+} // namespace
+
+namespace Nnue {
+
+bool avx2Supported() {
+#ifdef NNUE_X86
+    __builtin_cpu_init();  // Needed when called during static initialization
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+Kernel getKernel() {
+    return kernels.kind;
+}
+
+// Not thread-safe; meant to be called before any search starts
+bool setKernel(Kernel kernel) {
+    if (kernel == Kernel::SCALAR) {
+        kernels = SCALAR_KERNELS;
+        return true;
+    }
+#ifdef NNUE_X86
+    if (avx2Supported()) {
+        kernels = AVX2_KERNELS;
+        return true;
+    }
+#endif
+    return false;
+}
+
+const char* kernelName(Kernel kernel) {
+    return kernel == Kernel::AVX2 ? "avx2" : "scalar";
+}
+
+int featureIndex(Color perspective, int kingSquare, const Piece& piece, int square) {
+    int kind = 0;
+    switch (piece.getType()) {
+        case PieceType::PAWN:   kind = 0; break;
+        case PieceType::KNIGHT: kind = 1; break;
+        case PieceType::BISHOP: kind = 2; break;
+        case PieceType::ROOK:   kind = 3; break;
+        case PieceType::QUEEN:  kind = 4; break;
+        default:                break;  // Kings aren't features
+    }
+    kind = kind * 2 + (piece.getColor() == perspective ? 0 : 1);
+
+    if (perspective == Color::BLACK) {
+        kingSquare ^= 56;
+        square ^= 56;
+    }
+    return (kingSquare * PIECE_KINDS + kind) * 64 + square;
+}
+
+const char Network::MAGIC[8] = {'C', 'C', 'N', 'N', 'U', 'E', '1', '\0'};
+
+Network::Network()
+    : hiddenSize(0), outputHidden(0), outputDivisor(1), featureBiases(nullptr), featureWeights(nullptr),
+      hiddenBiases(nullptr), hiddenWeights(nullptr), outputBias(0), outputWeights(nullptr) {}
+
+bool Network::load(const std::string& path) {
+    hiddenSize = 0;
+    if (!file.open(path) || file.size() < sizeof(FileHeader)) return false;
+
+    FileHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.hiddenSize == 0 || header.hiddenSize % 32 != 0 || header.hiddenSize > MAX_HIDDEN ||
+        header.outputHidden == 0 || header.outputHidden > MAX_OUTPUT_HIDDEN || header.outputDivisor <= 0) {
+        return false;
+    }
+
+    size_t hidden = header.hiddenSize;
+    size_t outputs = header.outputHidden;
+    size_t offsets[6];
+    size_t sizes[6] = {
+        hidden * sizeof(int16_t),
+        static_cast<size_t>(INPUT_SIZE) * hidden * sizeof(int16_t),
+        outputs * sizeof(int32_t),
+        outputs * 2 * hidden,
+        sizeof(int32_t),
+        outputs,
+    };
+    size_t offset = sizeof(FileHeader);
+    for (int i = 0; i < 6; ++i) {
+        offsets[i] = offset;
+        offset += padded(sizes[i]);
+    }
+    if (file.size() != offset) return false;
+
+    const uint8_t* data = file.getData();
+    hiddenSize = static_cast<int>(hidden);
+    outputHidden = static_cast<int>(outputs);
+    outputDivisor = header.outputDivisor;
+    featureBiases = reinterpret_cast<const int16_t*>(data + offsets[0]);
+    featureWeights = reinterpret_cast<const int16_t*>(data + offsets[1]);
+    hiddenBiases = reinterpret_cast<const int32_t*>(data + offsets[2]);
+    hiddenWeights = reinterpret_cast<const int8_t*>(data + offsets[3]);
+    std::memcpy(&outputBias, data + offsets[4], sizeof(outputBias));
+    outputWeights = reinterpret_cast<const int8_t*>(data + offsets[5]);
+    return true;
+}
+
+void Network::refreshSide(Accumulator& accumulator, const Board& board, Color perspective) const {
+    int side = sideIndex(perspective);
+    int16_t* values = accumulator.values[side];
+    std::memcpy(values, featureBiases, hiddenSize * sizeof(int16_t));
+
+    int kingSquare = 0;
+    for (int square = 0; square < 64; ++square) {
+        const Piece& piece = board.getPiece(square / 8, square % 8);
+        if (piece.getType() == PieceType::KING && piece.getColor() == perspective) {
+            kingSquare = square;
+        }
+    }
+    accumulator.kingSquare[side] = kingSquare;
+
+    for (int square = 0; square < 64; ++square) {
+        const Piece& piece = board.getPiece(square / 8, square % 8);
+        if (piece.isEmpty() || piece.getType() == PieceType::KING) continue;
+
+        size_t feature = featureIndex(perspective, kingSquare, piece, square);
+        kernels.addRow(values, featureWeights + feature * hiddenSize, hiddenSize);
+    }
+}
+
+void Network::refresh(Accumulator& accumulator, const Board& board) const {
+    refreshSide(accumulator, board, Color::WHITE);
+    refreshSide(accumulator, board, Color::BLACK);
+}
+
+void Network::update(Accumulator& accumulator, const Accumulator& parent, const Board& board) const {
+    const SquareChange* changes;
+    int count;
+    if (!board.getLastChanges(changes, count)) {
+        refresh(accumulator, board);
+        return;
+    }
+
+    for (Color perspective : {Color::WHITE, Color::BLACK}) {
+        int side = sideIndex(perspective);
+
+        // Every feature depends on the own king's square
+        bool kingMoved = false;
+        for (int i = 0; i < count; ++i) {
+            for (const Piece* piece : {&changes[i].removed, &changes[i].added}) {
+                if (piece->getType() == PieceType::KING && piece->getColor() == perspective) {
+                    kingMoved = true;
+                }
+            }
+        }
+        if (kingMoved) {
+            refreshSide(accumulator, board, perspective);
+            continue;
+        }
+
+        int16_t* values = accumulator.values[side];
+        int kingSquare = parent.kingSquare[side];
+        std::memcpy(values, parent.values[side], hiddenSize * sizeof(int16_t));
+        accumulator.kingSquare[side] = kingSquare;
+
+        for (int i = 0; i < count; ++i) {
+            const SquareChange& change = changes[i];
+            if (!change.removed.isEmpty() && change.removed.getType() != PieceType::KING) {
+                size_t feature = featureIndex(perspective, kingSquare, change.removed, change.square);
+                kernels.subRow(values, featureWeights + feature * hiddenSize, hiddenSize);
+            }
+            if (!change.added.isEmpty() && change.added.getType() != PieceType::KING) {
+                size_t feature = featureIndex(perspective, kingSquare, change.added, change.square);
+                kernels.addRow(values, featureWeights + feature * hiddenSize, hiddenSize);
+            }
+        }
+    }
+}
+
+int Network::evaluate(const Accumulator& accumulator, Color sideToMove) const {
+    alignas(32) uint8_t input[2 * MAX_HIDDEN];
+    int us = sideIndex(sideToMove);
+    kernels.clip(accumulator.values[us], input, hiddenSize);
+    kernels.clip(accumulator.values[1 - us], input + hiddenSize, hiddenSize);
+
+    int32_t output = outputBias;
+    for (int i = 0; i < outputHidden; ++i) {
+        int32_t sum = hiddenBiases[i] + kernels.dot(input, hiddenWeights + i * 2 * hiddenSize, 2 * hiddenSize);
+        int32_t activation = std::min(std::max(sum >> HIDDEN_SHIFT, 0), 127);
+        output += activation * outputWeights[i];
+    }
+    return output / outputDivisor;
+}
+
+int Network::evaluate(const Board& board) const {
+    Accumulator accumulator;
+    refresh(accumulator, board);
+    return evaluate(accumulator, board.getGameState().currentPlayer);
+}
+
+bool writeRandomNetwork(const std::string& path, int hiddenSize, int outputHidden, uint32_t seed) {
+    if (hiddenSize <= 0 || hiddenSize % 32 != 0 || hiddenSize > MAX_HIDDEN ||
+        outputHidden <= 0 || outputHidden > MAX_OUTPUT_HIDDEN) {
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Network::MAGIC, sizeof(header.magic));
+    header.hiddenSize = hiddenSize;
+    header.outputHidden = outputHidden;
+    header.outputDivisor = 64;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Small enough that 30 pieces can't overflow the int16 accumulator
+    std::mt19937 rng(seed);
+    auto section = [&](size_t count, size_t elementSize, int limit) {
+        std::uniform_int_distribution<int> dist(-limit, limit);
+        std::vector<char> bytes(padded(count * elementSize), 0);
+        for (size_t i = 0; i < count; ++i) {
+            int32_t value = dist(rng);
+            if (elementSize == 1) {
+                bytes[i] = static_cast<char>(value);
+            } else if (elementSize == 2) {
+                int16_t narrow = static_cast<int16_t>(value);
+                std::memcpy(&bytes[i * 2], &narrow, 2);
+            } else {
+                std::memcpy(&bytes[i * 4], &value, 4);
+            }
+        }
+        out.write(bytes.data(), bytes.size());
+    };
+
+    section(hiddenSize, 2, 32);
+    section(static_cast<size_t>(INPUT_SIZE) * hiddenSize, 2, 16);
+    section(outputHidden, 4, 256);
+    section(static_cast<size_t>(outputHidden) * 2 * hiddenSize, 1, 64);
+    section(1, 4, 64);
+    section(outputHidden, 1, 32);
+    return static_cast<bool>(out);
+}
+
+} // namespace Nnue
@@ -0,0 +1,175 @@
+#include "../include/Notation.h"
+#include "../include/MoveGen.h"
+#include "../include/Utils.h"
+#include "../include/Zobrist.h"
+#include <cctype>
+#include <cstdlib>
+
+namespace Notation {
+
+PieceType pieceFromLetter(char letter) {
+    switch (letter) {
+        case 'K': return PieceType::KING;
+        case 'Q': return PieceType::QUEEN;
+        case 'R': return PieceType::ROOK;
+        case 'B': return PieceType::BISHOP;
+        case 'N': return PieceType::KNIGHT;
+        default:  return PieceType::EMPTY;
+    }
+}
+
+bool fromSAN(const Board& board, std::string_view san, Move& move) {
+    // Drop surrounding space, check/mate markers and annotation glyphs ("Nf3+", "e4!?")
+    while (!san.empty() && std::isspace(static_cast<unsigned char>(san.front()))) san.remove_prefix(1);
+    while (!san.empty() && (std::isspace(static_cast<unsigned char>(san.back())) || san.back() == '+' ||
+                            san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+    if (san.empty()) return false;
+    
+    MoveGen::Position position(board);
+    MoveGen::MoveList moves;
+    int homeRow = (position.side == 0) ? 7 : 0;
+    
+    // Castling (PGN uses the letter O, some files use zeros)
+    bool kingside = san == "O-O" || san == "0-0";
+    if (kingside || san == "O-O-O" || san == "0-0-0") {
+        MoveGen::generate(position, moves, 1ULL << Zobrist::squareIndex(homeRow, kingside ? 6 : 2));
+        for (const Move& candidate : moves) {
+            if (candidate.isCastling) {
+                move = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Piece letter (pawns have none)
+    PieceType pieceType = pieceFromLetter(san[0]);
+    size_t start = 0;
+    if (pieceType == PieceType::EMPTY) {
+        pieceType = PieceType::PAWN;
+    } else {
+        start = 1;
+    }
+    
+    // Promotion suffix: "e8=Q" or "e8Q"
+    PieceType promotion = PieceType::EMPTY;
+    size_t end = san.size();
+    if (pieceType == PieceType::PAWN && end >= 2) {
+        PieceType suffix = pieceFromLetter(san[end - 1]);
+        if (suffix != PieceType::EMPTY && suffix != PieceType::KING) {
+            promotion = suffix;
+            end -= (san[end - 2] == '=') ? 2 : 1;
+        }
+    }
+    
+    // The destination square is always the last two characters
+    if (end < start + 2) return false;
+    char toFile = san[end - 2];
+    char toRank = san[end - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') return false;
+    int toRow = ChessUtils::rankToRow(toRank);
+    int toCol = ChessUtils::fileToCol(toFile);
+    
+    // Anything in between is disambiguation and the capture marker
+    int fromRow = -1;
+    int fromCol = -1;
+    for (size_t i = start; i < end - 2; ++i) {
+        char c = san[i];
+        if (c >= 'a' && c <= 'h') {
+            fromCol = ChessUtils::fileToCol(c);
+        } else if (c >= '1' && c <= '8') {
+            fromRow = ChessUtils::rankToRow(c);
+        } else if (c != 'x' && c != ':' && c != '-') {
+            return false;
+        }
+    }
+    
+    // Exactly one legal move to the square by a piece of the right kind
+    MoveGen::generate(position, moves, 1ULL << Zobrist::squareIndex(toRow, toCol));
+    PieceType wanted = (promotion == PieceType::EMPTY) ? PieceType::QUEEN : promotion;
+    int matches = 0;
+    for (const Move& candidate : moves) {
+        if (candidate.isCastling) continue;
+        if (fromRow != -1 && candidate.fromRow != fromRow) continue;
+        if (fromCol != -1 && candidate.fromCol != fromCol) continue;
+        if (position.pieceOn(Zobrist::squareIndex(candidate.fromRow, candidate.fromCol)) != pieceType) continue;
+        if (candidate.promotionPiece != PieceType::EMPTY && candidate.promotionPiece != wanted) continue;
+        move = candidate;
+        ++matches;
+    }
+    
+    return matches == 1;
+}
+
+std::string toSAN(const Board& board, const Move& move) {
+    MoveGen::Position position(board);
+    int from = Zobrist::squareIndex(move.fromRow, move.fromCol);
+    int to = Zobrist::squareIndex(move.toRow, move.toCol);
+    PieceType type = position.pieceOn(from);
+    std::string san;
+    
+    if (type == PieceType::KING && std::abs(move.toCol - move.fromCol) == 2) {
+        san = (move.toCol > move.fromCol) ? "O-O" : "O-O-O";
+    } else {
+        bool capture = position.pieceOn(to) != PieceType::EMPTY ||
+                       (type == PieceType::PAWN && move.fromCol != move.toCol);
+        
+        if (type == PieceType::PAWN) {
+            if (capture) san += ChessUtils::colToFile(move.fromCol);
+        } else {
+            san += "PRNBQK"[static_cast<int>(type)];
+            
+            // Other pieces of the same kind with a legal move to the square
+            MoveGen::MoveList moves;
+            MoveGen::generate(position, moves, 1ULL << to);
+            bool ambiguous = false;
+            bool sameFile = false;
+            bool sameRank = false;
+            for (const Move& other : moves) {
+                if (other.fromRow == move.fromRow && other.fromCol == move.fromCol) continue;
+                if (position.pieceOn(Zobrist::squareIndex(other.fromRow, other.fromCol)) != type) continue;
+                
+                ambiguous = true;
+                if (other.fromCol == move.fromCol) sameFile = true;
+                if (other.fromRow == move.fromRow) sameRank = true;
+            }
+            if (ambiguous) {
+                if (!sameFile) {
+                    san += ChessUtils::colToFile(move.fromCol);
+                } else if (!sameRank) {
+                    san += ChessUtils::rowToRank(move.fromRow);
+                } else {
+                    san += ChessUtils::colToFile(move.fromCol);
+                    san += ChessUtils::rowToRank(move.fromRow);
+                }
+            }
+        }
+        
+        if (capture) san += 'x';
+        san += ChessUtils::colToFile(move.toCol);
+        san += ChessUtils::rowToRank(move.toRow);
+        
+        int lastRow = (position.side == 0) ? 0 : 7;
+        if (type == PieceType::PAWN && move.toRow == lastRow) {
+            PieceType promotion = move.promotionPiece;
+            if (promotion != PieceType::ROOK && promotion != PieceType::BISHOP &&
+                promotion != PieceType::KNIGHT) {
+                promotion = PieceType::QUEEN;
+            }
+            san += '=';
+            san += "PRNBQK"[static_cast<int>(promotion)];
+        }
+    }
+    
+    // Check or mate after the move
+    position.play(move);
+    if (position.inCheck()) {
+        san += MoveGen::hasLegalMove(position) ? '+' : '#';
+    }
+    
+    return san;
+}
+
+} // namespace Notation
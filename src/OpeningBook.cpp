@@ -0,0 +1,116 @@
+#include "../include/OpeningBook.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+const char OpeningBook::MAGIC[8] = {'C', 'C', 'B', 'O', 'O', 'K', '1', '\0'};
+
+// Load a book file into memory
+bool OpeningBook::load(const std::string& path) {
+    entries.clear();
+    
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    
+    char magic[8];
+    uint64_t count = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+        return false;
+    }
+    
+    // The header's count must match what the file holds - a corrupt one
+    // could otherwise ask for any amount of memory
+    std::streamoff headerEnd = file.tellg();
+    file.seekg(0, std::ios::end);
+    uint64_t available = static_cast<uint64_t>(file.tellg() - headerEnd) / sizeof(BookEntry);
+    file.seekg(headerEnd);
+    if (!file || count > available) {
+        return false;
+    }
+    
+    entries.resize(count);
+    file.read(reinterpret_cast<char*>(entries.data()), count * sizeof(BookEntry));
+    if (!file) {
+        entries.clear();
+        return false;
+    }
+    
+    return true;
+}
+
+// Find all entries for a position with a binary search
+std::vector<BookEntry> OpeningBook::probe(uint64_t key) const {
+    auto range = std::equal_range(entries.begin(), entries.end(), BookEntry{key, 0, 0, 0},
+        [](const BookEntry& a, const BookEntry& b) { return a.key < b.key; });
+    return std::vector<BookEntry>(range.first, range.second);
+}
+
+// Choose a book move with probability proportional to its weight
+bool OpeningBook::pickMove(const Board& board, Move& move) const {
+    std::vector<BookEntry> candidates = probe(board.getHashKey());
+    
+    // Drop moves that aren't legal here (guards against key collisions)
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+        [&board](const BookEntry& entry) {
+            return entry.weight == 0 || !board.isValidMove(decodeMove(entry.move));
+        }), candidates.end());
+    
+    if (candidates.empty()) return false;
+    
+    uint32_t totalWeight = 0;
+    for (const BookEntry& entry : candidates) {
+        totalWeight += entry.weight;
+    }
+    
+    // One generator per thread - several engines may share a book
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<uint32_t> dis(0, totalWeight - 1);
+    uint32_t pick = dis(gen);
+    
+    for (const BookEntry& entry : candidates) {
+        if (pick < entry.weight) {
+            move = decodeMove(entry.move);
+            return true;
+        }
+        pick -= entry.weight;
+    }
+    
+    move = decodeMove(candidates.back().move);
+    return true;
+}
+
+uint16_t OpeningBook::encodeMove(const Move& move) {
+    int promotion = 0;
+    switch (move.promotionPiece) {
+        case PieceType::KNIGHT: promotion = 1; break;
+        case PieceType::BISHOP: promotion = 2; break;
+        case PieceType::ROOK:   promotion = 3; break;
+        case PieceType::QUEEN:  promotion = 4; break;
+        default: break;
+    }
+    
+    int from = move.fromRow * 8 + move.fromCol;
+    int to = move.toRow * 8 + move.toCol;
+    return static_cast<uint16_t>(from | (to << 6) | (promotion << 12));
+}
+
+Move OpeningBook::decodeMove(uint16_t code) {
+    int from = code & 63;
+    int to = (code >> 6) & 63;
+    Move move(from / 8, from % 8, to / 8, to % 8);
+    
+    static const PieceType promotions[] = {
+        PieceType::EMPTY, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN
+    };
+    int promotion = (code >> 12) & 7;
+    if (promotion <= 4) move.promotionPiece = promotions[promotion];
+    
+    return move;
+}
+
+void OpeningBook::writeHeader(std::ostream& out, uint64_t entryCount) {
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(&entryCount), sizeof(entryCount));
+}
@@ -0,0 +1,107 @@
+#include "../include/PackedPosition.h"
+#include "../include/Zobrist.h"
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace PackedPositions {
+
+const char MAGIC[8] = {'C', 'C', 'P', 'A', 'C', 'K', '1', '\0'};
+
+bool pack(const Board& board, PackedPosition& packed) {
+    std::memset(&packed, 0, sizeof(packed));
+
+    int count = 0;
+    for (int square = 0; square < 64; ++square) {
+        const Piece& piece = board.getPiece(square / 8, square % 8);
+        if (piece.isEmpty()) continue;
+        if (count == 32) return false;
+
+        int code = static_cast<int>(piece.getType()) + (piece.getColor() == Color::BLACK ? BLACK_FLAG : 0);
+        packed.occupancy |= 1ULL << square;
+        packed.pieces[count / 2] |= static_cast<uint8_t>(code << (count % 2 * 4));
+        ++count;
+    }
+
+    const GameState& state = board.getGameState();
+    packed.sideToMove = state.currentPlayer == Color::WHITE ? 0 : 1;
+    packed.castling = (state.whiteCanCastleKingside ? 1 : 0) | (state.whiteCanCastleQueenside ? 2 : 0) |
+                      (state.blackCanCastleKingside ? 4 : 0) | (state.blackCanCastleQueenside ? 8 : 0);
+    packed.enPassantCol = static_cast<int8_t>(state.enPassantCol);
+    packed.halfMoveClock = static_cast<uint8_t>(state.halfMoveClock > 255 ? 255 : state.halfMoveClock);
+    packed.fullMoveNumber = static_cast<uint16_t>(state.fullMoveNumber);
+    return true;
+}
+
+// Through FEN, so the board checks the position like any other it loads
+bool unpack(const PackedPosition& packed, Board& board) {
+    char squares[64];
+    std::memset(squares, 0, sizeof(squares));
+    int count = 0;
+    for (uint64_t bits = packed.occupancy; bits; bits &= bits - 1) {
+        if (count == 32) return false;
+        int code = (packed.pieces[count / 2] >> (count % 2 * 4)) & 15;
+        int type = code & 7;
+        if (type > static_cast<int>(PieceType::KING)) return false;
+
+        char letter = "PRNBQK"[type];
+        squares[__builtin_ctzll(bits)] = (code & BLACK_FLAG) ? static_cast<char>(std::tolower(letter)) : letter;
+        ++count;
+    }
+
+    std::string fen;
+    for (int row = 0; row < 8; ++row) {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col) {
+            char letter = squares[Zobrist::squareIndex(row, col)];
+            if (!letter) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0) fen += static_cast<char>('0' + empty);
+            empty = 0;
+            fen += letter;
+        }
+        if (empty > 0) fen += static_cast<char>('0' + empty);
+        if (row < 7) fen += '/';
+    }
+
+    fen += packed.sideToMove ? " b " : " w ";
+    std::string castling;
+    if (packed.castling & 1) castling += 'K';
+    if (packed.castling & 2) castling += 'Q';
+    if (packed.castling & 4) castling += 'k';
+    if (packed.castling & 8) castling += 'q';
+    fen += castling.empty() ? "-" : castling;
+
+    if (packed.enPassantCol >= 0 && packed.enPassantCol < 8) {
+        fen += ' ';
+        fen += static_cast<char>('a' + packed.enPassantCol);
+        fen += packed.sideToMove ? '3' : '6';
+    } else {
+        fen += " -";
+    }
+    fen += " " + std::to_string(packed.halfMoveClock) + " " + std::to_string(packed.fullMoveNumber);
+    return board.loadFEN(fen);
+}
+
+void writeHeader(std::ostream& out, uint64_t count) {
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+}
+
+bool records(const MappedFile& file, const PackedPosition*& first, size_t& count) {
+    const size_t headerSize = sizeof(MAGIC) + sizeof(uint64_t);
+    if (!file.isOpen() || file.size() < headerSize) return false;
+    if (std::memcmp(file.getData(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    uint64_t stored;
+    std::memcpy(&stored, file.getData() + sizeof(MAGIC), sizeof(stored));
+    if ((file.size() - headerSize) / sizeof(PackedPosition) < stored) return false;
+
+    first = reinterpret_cast<const PackedPosition*>(file.getData() + headerSize);
+    count = static_cast<size_t>(stored);
+    return true;
+}
+
+} // namespace PackedPositions
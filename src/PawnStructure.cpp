@@ -0,0 +1,111 @@
+#include "../include/PawnStructure.h"
+#include "../include/Attacks.h"
+
+namespace {
+    const uint64_t FILE_A = 0x0101010101010101ULL;
+    
+    uint64_t fileMask(int col) {
+        return FILE_A << col;
+    }
+    
+    uint64_t adjacentFiles(int col) {
+        uint64_t mask = 0;
+        if (col > 0) mask |= fileMask(col - 1);
+        if (col < 7) mask |= fileMask(col + 1);
+        return mask;
+    }
+    
+    // Rows strictly before / after a row (row 0 is rank 8)
+    uint64_t rowsBefore(int row) {
+        return row == 0 ? 0 : (~0ULL >> (64 - row * 8));
+    }
+    
+    uint64_t rowsAfter(int row) {
+        return row == 7 ? 0 : (~0ULL << ((row + 1) * 8));
+    }
+    
+    // Terms for one side, added to terms with sign; "forward" is towards
+    // row 0 for white, row 7 for black
+    POPCNT_CLONES
+    void countSide(uint64_t ownPawns, uint64_t enemyPawns, bool white, int sign, PawnStructure::Terms& terms) {
+        for (int col = 0; col < 8; ++col) {
+            int count = Attacks::count(ownPawns & fileMask(col));
+            if (count > 1) {
+                terms.doubled += sign * (count - 1);
+            }
+        }
+        
+        uint64_t pawns = ownPawns;
+        while (pawns) {
+            int square = __builtin_ctzll(pawns);
+            pawns &= pawns - 1;
+            int row = square / 8;
+            int col = square % 8;
+            
+            uint64_t ahead = white ? rowsBefore(row) : rowsAfter(row);
+            uint64_t behindOrLevel = white ? rowsAfter(row - 1) : rowsBefore(row + 1);
+            
+            // Passed: no enemy pawn in front on this or a neighbouring file
+            if ((enemyPawns & ahead & (fileMask(col) | adjacentFiles(col))) == 0) {
+                int rank = white ? 7 - row : row;
+                terms.passed[rank] += sign;
+            }
+            
+            if ((ownPawns & adjacentFiles(col)) == 0) {
+                terms.isolated += sign;
+                continue;
+            }
+            
+            // Backward: no friendly pawn beside or behind to support it, and an
+            // enemy pawn guards the square in front
+            if ((ownPawns & adjacentFiles(col) & behindOrLevel) == 0) {
+                int stopRow = white ? row - 1 : row + 1;
+                int guardRow = white ? row - 2 : row + 2;
+                if (stopRow >= 0 && stopRow <= 7 && guardRow >= 0 && guardRow <= 7 &&
+                    (enemyPawns & adjacentFiles(col) & (0xFFULL << (guardRow * 8)))) {
+                    terms.backward += sign;
+                }
+            }
+        }
+    }
+}
+
+namespace PawnStructure {
+    const int PASSED_BONUS[8] = {0, 5, 10, 20, 35, 60, 100, 0};
+    
+    Terms terms(uint64_t whitePawns, uint64_t blackPawns) {
+        Terms terms = {};
+        countSide(whitePawns, blackPawns, true, 1, terms);
+        countSide(blackPawns, whitePawns, false, -1, terms);
+        return terms;
+    }
+    
+    int evaluate(uint64_t whitePawns, uint64_t blackPawns) {
+        Terms counts = terms(whitePawns, blackPawns);
+        int score = -counts.doubled * DOUBLED_PENALTY - counts.isolated * ISOLATED_PENALTY -
+                    counts.backward * BACKWARD_PENALTY;
+        for (int rank = 0; rank < 8; ++rank) {
+            score += counts.passed[rank] * PASSED_BONUS[rank];
+        }
+        return score;
+    }
+}
+
+PawnHashTable::PawnHashTable(size_t kilobytes) : mask(0) {
+    size_t maxEntries = (kilobytes > 0 ? kilobytes : 1) * 1024 / sizeof(Entry);
+    size_t count = 1;
+    while (count * 2 <= maxEntries) {
+        count *= 2;
+    }
+    entries.resize(count);
+    mask = count - 1;
+    clear();
+}
+
+// Key 0 is the position without pawns, whose score really is 0, so an
+// empty slot never gives a wrong answer
+void PawnHashTable::clear() {
+    for (Entry& entry : entries) {
+        entry = Entry{0, 0, 0};
+    }
+}
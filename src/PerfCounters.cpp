@@ -0,0 +1,128 @@
+#include "../include/PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+const EventConfig EVENTS[PerfCounters::EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const EventConfig& event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+#endif
+
+} // namespace
+
+bool PerfCounters::Counts::any() const {
+    for (bool counted : valid) {
+        if (counted) return true;
+    }
+    return false;
+}
+
+PerfCounters::Counts& PerfCounters::Counts::operator+=(const Counts& other) {
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        values[i] += other.values[i];
+        valid[i] = valid[i] || other.valid[i];
+    }
+    return *this;
+}
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds) fd = -1;
+
+    #ifdef __linux__
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            fds[i] = openEvent(EVENTS[i]);
+            if (fds[i] < 0 && error.empty()) {
+                error = std::string("perf_event_open: ") + std::strerror(errno);
+            }
+        }
+        if (available()) error.clear();
+    #else
+        error = "hardware counters are only read on Linux";
+    #endif
+}
+
+PerfCounters::~PerfCounters() {
+    #ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    #endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+    #ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    #endif
+}
+
+PerfCounters::Counts PerfCounters::stop() {
+    Counts counts;
+    #ifdef __linux__
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t data[3];  // Value, time enabled, time running
+            if (read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+            counts.values[i] = static_cast<double>(data[0]) * data[1] / data[2];
+            counts.valid[i] = true;
+        }
+    #endif
+    return counts;
+}
+
+const char* PerfCounters::name(Event event) {
+    switch (event) {
+        case CYCLES: return "cycles";
+        case INSTRUCTIONS: return "instructions";
+        case L1D_MISSES: return "L1d misses";
+        case LLC_MISSES: return "LLC misses";
+        case BRANCH_MISSES: return "branch misses";
+        default: return "";
+    }
+}
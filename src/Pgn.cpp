@@ -0,0 +1,192 @@
+#include "../include/Pgn.h"
+#include "../include/Utils.h"
+#include <cctype>
+#include <sstream>
+
+std::string PgnGame::getTag(const std::string& name) const {
+    for (const auto& tag : tags) {
+        if (tag.first == name) return tag.second;
+    }
+    return "";
+}
+
+PgnReader::PgnReader(std::istream& in) : input(in), commentDepth(0), variationDepth(0) {}
+
+// Read the next game from the stream
+bool PgnReader::readGame(PgnGame& game) {
+    game = PgnGame();
+    commentDepth = 0;
+    variationDepth = 0;
+    
+    bool inMovetext = false;
+    std::string line;
+    
+    while (input.peek() != std::char_traits<char>::eof()) {
+        // A tag line after movetext starts the next game (result was missing)
+        if (inMovetext && commentDepth == 0 && input.peek() == '[') {
+            game.result = "*";
+            return true;
+        }
+        
+        if (!std::getline(input, line)) break;
+        
+        std::string trimmed = ChessUtils::trim(line);
+        if (trimmed.empty() || trimmed[0] == '%') {
+            continue;  // Blank line or escape line
+        }
+        
+        if (!inMovetext && trimmed[0] == '[') {
+            parseTag(trimmed, game);
+            continue;
+        }
+        
+        inMovetext = true;
+        if (parseMovetext(trimmed, game)) {
+            return true;
+        }
+    }
+    
+    // End of input - a game without a result token still counts
+    if (inMovetext || !game.tags.empty()) {
+        if (game.result.empty()) game.result = "*";
+        return true;
+    }
+    return false;
+}
+
+// Parse a tag pair line: [Name "Value"]
+void PgnReader::parseTag(const std::string& line, PgnGame& game) const {
+    size_t nameEnd = line.find_first_of(" \t\"", 1);
+    size_t valueStart = line.find('"');
+    size_t valueEnd = line.rfind('"');
+    if (nameEnd == std::string::npos || valueStart == std::string::npos || valueEnd <= valueStart) {
+        return;  // Malformed tag - ignore it
+    }
+    
+    std::string name = line.substr(1, nameEnd - 1);
+    std::string value;
+    for (size_t i = valueStart + 1; i < valueEnd; ++i) {
+        if (line[i] == '\\' && i + 1 < valueEnd) ++i;  // Escaped quote or backslash
+        value += line[i];
+    }
+    game.tags.emplace_back(name, value);
+}
+
+// Split one line of movetext into SAN moves, skipping everything else
+bool PgnReader::parseMovetext(const std::string& line, PgnGame& game) {
+    size_t i = 0;
+    while (i < line.size()) {
+        char c = line[i];
+        
+        if (commentDepth > 0) {
+            if (c == '}') --commentDepth;
+            ++i;
+            continue;
+        }
+        if (c == '{') {
+            ++commentDepth;
+            ++i;
+            continue;
+        }
+        if (c == ';') {
+            return false;  // Rest-of-line comment
+        }
+        if (c == '(') {
+            ++variationDepth;
+            ++i;
+            continue;
+        }
+        if (c == ')') {
+            if (variationDepth > 0) --variationDepth;
+            ++i;
+            continue;
+        }
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+        
+        // Collect one token
+        size_t start = i;
+        while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i])) &&
+               line[i] != '{' && line[i] != '(' && line[i] != ')' && line[i] != ';') {
+            ++i;
+        }
+        std::string token = line.substr(start, i - start);
+        
+        if (variationDepth > 0 || token[0] == '$') {
+            continue;  // Side line or numeric annotation glyph
+        }
+        
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+            game.result = token;
+            return true;
+        }
+        
+        // Strip a leading move number: "12." "12..." or "12.Nf3"
+        size_t digits = 0;
+        while (digits < token.size() && std::isdigit(static_cast<unsigned char>(token[digits]))) ++digits;
+        if (digits > 0 && digits < token.size() && token[digits] == '.') {
+            size_t dots = digits;
+            while (dots < token.size() && token[dots] == '.') ++dots;
+            token = token.substr(dots);
+        } else if (digits == token.size()) {
+            continue;  // Bare move number without dots
+        }
+        
+        if (!token.empty()) {
+            game.moves.push_back(token);
+        }
+    }
+    return false;
+}
+
+// Write one game in export format
+void writePgnGame(std::ostream& out, const PgnGame& game) {
+    for (const auto& tag : game.tags) {
+        out << "[" << tag.first << " \"";
+        for (char c : tag.second) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << "\"]\n";
+    }
+    out << "\n";
+    
+    // Move numbering starts from the FEN position if there is one
+    int moveNumber = 1;
+    bool whiteToMove = true;
+    std::string fen = game.getTag("FEN");
+    if (!fen.empty()) {
+        std::istringstream fields(fen);
+        std::string placement, side, castling, enPassant;
+        int halfMoves = 0;
+        fields >> placement >> side >> castling >> enPassant >> halfMoves >> moveNumber;
+        whiteToMove = side != "b";
+        if (moveNumber < 1) moveNumber = 1;
+    }
+    
+    std::string line;
+    auto addToken = [&out, &line](const std::string& token) {
+        if (!line.empty() && line.size() + 1 + token.size() > 79) {
+            out << line << "\n";
+            line.clear();
+        }
+        if (!line.empty()) line += ' ';
+        line += token;
+    };
+    
+    for (size_t i = 0; i < game.moves.size(); ++i) {
+        if (whiteToMove) {
+            addToken(std::to_string(moveNumber) + ". " + game.moves[i]);
+        } else if (i == 0) {
+            addToken(std::to_string(moveNumber) + "... " + game.moves[i]);
+        } else {
+            addToken(game.moves[i]);
+        }
+        if (!whiteToMove) ++moveNumber;
+        whiteToMove = !whiteToMove;
+    }
+    addToken(game.result.empty() ? "*" : game.result);
+    out << line << "\n\n";
+}
@@ -6,32 +6,7 @@ Piece::Piece(PieceType t, Color c) : type(t), color(c) {}
 
 // Get Unicode symbol for piece display
 std::string Piece::getSymbol() const {
-    if (type == PieceType::EMPTY) {
-        return " ";
-    }
-    
-    // Unicode chess pieces - this is a great C++ feature for international text
-    if (color == Color::WHITE) {
-        switch (type) {
-            case PieceType::KING:   return "♔";
-            case PieceType::QUEEN:  return "♕";
-            case PieceType::ROOK:   return "♖";
-            case PieceType::BISHOP: return "♗";
-            case PieceType::KNIGHT: return "♘";
-            case PieceType::PAWN:   return "♙";
-            default: return " ";
-        }
-    } else {
-        switch (type) {
-            case PieceType::KING:   return "♚";
-            case PieceType::QUEEN:  return "♛";
-            case PieceType::ROOK:   return "♜";
-            case PieceType::BISHOP: return "♝";
-            case PieceType::KNIGHT: return "♞";
-            case PieceType::PAWN:   return "♟";
-            default: return " ";
-        }
-    }
+    return std::string(getSymbolView());
 }
 
 // Get piece value for AI evaluation
@@ -0,0 +1,198 @@
+#include "../include/PieceSquareTables.h"
+
+namespace PieceSquareTables {
+
+const int MIDGAME_VALUE[6] = {100, 500, 320, 330, 900, 0};
+const int ENDGAME_VALUE[6] = {120, 520, 300, 320, 920, 0};
+
+const int MIDGAME_BONUS[6][8][8] = {
+    // Pawn
+    {
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {50, 50, 50, 50, 50, 50, 50, 50},
+        {10, 10, 20, 30, 30, 20, 10, 10},
+        {5,  5, 10, 25, 25, 10,  5,  5},
+        {0,  0,  0, 20, 20,  0,  0,  0},
+        {5, -5,-10,  0,  0,-10, -5,  5},
+        {5, 10, 10,-20,-20, 10, 10,  5},
+        {0,  0,  0,  0,  0,  0,  0,  0}
+    },
+    // Rook
+    {
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {5, 10, 10, 10, 10, 10, 10,  5},
+        {-5,  0,  0,  0,  0,  0,  0, -5},
+        {-5,  0,  0,  0,  0,  0,  0, -5},
+        {-5,  0,  0,  0,  0,  0,  0, -5},
+        {-5,  0,  0,  0,  0,  0,  0, -5},
+        {-5,  0,  0,  0,  0,  0,  0, -5},
+        {0,  0,  0,  5,  5,  0,  0,  0}
+    },
+    // Knight
+    {
+        {-50,-40,-30,-30,-30,-30,-40,-50},
+        {-40,-20,  0,  0,  0,  0,-20,-40},
+        {-30,  0, 10, 15, 15, 10,  0,-30},
+        {-30,  5, 15, 20, 20, 15,  5,-30},
+        {-30,  0, 15, 20, 20, 15,  0,-30},
+        {-30,  5, 10, 15, 15, 10,  5,-30},
+        {-40,-20,  0,  5,  5,  0,-20,-40},
+        {-50,-40,-30,-30,-30,-30,-40,-50}
+    },
+    // Bishop
+    {
+        {-20,-10,-10,-10,-10,-10,-10,-20},
+        {-10,  0,  0,  0,  0,  0,  0,-10},
+        {-10,  0,  5, 10, 10,  5,  0,-10},
+        {-10,  5,  5, 10, 10,  5,  5,-10},
+        {-10,  0, 10, 10, 10, 10,  0,-10},
+        {-10, 10, 10, 10, 10, 10, 10,-10},
+        {-10,  5,  0,  0,  0,  0,  5,-10},
+        {-20,-10,-10,-10,-10,-10,-10,-20}
+    },
+    // Queen
+    {
+        {-20,-10,-10, -5, -5,-10,-10,-20},
+        {-10,  0,  0,  0,  0,  0,  0,-10},
+        {-10,  0,  5,  5,  5,  5,  0,-10},
+        {-5,  0,  5,  5,  5,  5,  0, -5},
+        {0,  0,  5,  5,  5,  5,  0, -5},
+        {-10,  5,  5,  5,  5,  5,  0,-10},
+        {-10,  0,  5,  0,  0,  0,  0,-10},
+        {-20,-10,-10, -5, -5,-10,-10,-20}
+    },
+    // King
+    {
+        {-30,-40,-40,-50,-50,-40,-40,-30},
+        {-30,-40,-40,-50,-50,-40,-40,-30},
+        {-30,-40,-40,-50,-50,-40,-40,-30},
+        {-30,-40,-40,-50,-50,-40,-40,-30},
+        {-20,-30,-30,-40,-40,-30,-30,-20},
+        {-10,-20,-20,-20,-20,-20,-20,-10},
+        {20, 20,  0,  0,  0,  0, 20, 20},
+        {20, 30, 10,  0,  0, 10, 30, 20}
+    }
+};
+
+// Pawns gain more from advancing, rooks like the 7th rank, and the king
+// belongs in the centre once there is little left to attack it
+const int ENDGAME_BONUS[6][8][8] = {
+    // Pawn
+    {
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {80, 80, 80, 80, 80, 80, 80, 80},
+        {50, 50, 50, 50, 50, 50, 50, 50},
+        {30, 30, 30, 30, 30, 30, 30, 30},
+        {15, 15, 15, 15, 15, 15, 15, 15},
+        {5,  5,  5,  5,  5,  5,  5,  5},
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {0,  0,  0,  0,  0,  0,  0,  0}
+    },
+    // Rook
+    {
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {10, 10, 10, 10, 10, 10, 10, 10},
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {0,  0,  0,  0,  0,  0,  0,  0},
+        {0,  0,  0,  0,  0,  0,  0,  0}
+    },
+    // Knight
+    {
+        {-50,-40,-30,-30,-30,-30,-40,-50},
+        {-40,-20,  0,  0,  0,  0,-20,-40},
+        {-30,  0, 10, 15, 15, 10,  0,-30},
+        {-30,  5, 15, 20, 20, 15,  5,-30},
+        {-30,  0, 15, 20, 20, 15,  0,-30},
+        {-30,  5, 10, 15, 15, 10,  5,-30},
+        {-40,-20,  0,  5,  5,  0,-20,-40},
+        {-50,-40,-30,-30,-30,-30,-40,-50}
+    },
+    // Bishop
+    {
+        {-20,-10,-10,-10,-10,-10,-10,-20},
+        {-10,  0,  0,  0,  0,  0,  0,-10},
+        {-10,  0,  5, 10, 10,  5,  0,-10},
+        {-10,  5,  5, 10, 10,  5,  5,-10},
+        {-10,  0, 10, 10, 10, 10,  0,-10},
+        {-10, 10, 10, 10, 10, 10, 10,-10},
+        {-10,  5,  0,  0,  0,  0,  5,-10},
+        {-20,-10,-10,-10,-10,-10,-10,-20}
+    },
+    // Queen
+    {
+        {-20,-10,-10, -5, -5,-10,-10,-20},
+        {-10,  0,  0,  0,  0,  0,  0,-10},
+        {-10,  0,  5,  5,  5,  5,  0,-10},
+        {-5,  0,  5,  5,  5,  5,  0, -5},
+        {0,  0,  5,  5,  5,  5,  0, -5},
+        {-10,  5,  5,  5,  5,  5,  0,-10},
+        {-10,  0,  5,  0,  0,  0,  0,-10},
+        {-20,-10,-10, -5, -5,-10,-10,-20}
+    },
+    // King
+    {
+        {-50,-40,-30,-20,-20,-30,-40,-50},
+        {-30,-20,-10,  0,  0,-10,-20,-30},
+        {-30,-10, 20, 30, 30, 20,-10,-30},
+        {-30,-10, 30, 40, 40, 30,-10,-30},
+        {-30,-10, 30, 40, 40, 30,-10,-30},
+        {-30,-10, 20, 30, 30, 20,-10,-30},
+        {-30,-30,  0,  0,  0,  0,-30,-30},
+        {-50,-30,-30,-30,-30,-30,-30,-50}
+    }
+};
+
+} // namespace PieceSquareTables
+
+namespace {
+
+const int PHASE_WEIGHT[7] = {0, 2, 1, 1, 4, 0, 0};
+
+// Material plus bonus for every piece, color and square
+struct ScoreTableBuilder : PieceSquareTables::ScoreTable {
+    ScoreTableBuilder() {
+        for (int type = 0; type < 6; ++type) {
+            phase[type] = PHASE_WEIGHT[type];
+            for (int row = 0; row < 8; ++row) {
+                for (int col = 0; col < 8; ++col) {
+                    int square = row * 8 + col;
+                    int mirrored = (7 - row) * 8 + col;  // Black reads the tables upside down
+                    midgame[0][type][square] = PieceSquareTables::MIDGAME_VALUE[type] +
+                                               PieceSquareTables::MIDGAME_BONUS[type][row][col];
+                    endgame[0][type][square] = PieceSquareTables::ENDGAME_VALUE[type] +
+                                               PieceSquareTables::ENDGAME_BONUS[type][row][col];
+                    midgame[1][type][mirrored] = midgame[0][type][square];
+                    endgame[1][type][mirrored] = endgame[0][type][square];
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+namespace PieceSquareTables {
+
+const ScoreTable& table() {
+    static const ScoreTableBuilder instance;
+    return instance;
+}
+
+int midgame(PieceType type, Color color, int square) {
+    if (type == PieceType::EMPTY || color == Color::NONE) return 0;
+    return table().midgame[color == Color::WHITE ? 0 : 1][static_cast<int>(type)][square];
+}
+
+int endgame(PieceType type, Color color, int square) {
+    if (type == PieceType::EMPTY || color == Color::NONE) return 0;
+    return table().endgame[color == Color::WHITE ? 0 : 1][static_cast<int>(type)][square];
+}
+
+int phaseWeight(PieceType type) {
+    return PHASE_WEIGHT[static_cast<int>(type)];
+}
+
+} // namespace PieceSquareTables
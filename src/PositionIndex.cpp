@@ -0,0 +1,238 @@
+#include "../include/PositionIndex.h"
+#include "../include/ExternalSort.h"
+#include "../include/Notation.h"
+#include "../include/OpeningBook.h"
+#include "../include/ThreadPool.h"
+#include "../include/Varint.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+const char PositionIndex::MAGIC[8] = {'C', 'C', 'P', 'I', 'D', 'X', '1', '\0'};
+
+namespace {
+
+struct IndexHeader {
+    char magic[8];
+    uint64_t entries;
+    uint64_t games;
+    uint32_t blockEntries;
+    uint32_t blockCount;
+    uint64_t directoryOffset;  // From the start of the file; 8-byte aligned
+};
+
+static_assert(sizeof(IndexHeader) == 40, "IndexHeader is part of the file format");
+
+using Record = PositionIndex::Record;
+
+// Records in key order, then move; the same position and move add up
+struct RecordTraits {
+    static bool less(const Record& a, const Record& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return a.stats.move < b.stats.move;
+    }
+
+    static void combine(Record& total, const Record& more) {
+        total.stats.games += more.stats.games;
+        total.stats.whiteWins += more.stats.whiteWins;
+        total.stats.draws += more.stats.draws;
+        total.stats.blackWins += more.stats.blackWins;
+    }
+};
+
+using RunSort = ExternalSort<Record, RecordTraits>;
+
+// Results from the Result tag: +1 white won, 0 draw, -1 black won, 2 unknown
+int gameOutcome(std::string_view game) {
+    std::string_view result = MappedPgn::tag(game, "Result");
+    if (result == "1-0") return 1;
+    if (result == "0-1") return -1;
+    if (result == "1/2-1/2") return 0;
+    return 2;
+}
+
+// Replay one game, one record per move played
+size_t replayGame(std::string_view text, int maxPly, Board& board, std::vector<Record>& records) {
+    std::string_view fen = MappedPgn::tag(text, "FEN");
+    if (fen.empty() || !board.loadFEN(std::string(fen))) board.resetToStartingPosition();
+
+    int outcome = gameOutcome(text);
+    PositionIndex::MoveStats stats{0, 1, outcome == 1, outcome == 0, outcome == -1};
+
+    PgnTokenizer tokens(text);
+    std::string_view san;
+    Move move;
+    size_t played = 0;
+    while ((maxPly <= 0 || static_cast<int>(played) < maxPly) && tokens.nextMove(san)) {
+        uint64_t key = board.getHashKey();
+        if (!Notation::fromSAN(board, san, move) || !board.makeMove(move)) break;
+        stats.move = OpeningBook::encodeMove(move);
+        records.push_back(Record{key, stats});
+        ++played;
+    }
+    return played;
+}
+
+} // namespace
+
+PositionIndex::Writer::Writer(const std::string& path, uint64_t games)
+    : out(path, std::ios::binary | std::ios::trunc), games(games) {
+    IndexHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offsets.push_back(sizeof(header));
+    block.reserve(BLOCK_ENTRIES * 16);
+}
+
+void PositionIndex::Writer::flushBlock() {
+    if (blockCount == 0) return;
+    out.write(reinterpret_cast<const char*>(block.data()), block.size());
+    offsets.push_back(offsets.back() + block.size());
+    block.clear();
+    blockCount = 0;
+}
+
+void PositionIndex::Writer::add(const Record& record) {
+    if (blockCount == static_cast<int>(BLOCK_ENTRIES)) flushBlock();
+    if (blockCount == 0) {
+        firstKeys.push_back(record.key);
+        previousKey = record.key;
+    }
+    Varint::put(block, record.key - previousKey);
+    Varint::put(block, record.stats.move);
+    Varint::put(block, record.stats.games);
+    Varint::put(block, record.stats.whiteWins);
+    Varint::put(block, record.stats.draws);
+    Varint::put(block, record.stats.blackWins);
+    previousKey = record.key;
+    ++blockCount;
+    ++entries;
+}
+
+bool PositionIndex::Writer::finish() {
+    flushBlock();
+
+    // Pad so the directory can be read in place as uint64_t
+    uint64_t directoryOffset = (offsets.back() + 7) & ~7ULL;
+    const char padding[8] = {};
+    out.write(padding, directoryOffset - offsets.back());
+    out.write(reinterpret_cast<const char*>(firstKeys.data()), firstKeys.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    IndexHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.entries = entries;
+    header.games = games;
+    header.blockEntries = BLOCK_ENTRIES;
+    header.blockCount = static_cast<uint32_t>(firstKeys.size());
+    header.directoryOffset = directoryOffset;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    return !out.fail();
+}
+
+bool PositionIndex::open(const std::string& path) {
+    blockCount = 0;
+    if (!file.open(path) || file.size() < sizeof(IndexHeader)) return false;
+
+    IndexHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    size_t directorySize = (2 * static_cast<size_t>(header.blockCount) + 1) * sizeof(uint64_t);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.directoryOffset % 8 != 0 ||
+        header.directoryOffset + directorySize > file.size()) {
+        return false;
+    }
+
+    firstKeys = reinterpret_cast<const uint64_t*>(file.getData() + header.directoryOffset);
+    offsets = firstKeys + header.blockCount;
+    entries = header.entries;
+    games = header.games;
+    blockCount = header.blockCount;
+    return offsets[blockCount] <= header.directoryOffset;
+}
+
+std::vector<PositionIndex::MoveStats> PositionIndex::lookup(uint64_t key) const {
+    std::vector<MoveStats> moves;
+    if (blockCount == 0) return moves;
+
+    // The key's entries start in the last block with a smaller first key,
+    // or in the first block with this key, and may run on into later blocks
+    size_t block = std::lower_bound(firstKeys, firstKeys + blockCount, key) - firstKeys;
+    if (block > 0) --block;
+
+    for (; block < blockCount && firstKeys[block] <= key; ++block) {
+        const uint8_t* in = file.getData() + offsets[block];
+        const uint8_t* end = file.getData() + offsets[block + 1];
+        uint64_t entryKey = firstKeys[block];
+        uint64_t values[6];
+        while (in < end) {
+            for (uint64_t& value : values) {
+                if (!Varint::get(in, end, value)) return moves;  // Corrupt block
+            }
+            entryKey += values[0];
+            if (entryKey > key) break;
+            if (entryKey == key) {
+                moves.push_back(MoveStats{static_cast<uint16_t>(values[1]), static_cast<uint32_t>(values[2]),
+                                          static_cast<uint32_t>(values[3]), static_cast<uint32_t>(values[4]),
+                                          static_cast<uint32_t>(values[5])});
+            }
+        }
+        if (entryKey > key) break;
+    }
+
+    std::stable_sort(moves.begin(), moves.end(),
+                     [](const MoveStats& a, const MoveStats& b) { return a.games > b.games; });
+    return moves;
+}
+
+bool PositionIndex::build(const MappedPgn& archive, const std::string& path, const BuildOptions& options,
+                          BuildStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    stats = BuildStats();
+
+    ThreadPool pool(options.threads);
+    size_t limit = std::max<size_t>(4096, options.memoryMB * 1024 * 1024 / sizeof(Record) / pool.size());
+    RunSort runs(options.tempDir, "posindex");
+    std::atomic<size_t> positions(0);
+    std::atomic<bool> spillFailed(false);
+
+    // A few tasks per thread; each spills its records whenever its buffer fills
+    size_t count = archive.gameCount();
+    size_t gamesPerTask = std::max<size_t>(64, count / (static_cast<size_t>(pool.size()) * 4) + 1);
+    for (size_t first = 0; first < count; first += gamesPerTask) {
+        size_t last = std::min(count, first + gamesPerTask);
+        pool.submit([&, first, last] {
+            std::vector<Record> records;
+            Board board;
+            size_t played = 0;
+            for (size_t index = first; index < last; ++index) {
+                played += replayGame(archive.game(index), options.maxPly, board, records);
+                if (records.size() >= limit && !runs.spill(records)) {
+                    spillFailed = true;
+                    return;
+                }
+            }
+            if (!runs.spill(records)) spillFailed = true;
+            positions += played;
+        });
+    }
+    pool.wait();
+    if (spillFailed) return false;  // A missing run would leave positions out
+
+    // K-way merge of the runs into the index
+    Writer writer(path, count);
+    if (!writer.isOpen()) return false;
+
+    runs.merge([&](const Record& record) {
+        writer.add(record);
+        ++stats.entries;
+    });
+
+    stats.games = count;
+    stats.positions = positions;
+    stats.runs = runs.runCount();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return writer.finish();
+}
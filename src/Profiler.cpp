@@ -0,0 +1,249 @@
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define PROFILER_TSC 1
+#else
+    #define PROFILER_TSC 0
+#endif
+
+namespace Profiler {
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+struct Buffer {
+    std::vector<Event> events;
+    uint64_t written = 0;
+    int thread = 0;
+
+    explicit Buffer(size_t size) : events(size) {}  // A power of two
+
+    // Oldest first
+    std::vector<Event> collect() const {
+        size_t size = events.size();
+        if (written <= size) return std::vector<Event>(events.begin(), events.begin() + written);
+        size_t head = written % size;
+        std::vector<Event> ordered(events.begin() + head, events.end());
+        ordered.insert(ordered.end(), events.begin(), events.begin() + head);
+        return ordered;
+    }
+};
+
+std::mutex buffersMutex;
+
+std::vector<std::unique_ptr<Buffer>>& buffers() {
+    static std::vector<std::unique_ptr<Buffer>> all;
+    return all;
+}
+
+thread_local Buffer* current = nullptr;
+
+Buffer* registerThread() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers().push_back(std::make_unique<Buffer>(EVENTS_PER_THREAD));
+    buffers().back()->thread = static_cast<int>(buffers().size());
+    return buffers().back().get();
+}
+
+uint64_t clockNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Ticks and clock at startup, to convert ticks to time
+const uint64_t ORIGIN_TICKS = now();
+const uint64_t ORIGIN_NANOSECONDS = clockNanoseconds();
+
+double ticksPerNanosecond() {
+    if (!PROFILER_TSC) return 1.0;
+
+    // The longer since startup, the better the estimate
+    if (clockNanoseconds() - ORIGIN_NANOSECONDS < 10000000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    uint64_t ticks = now();
+    uint64_t nanoseconds = clockNanoseconds();
+    return static_cast<double>(ticks - ORIGIN_TICKS) / static_cast<double>(nanoseconds - ORIGIN_NANOSECONDS);
+}
+
+struct Totals {
+    uint64_t calls = 0;
+    double total = 0.0;  // Ticks, children included
+    double self = 0.0;
+};
+
+// Self time is what a scope's direct children didn't take
+void addTotals(std::vector<Event> events, std::map<std::string, Totals>& totals, double& covered) {
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        return a.start != b.start ? a.start < b.start : a.end > b.end;
+    });
+
+    struct Open {
+        const Event* event;
+        double children;
+    };
+    std::vector<Open> stack;
+    auto close = [&](const Open& open) {
+        Totals& entry = totals[open.event->name];
+        double duration = static_cast<double>(open.event->end - open.event->start);
+        ++entry.calls;
+        entry.total += duration;
+        entry.self += duration - open.children;
+    };
+
+    for (const Event& event : events) {
+        while (!stack.empty() && stack.back().event->end < event.end) {
+            close(stack.back());
+            stack.pop_back();
+        }
+        if (stack.empty()) {
+            covered += static_cast<double>(event.end - event.start);
+        } else {
+            stack.back().children += static_cast<double>(event.end - event.start);
+        }
+        stack.push_back(Open{&event, 0.0});
+    }
+    while (!stack.empty()) {
+        close(stack.back());
+        stack.pop_back();
+    }
+}
+
+} // namespace
+
+uint64_t now() {
+    #if PROFILER_TSC
+        return __rdtsc();
+    #else
+        return clockNanoseconds();
+    #endif
+}
+
+void record(const char* name, uint64_t start, uint64_t end) {
+    if (!current) current = registerThread();
+    current->events[current->written & (current->events.size() - 1)] = Event{name, start, end};
+    ++current->written;
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto& buffer : buffers()) buffer->written = 0;
+}
+
+size_t eventCount() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    size_t count = 0;
+    for (auto& buffer : buffers()) count += std::min<uint64_t>(buffer->written, buffer->events.size());
+    return count;
+}
+
+size_t droppedCount() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    size_t count = 0;
+    for (auto& buffer : buffers()) {
+        if (buffer->written > buffer->events.size()) count += buffer->written - buffer->events.size();
+    }
+    return count;
+}
+
+void writeChromeTrace(std::ostream& out) {
+    double scale = 1.0 / (ticksPerNanosecond() * 1000.0);  // Ticks to microseconds
+    std::lock_guard<std::mutex> lock(buffersMutex);
+
+    uint64_t first = UINT64_MAX;
+    std::vector<std::vector<Event>> threads;
+    for (auto& buffer : buffers()) {
+        threads.push_back(buffer->collect());
+        for (const Event& event : threads.back()) first = std::min(first, event.start);
+    }
+
+    // Complete ("X") events, timestamps in microseconds from the first one
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool separator = false;
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        out << (separator ? ",\n" : "\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+            << buffers()[i]->thread << ", \"args\": {\"name\": \"thread " << buffers()[i]->thread << "\"}}";
+        separator = true;
+        for (const Event& event : threads[i]) {
+            out << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << buffers()[i]->thread << ", \"ts\": " << (event.start - first) * scale
+                << ", \"dur\": " << (event.end - event.start) * scale << "}";
+        }
+    }
+    out << "\n]}" << std::endl;
+}
+
+void printFlatProfile(std::ostream& out) {
+    double overhead = scopeOverhead();
+    double ticksPerNs = ticksPerNanosecond();
+
+    std::map<std::string, Totals> totals;
+    double covered = 0.0;
+    size_t events = 0;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto& buffer : buffers()) {
+            std::vector<Event> recorded = buffer->collect();
+            events += recorded.size();
+            addTotals(std::move(recorded), totals, covered);
+        }
+    }
+    if (events == 0) {
+        out << "Nothing recorded" << (ENABLED ? "" : " - build with PROFILE=1 (after make clean)") << std::endl;
+        return;
+    }
+
+    std::vector<std::pair<std::string, Totals>> rows(totals.begin(), totals.end());
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.second.self > b.second.self; });
+
+    double coveredMs = covered / ticksPerNs / 1e6;
+    out << std::fixed << std::setprecision(2) << "Flat profile: " << events << " scopes, " << droppedCount()
+        << " overwritten, " << coveredMs << " ms in top-level scopes\n"
+        << std::left << std::setw(28) << "scope" << std::right << std::setw(10) << "calls" << std::setw(12)
+        << "total ms" << std::setw(12) << "self ms" << std::setw(9) << "self %" << std::setw(12) << "ns/call\n";
+    for (const auto& row : rows) {
+        const Totals& entry = row.second;
+        out << std::left << std::setw(28) << row.first << std::right << std::setw(10) << entry.calls
+            << std::setw(12) << entry.total / ticksPerNs / 1e6 << std::setw(12) << entry.self / ticksPerNs / 1e6
+            << std::setw(8) << std::setprecision(1) << 100.0 * entry.self / covered << "%" << std::setw(11)
+            << std::setprecision(0) << entry.total / ticksPerNs / entry.calls << "\n"
+            << std::setprecision(2);
+    }
+    out << std::setprecision(1) << "Profiling cost: about " << overhead << " ns per scope, "
+        << 100.0 * overhead * events / 1e6 / std::max(coveredMs, 1e-9) << "% of the recorded time" << std::endl;
+}
+
+double scopeOverhead() {
+    // On a buffer of its own, so nothing recorded is overwritten
+    Buffer scratch(4096);
+    Buffer* saved = current;
+    current = &scratch;
+
+    const int SCOPES = 100000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SCOPES; ++i) {
+        Scope scope("overhead");
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    current = saved;
+    return elapsed / SCOPES;
+}
+
+} // namespace Profiler
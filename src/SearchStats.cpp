@@ -0,0 +1,70 @@
+#include "../include/SearchStats.h"
+#include <iomanip>
+
+void SearchStats::reset() {
+    nodes = 0;
+    qnodes = 0;
+    ttProbes = 0;
+    ttHits = 0;
+    ttCutoffs = 0;
+    pawnProbes = 0;
+    pawnHits = 0;
+    for (long long& count : betaCutoffs) {
+        count = 0;
+    }
+    peakPly = 0;
+    milliseconds = 0.0;
+    iterations.clear();
+}
+
+long long SearchStats::getNodesPerSecond() const {
+    return milliseconds > 0.0 ? static_cast<long long>(nodes * 1000.0 / milliseconds) : 0;
+}
+
+double SearchStats::getTTHitRate() const {
+    return ttProbes > 0 ? static_cast<double>(ttHits) / ttProbes : 0.0;
+}
+
+double SearchStats::getPawnHitRate() const {
+    return pawnProbes > 0 ? static_cast<double>(pawnHits) / pawnProbes : 0.0;
+}
+
+double SearchStats::getFirstMoveCutoffRate() const {
+    long long total = 0;
+    for (long long count : betaCutoffs) {
+        total += count;
+    }
+    return total > 0 ? static_cast<double>(betaCutoffs[0]) / total : 0.0;
+}
+
+void SearchStats::print(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    
+    out << "Depth " << getDepth() << " (peak ply " << peakPly << "), " << nodes << " nodes, "
+        << qnodes << " qnodes, " << milliseconds << " ms, " << getNodesPerSecond() << " nps\n";
+    
+    if (ENABLED) {
+        out << "TT: " << ttProbes << " probes, " << 100.0 * getTTHitRate() << "% hits, "
+            << ttCutoffs << " cutoffs\n";
+        out << "Pawn hash: " << pawnProbes << " probes, " << 100.0 * getPawnHitRate() << "% hits\n";
+        out << "Beta cutoffs by move:";
+        for (int i = 0; i < CUTOFF_SLOTS; ++i) {
+            out << " " << (i + 1) << (i == CUTOFF_SLOTS - 1 ? "+" : "") << ":" << betaCutoffs[i];
+        }
+        out << " (" << 100.0 * getFirstMoveCutoffRate() << "% on the first move)\n";
+    }
+    
+    for (const IterationStats& iteration : iterations) {
+        out << "  depth " << std::setw(2) << iteration.depth << "  " << std::setw(10) << iteration.nodes
+            << " nodes  " << std::setw(8) << iteration.milliseconds << " ms";
+        if (iteration.branchingFactor > 0.0) {
+            out << "  EBF " << std::setprecision(2) << iteration.branchingFactor << std::setprecision(1);
+        }
+        out << "\n";
+    }
+    
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,155 @@
+#include "../include/Spectator.h"
+#include "../include/Zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+const char LIGHT_SQUARE[] = "\033[47m\033[30m";  // Same colors as the main board
+const char DARK_SQUARE[] = "\033[46m\033[30m";
+const char RESET[] = "\033[0m";
+
+void decode(const PackedPosition& position, Piece squares[64]) {
+    std::fill(squares, squares + 64, Piece());
+    int index = 0;
+    for (uint64_t bits = position.occupancy; bits && index < 32; bits &= bits - 1, ++index) {
+        int code = (position.pieces[index / 2] >> (index % 2 * 4)) & 15;
+        int type = code & 7;
+        if (type > static_cast<int>(PieceType::KING)) continue;
+        Color color = (code & PackedPositions::BLACK_FLAG) ? Color::BLACK : Color::WHITE;
+        squares[__builtin_ctzll(bits)] = Piece(static_cast<PieceType>(type), color);
+    }
+}
+
+bool samePiece(const Piece& a, const Piece& b) {
+    return a.getType() == b.getType() && a.getColor() == b.getColor();
+}
+
+} // namespace
+
+Spectator::Spectator(int boardCount, int framesPerSecond, int fd)
+    : frameMicroseconds(1000000 / std::max(1, framesPerSecond)), renderer(fd), running(false), onScreen(false),
+      framesDrawn(0), dropped(0) {
+    for (int i = 0; i < std::max(1, boardCount); ++i) {
+        boards.push_back(std::make_unique<Tile>());
+    }
+}
+
+Spectator::~Spectator() {
+    stop();
+}
+
+void Spectator::start() {
+    if (renderThread.joinable()) return;
+    running = true;
+    renderThread = std::thread(&Spectator::renderLoop, this);
+}
+
+void Spectator::stop() {
+    if (!renderThread.joinable()) return;
+    running = false;
+    renderThread.join();
+
+    // Whatever arrived after the last frame
+    drawFrame();
+    int rows = (getBoardCount() + TILES_PER_ROW - 1) / TILES_PER_ROW;
+    renderer.moveCursor(rows * TILE_HEIGHT, 0);
+    renderer.append("\033[?25h");  // Show the cursor again
+    renderer.flush();
+}
+
+int Spectator::attach() {
+    for (size_t i = 0; i < boards.size(); ++i) {
+        bool expected = false;
+        if (boards[i]->attached.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void Spectator::detach(int board) {
+    if (board < 0 || board >= getBoardCount()) return;
+    boards[board]->attached.store(false, std::memory_order_release);
+}
+
+bool Spectator::publish(int board, const BoardSnapshot& snapshot) {
+    if (board < 0 || board >= getBoardCount()) return false;
+    if (boards[board]->queue.tryPush(snapshot)) return true;
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Frames start on a fixed clock; a slow frame delays the next one rather
+// than causing a burst to catch up
+void Spectator::renderLoop() {
+    auto next = std::chrono::steady_clock::now();
+    while (running) {
+        drawFrame();
+        next = std::max(next + std::chrono::microseconds(frameMicroseconds), std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Spectator::drawFrame() {
+    bool whole = !onScreen;
+    if (whole) renderer.append("\033[2J\033[?25l");  // Clear, hide the cursor
+
+    for (int i = 0; i < getBoardCount(); ++i) {
+        Tile& tile = *boards[i];
+        BoardSnapshot snapshot;
+        while (tile.queue.tryPop(snapshot)) {
+            tile.latest = snapshot;
+            tile.changed = true;
+        }
+        if (whole || tile.changed) drawTile(i, tile, whole);
+        tile.changed = false;
+    }
+
+    if (!renderer.frame().empty()) {
+        renderer.flush();
+        framesDrawn.fetch_add(1, std::memory_order_relaxed);
+    }
+    onScreen = true;
+}
+
+void Spectator::drawTile(int index, Tile& tile, bool whole) {
+    int top = index / TILES_PER_ROW * TILE_HEIGHT;
+    int left = index % TILES_PER_ROW * TILE_WIDTH;
+
+    // Title, padded so it overwrites the previous one
+    char text[64];
+    const BoardSnapshot& snapshot = tile.latest;
+    if (snapshot.game == 0) {
+        std::snprintf(text, sizeof(text), "waiting");
+    } else {
+        std::snprintf(text, sizeof(text), "#%d ply %d %.7s", snapshot.game, snapshot.ply, snapshot.result);
+    }
+    char title[TILE_WIDTH];
+    std::snprintf(title, sizeof(title), "%-*.*s", TILE_WIDTH - 2, TILE_WIDTH - 2, text);
+    renderer.moveCursor(top, left);
+    renderer.append(title);
+
+    Piece squares[64];
+    decode(snapshot.position, squares);
+
+    for (int row = 0; row < 8; ++row) {
+        if (whole) {
+            char rank = static_cast<char>('8' - row);
+            renderer.moveCursor(top + 1 + row, left);
+            renderer.append(std::string_view(&rank, 1));
+        }
+        for (int col = 0; col < 8; ++col) {
+            int square = Zobrist::squareIndex(row, col);
+            if (!whole && samePiece(squares[square], tile.shown[square])) continue;
+
+            if (!whole) renderer.moveCursor(top + 1 + row, left + 1 + 2 * col);
+            renderer.append((row + col) % 2 == 0 ? LIGHT_SQUARE : DARK_SQUARE);
+            renderer.append(squares[square].getSymbolView());
+            renderer.append(" ");
+            renderer.append(RESET);
+            tile.shown[square] = squares[square];
+        }
+    }
+}
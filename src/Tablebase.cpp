@@ -0,0 +1,753 @@
+#include "../include/Tablebase.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+// Byte values stored in a table.
+// 1..127 win for the side to move in 2v-1 plies, 128..254 loss in 2(v-128) plies.
+const uint8_t VALUE_DRAW = 0;
+const uint8_t VALUE_ILLEGAL = 255;
+const uint8_t FIRST_LOSS = 128;
+const int MAX_PLIES = 252;
+
+bool isWin(uint8_t value) { return value >= 1 && value < FIRST_LOSS; }
+bool isLoss(uint8_t value) { return value >= FIRST_LOSS && value != VALUE_ILLEGAL; }
+int winPlies(uint8_t value) { return 2 * value - 1; }
+int lossPlies(uint8_t value) { return 2 * (value - FIRST_LOSS); }
+uint8_t encodeWin(int plies) { return static_cast<uint8_t>((plies + 1) / 2); }
+uint8_t encodeLoss(int plies) { return static_cast<uint8_t>(FIRST_LOSS + plies / 2); }
+
+// File layout: header, block offsets, then run-length encoded blocks
+const char MAGIC[8] = {'C', 'C', 'T', 'B', '1', '\0', '\0', '\0'};
+const uint32_t BLOCK_ENTRIES = 4096;
+
+struct TableHeader {
+    char magic[8];
+    char signature[8];
+    uint64_t entries;
+    uint32_t blockEntries;
+    uint32_t blockCount;
+};
+
+static_assert(sizeof(TableHeader) == 32, "TableHeader is part of the file format");
+
+// A position reduced to its pieces. Pieces are kept in table slot order:
+// white king, other white pieces, black king, other black pieces.
+struct TBPosition {
+    int count;
+    PieceType types[Tablebase::MAX_PIECES];
+    Color colors[Tablebase::MAX_PIECES];
+    int squares[Tablebase::MAX_PIECES];  // row * 8 + col
+    Color sideToMove;
+};
+
+// Order of pieces within a side: K Q R B N P
+int pieceOrder(PieceType type) {
+    switch (type) {
+        case PieceType::KING:   return 0;
+        case PieceType::QUEEN:  return 1;
+        case PieceType::ROOK:   return 2;
+        case PieceType::BISHOP: return 3;
+        case PieceType::KNIGHT: return 4;
+        case PieceType::PAWN:   return 5;
+        default:                return 6;
+    }
+}
+
+char pieceLetter(PieceType type) {
+    return "KQRBNP?"[pieceOrder(type)];
+}
+
+PieceType pieceFromLetter(char letter) {
+    switch (letter) {
+        case 'K': return PieceType::KING;
+        case 'Q': return PieceType::QUEEN;
+        case 'R': return PieceType::ROOK;
+        case 'B': return PieceType::BISHOP;
+        case 'N': return PieceType::KNIGHT;
+        case 'P': return PieceType::PAWN;
+        default:  return PieceType::EMPTY;
+    }
+}
+
+// Rough material value, only used to decide which side is "stronger"
+int materialValue(PieceType type) {
+    switch (type) {
+        case PieceType::QUEEN:  return 9;
+        case PieceType::ROOK:   return 5;
+        case PieceType::BISHOP: return 3;
+        case PieceType::KNIGHT: return 3;
+        case PieceType::PAWN:   return 1;
+        default:                return 0;
+    }
+}
+
+Color opposite(Color color) {
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+int slotKey(const TBPosition& pos, int i) {
+    return (pos.colors[i] == Color::WHITE ? 0 : 8) + pieceOrder(pos.types[i]);
+}
+
+void sortSlots(TBPosition& pos) {
+    for (int i = 1; i < pos.count; ++i) {
+        for (int j = i; j > 0 && slotKey(pos, j) < slotKey(pos, j - 1); --j) {
+            std::swap(pos.types[j], pos.types[j - 1]);
+            std::swap(pos.colors[j], pos.colors[j - 1]);
+            std::swap(pos.squares[j], pos.squares[j - 1]);
+        }
+    }
+}
+
+std::string signatureOf(const TBPosition& pos) {
+    std::string signature;
+    for (int i = 0; i < pos.count; ++i) {
+        signature += pieceLetter(pos.types[i]);
+    }
+    return signature;
+}
+
+// Positive if white has the stronger material, negative if black does
+int compareSides(const TBPosition& pos) {
+    // Called for every capture during generation, so no allocations here
+    int balance = 0;
+    int white[Tablebase::MAX_PIECES], black[Tablebase::MAX_PIECES];
+    int whiteCount = 0, blackCount = 0;
+    for (int i = 0; i < pos.count; ++i) {
+        int value = materialValue(pos.types[i]);
+        if (pos.colors[i] == Color::WHITE) {
+            balance += value;
+            white[whiteCount++] = pieceOrder(pos.types[i]);
+        } else {
+            balance -= value;
+            black[blackCount++] = pieceOrder(pos.types[i]);
+        }
+    }
+    if (balance != 0) return balance;
+
+    // Equal value: more pieces first, then the lower piece order wins
+    // (slots are sorted, so the lists are in piece order)
+    if (whiteCount != blackCount) return whiteCount - blackCount;
+    for (int i = 0; i < whiteCount; ++i) {
+        if (white[i] != black[i]) return black[i] - white[i];
+    }
+    return 0;
+}
+
+// Swap colors and mirror the ranks - the position stays the same for chess
+void swapColors(TBPosition& pos) {
+    for (int i = 0; i < pos.count; ++i) {
+        pos.colors[i] = opposite(pos.colors[i]);
+        pos.squares[i] ^= 56;
+    }
+    pos.sideToMove = opposite(pos.sideToMove);
+    sortSlots(pos);
+}
+
+// Bring a position into its table's orientation and return the signature
+std::string canonicalize(TBPosition& pos) {
+    sortSlots(pos);
+    if (compareSides(pos) < 0) {
+        swapColors(pos);
+    }
+    return signatureOf(pos);
+}
+
+bool parseSignature(const std::string& signature, TBPosition& pos) {
+    if (signature.size() < 2 || signature.size() > static_cast<size_t>(Tablebase::MAX_PIECES)) return false;
+    if (signature[0] != 'K') return false;
+
+    size_t secondKing = signature.find('K', 1);
+    if (secondKing == std::string::npos || signature.find('K', secondKing + 1) != std::string::npos) return false;
+
+    pos.count = static_cast<int>(signature.size());
+    pos.sideToMove = Color::WHITE;
+    for (int i = 0; i < pos.count; ++i) {
+        pos.types[i] = pieceFromLetter(signature[i]);
+        if (pos.types[i] == PieceType::EMPTY) return false;
+        pos.colors[i] = (static_cast<size_t>(i) < secondKing) ? Color::WHITE : Color::BLACK;
+        pos.squares[i] = 0;
+    }
+
+    // Must already be canonical
+    TBPosition check = pos;
+    return canonicalize(check) == signature;
+}
+
+size_t tableSize(int count) {
+    return size_t(2) << (6 * count);
+}
+
+size_t indexOf(const TBPosition& pos) {
+    size_t index = 0;
+    for (int i = pos.count - 1; i >= 0; --i) {
+        index = index * 64 + pos.squares[i];
+    }
+    return index * 2 + (pos.sideToMove == Color::BLACK ? 1 : 0);
+}
+
+void decodeIndex(size_t index, TBPosition& pos) {
+    pos.sideToMove = (index & 1) ? Color::BLACK : Color::WHITE;
+    index >>= 1;
+    for (int i = 0; i < pos.count; ++i) {
+        pos.squares[i] = static_cast<int>(index & 63);
+        index >>= 6;
+    }
+}
+
+// Does the piece in slot i attack the square?
+bool attacks(const TBPosition& pos, const int8_t* occupant, int i, int square) {
+    int fromRow = pos.squares[i] / 8, fromCol = pos.squares[i] % 8;
+    int toRow = square / 8, toCol = square % 8;
+    int deltaRow = toRow - fromRow, deltaCol = toCol - fromCol;
+    int absRow = std::abs(deltaRow), absCol = std::abs(deltaCol);
+
+    switch (pos.types[i]) {
+        case PieceType::PAWN: {
+            int direction = (pos.colors[i] == Color::WHITE) ? -1 : 1;
+            return deltaRow == direction && absCol == 1;
+        }
+        case PieceType::KNIGHT:
+            return (absRow == 1 && absCol == 2) || (absRow == 2 && absCol == 1);
+        case PieceType::KING:
+            return std::max(absRow, absCol) == 1;
+        default: {
+            bool straight = (deltaRow == 0) != (deltaCol == 0);
+            bool diagonal = absRow == absCol && absRow != 0;
+            PieceType type = pos.types[i];
+            if (!((straight && (type == PieceType::ROOK || type == PieceType::QUEEN)) ||
+                  (diagonal && (type == PieceType::BISHOP || type == PieceType::QUEEN)))) {
+                return false;
+            }
+            int stepRow = (deltaRow > 0) - (deltaRow < 0);
+            int stepCol = (deltaCol > 0) - (deltaCol < 0);
+            for (int r = fromRow + stepRow, c = fromCol + stepCol; r != toRow || c != toCol; r += stepRow, c += stepCol) {
+                if (occupant[r * 8 + c] >= 0) return false;
+            }
+            return true;
+        }
+    }
+}
+
+void fillOccupants(const TBPosition& pos, int8_t* occupant) {
+    std::memset(occupant, -1, 64);
+    for (int i = 0; i < pos.count; ++i) {
+        occupant[pos.squares[i]] = static_cast<int8_t>(i);
+    }
+}
+
+// Is the king of the given color attacked?
+bool kingAttacked(const TBPosition& pos, const int8_t* occupant, Color color) {
+    int kingSquare = -1;
+    for (int i = 0; i < pos.count; ++i) {
+        if (pos.types[i] == PieceType::KING && pos.colors[i] == color) kingSquare = pos.squares[i];
+    }
+    for (int i = 0; i < pos.count; ++i) {
+        if (pos.colors[i] != color && attacks(pos, occupant, i, kingSquare)) return true;
+    }
+    return false;
+}
+
+// Call visit(child, materialChanged) for every legal move of the side to move
+template <typename Visitor>
+void forEachChild(const TBPosition& pos, Visitor&& visit) {
+    int8_t occupant[64];
+    fillOccupants(pos, occupant);
+    Color us = pos.sideToMove;
+
+    auto tryMove = [&](int i, int to, PieceType promotion) {
+        TBPosition child = pos;
+        child.squares[i] = to;
+        if (promotion != PieceType::EMPTY) child.types[i] = promotion;
+
+        int captured = occupant[to];
+        if (captured >= 0) {
+            for (int j = captured; j + 1 < child.count; ++j) {
+                child.types[j] = child.types[j + 1];
+                child.colors[j] = child.colors[j + 1];
+                child.squares[j] = child.squares[j + 1];
+            }
+            --child.count;
+        }
+        child.sideToMove = opposite(us);
+
+        int8_t childOccupant[64];
+        fillOccupants(child, childOccupant);
+        if (!kingAttacked(child, childOccupant, us)) {
+            visit(child, captured >= 0 || promotion != PieceType::EMPTY);
+        }
+    };
+
+    static const int kingSteps[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+    static const int knightSteps[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+
+    for (int i = 0; i < pos.count; ++i) {
+        if (pos.colors[i] != us) continue;
+        int row = pos.squares[i] / 8, col = pos.squares[i] % 8;
+
+        auto canLand = [&](int r, int c) {
+            if (r < 0 || r > 7 || c < 0 || c > 7) return false;
+            int other = occupant[r * 8 + c];
+            return other < 0 || (pos.colors[other] != us && pos.types[other] != PieceType::KING);
+        };
+
+        switch (pos.types[i]) {
+            case PieceType::KING:
+            case PieceType::KNIGHT: {
+                const int (*steps)[2] = (pos.types[i] == PieceType::KING) ? kingSteps : knightSteps;
+                for (int s = 0; s < 8; ++s) {
+                    int r = row + steps[s][0], c = col + steps[s][1];
+                    if (canLand(r, c)) tryMove(i, r * 8 + c, PieceType::EMPTY);
+                }
+                break;
+            }
+            case PieceType::PAWN: {
+                int direction = (us == Color::WHITE) ? -1 : 1;
+                int lastRow = (us == Color::WHITE) ? 0 : 7;
+                int startRow = (us == Color::WHITE) ? 6 : 1;
+                auto pawnMove = [&](int r, int c) {
+                    if (r == lastRow) {
+                        for (PieceType promotion : {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT}) {
+                            tryMove(i, r * 8 + c, promotion);
+                        }
+                    } else {
+                        tryMove(i, r * 8 + c, PieceType::EMPTY);
+                    }
+                };
+                int r = row + direction;
+                if (occupant[r * 8 + col] < 0) {
+                    pawnMove(r, col);
+                    if (row == startRow && occupant[(r + direction) * 8 + col] < 0) {
+                        tryMove(i, (r + direction) * 8 + col, PieceType::EMPTY);
+                    }
+                }
+                for (int c : {col - 1, col + 1}) {
+                    if (c >= 0 && c <= 7 && occupant[r * 8 + c] >= 0 && canLand(r, c)) pawnMove(r, c);
+                }
+                break;
+            }
+            default: {
+                PieceType type = pos.types[i];
+                for (int s = 0; s < 8; ++s) {
+                    bool diagonal = kingSteps[s][0] != 0 && kingSteps[s][1] != 0;
+                    if (diagonal && type == PieceType::ROOK) continue;
+                    if (!diagonal && type == PieceType::BISHOP) continue;
+                    for (int r = row + kingSteps[s][0], c = col + kingSteps[s][1];
+                         r >= 0 && r <= 7 && c >= 0 && c <= 7; r += kingSteps[s][0], c += kingSteps[s][1]) {
+                        if (canLand(r, c)) tryMove(i, r * 8 + c, PieceType::EMPTY);
+                        if (occupant[r * 8 + c] >= 0) break;
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+// Run-length encode one block as (count - 1, value) byte pairs
+void compressBlock(const uint8_t* values, size_t count, std::vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && run < 256 && values[i + run] == values[i]) ++run;
+        out.push_back(static_cast<uint8_t>(run - 1));
+        out.push_back(values[i]);
+        i += run;
+    }
+}
+
+bool writeTable(const std::string& path, const std::string& signature, const std::vector<uint8_t>& values) {
+    TableHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    std::strncpy(header.signature, signature.c_str(), sizeof(header.signature) - 1);
+    header.entries = values.size();
+    header.blockEntries = BLOCK_ENTRIES;
+    header.blockCount = static_cast<uint32_t>((values.size() + BLOCK_ENTRIES - 1) / BLOCK_ENTRIES);
+
+    std::vector<uint64_t> offsets;
+    std::vector<uint8_t> data;
+    for (uint32_t block = 0; block < header.blockCount; ++block) {
+        offsets.push_back(data.size());
+        size_t start = static_cast<size_t>(block) * BLOCK_ENTRIES;
+        compressBlock(values.data() + start, std::min<size_t>(BLOCK_ENTRIES, values.size() - start), data);
+    }
+    offsets.push_back(data.size());
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return static_cast<bool>(out);
+}
+
+std::string tablePath(const std::string& directory, const std::string& signature) {
+    return directory + "/" + signature + Tablebase::FILE_EXTENSION;
+}
+
+// A table file mapped into memory
+struct TableFile {
+    MappedFile file;
+    TableHeader header;
+    const uint64_t* offsets = nullptr;
+    const uint8_t* data = nullptr;
+
+    bool open(const std::string& path) {
+        if (!file.open(path) || file.size() < sizeof(TableHeader)) return false;
+
+        std::memcpy(&header, file.getData(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.blockEntries == 0) return false;
+
+        size_t offsetsSize = (static_cast<size_t>(header.blockCount) + 1) * sizeof(uint64_t);
+        if (file.size() < sizeof(header) + offsetsSize) return false;
+
+        offsets = reinterpret_cast<const uint64_t*>(file.getData() + sizeof(header));
+        data = file.getData() + sizeof(header) + offsetsSize;
+        return file.size() >= sizeof(header) + offsetsSize + offsets[header.blockCount];
+    }
+
+    std::string signature() const {
+        return std::string(header.signature, strnlen(header.signature, sizeof(header.signature)));
+    }
+
+    // Decode a single entry - only its block is touched
+    uint8_t value(size_t index) const {
+        if (index >= header.entries) return VALUE_ILLEGAL;
+        size_t block = index / header.blockEntries;
+        size_t remaining = index % header.blockEntries;
+
+        const uint8_t* run = data + offsets[block];
+        const uint8_t* end = data + offsets[block + 1];
+        while (run < end) {
+            size_t length = static_cast<size_t>(run[0]) + 1;
+            if (remaining < length) return run[1];
+            remaining -= length;
+            run += 2;
+        }
+        return VALUE_ILLEGAL;
+    }
+
+    // Decode the whole table (used when generating larger tables)
+    void decodeAll(std::vector<uint8_t>& values) const {
+        values.clear();
+        values.reserve(header.entries);
+        const uint8_t* end = data + offsets[header.blockCount];
+        for (const uint8_t* run = data; run < end; run += 2) {
+            values.insert(values.end(), static_cast<size_t>(run[0]) + 1, run[1]);
+        }
+    }
+};
+
+} // namespace
+
+struct Tablebase::MappedTable : public TableFile {};
+
+const char* const Tablebase::FILE_EXTENSION = ".cctb";
+
+Tablebase::Tablebase() : maxPieces(0) {}
+
+Tablebase::~Tablebase() = default;
+
+// Map every table file in the directory
+int Tablebase::load(const std::string& directory) {
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(directory, error)) {
+        if (item.path().extension() != FILE_EXTENSION) continue;
+
+        auto table = std::make_unique<MappedTable>();
+        if (!table->open(item.path().string())) continue;
+
+        std::string signature = table->signature();
+        TBPosition check;
+        if (!parseSignature(signature, check) || table->header.entries != tableSize(check.count)) continue;
+
+        maxPieces = std::max(maxPieces, check.count);
+        tables[signature] = std::move(table);
+    }
+    return getTableCount();
+}
+
+// Look up the position in the matching table
+Tablebase::ProbeResult Tablebase::probe(const Board& board) const {
+    const ProbeResult unknown{Result::UNKNOWN, 0};
+    const GameState& state = board.getGameState();
+    if (tables.empty() || state.enPassantCol != -1) {
+        return unknown;
+    }
+    
+    // Castling rights only matter while the king and that rook are still at home
+    auto canCastle = [&board](bool right, int row, int rookCol, Color color) {
+        const Piece& king = board.getPiece(row, 4);
+        const Piece& rook = board.getPiece(row, rookCol);
+        return right && king.getType() == PieceType::KING && king.getColor() == color &&
+               rook.getType() == PieceType::ROOK && rook.getColor() == color;
+    };
+    if (canCastle(state.whiteCanCastleKingside, 7, 7, Color::WHITE) ||
+        canCastle(state.whiteCanCastleQueenside, 7, 0, Color::WHITE) ||
+        canCastle(state.blackCanCastleKingside, 0, 7, Color::BLACK) ||
+        canCastle(state.blackCanCastleQueenside, 0, 0, Color::BLACK)) {
+        return unknown;
+    }
+
+    TBPosition pos;
+    pos.count = 0;
+    pos.sideToMove = state.currentPlayer;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Piece& piece = board.getPiece(row, col);
+            if (piece.isEmpty()) continue;
+            if (pos.count == MAX_PIECES) return unknown;
+            pos.types[pos.count] = piece.getType();
+            pos.colors[pos.count] = piece.getColor();
+            pos.squares[pos.count] = row * 8 + col;
+            ++pos.count;
+        }
+    }
+
+    std::string signature = canonicalize(pos);
+    if (signature == "KK") return ProbeResult{Result::DRAW, 0};
+
+    auto table = tables.find(signature);
+    if (table == tables.end()) return unknown;
+
+    uint8_t value = table->second->value(indexOf(pos));
+    if (value == VALUE_ILLEGAL) return unknown;
+    if (isWin(value)) return ProbeResult{Result::WIN, winPlies(value)};
+    if (isLoss(value)) return ProbeResult{Result::LOSS, lossPlies(value)};
+    return ProbeResult{Result::DRAW, 0};
+}
+
+std::vector<std::string> Tablebase::allSignatures(int maxPieces) {
+    const std::string pieces = "QRBNP";
+    std::vector<std::string> signatures;
+
+    if (maxPieces >= 3) {
+        for (char a : pieces) {
+            signatures.push_back(std::string("K") + a + "K");
+        }
+    }
+    if (maxPieces >= 4) {
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            for (size_t j = i; j < pieces.size(); ++j) {
+                signatures.push_back(std::string("K") + pieces[i] + pieces[j] + "K");
+            }
+        }
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            for (size_t j = i; j < pieces.size(); ++j) {
+                signatures.push_back(std::string("K") + pieces[i] + "K" + pieces[j]);
+            }
+        }
+    }
+    return signatures;
+}
+
+namespace {
+
+// Builds tables in memory, generating or loading the smaller tables that
+// captures and promotions lead into
+class Generator {
+private:
+    std::string directory;
+    int threads;
+    std::ostream& log;
+    std::map<std::string, std::vector<uint8_t>> tables;
+    std::map<std::string, int> longestMate;  // Plies, per table
+
+    // Signatures reachable by one capture and/or promotion
+    std::vector<std::string> dependencies(const TBPosition& material) {
+        std::vector<std::string> result;
+        auto add = [&](TBPosition pos) {
+            std::string signature = canonicalize(pos);
+            if (signature != "KK" && std::find(result.begin(), result.end(), signature) == result.end()) {
+                result.push_back(signature);
+            }
+        };
+        auto without = [](TBPosition pos, int slot) {
+            for (int j = slot; j + 1 < pos.count; ++j) {
+                pos.types[j] = pos.types[j + 1];
+                pos.colors[j] = pos.colors[j + 1];
+            }
+            --pos.count;
+            return pos;
+        };
+
+        for (int i = 0; i < material.count; ++i) {
+            if (material.types[i] != PieceType::KING) add(without(material, i));
+            if (material.types[i] != PieceType::PAWN) continue;
+            for (PieceType promotion : {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT}) {
+                TBPosition promoted = material;
+                promoted.types[i] = promotion;
+                add(promoted);
+                for (int j = 0; j < material.count; ++j) {
+                    if (j != i && material.types[j] != PieceType::KING && material.colors[j] != material.colors[i]) {
+                        add(without(promoted, j));
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    uint8_t childValue(TBPosition child, bool materialChanged, const std::vector<uint8_t>& current) const {
+        if (!materialChanged) return current[indexOf(child)];
+        std::string signature = canonicalize(child);
+        if (signature == "KK") return VALUE_DRAW;
+        return tables.at(signature)[indexOf(child)];
+    }
+
+    // Run one pass over the table on all threads; fn returns the new value or 0
+    template <typename Fn>
+    size_t parallelPass(std::vector<uint8_t>& values, Fn fn) {
+        const size_t chunkSize = 1 << 15;
+        std::atomic<size_t> nextChunk{0};
+        std::vector<std::vector<std::pair<uint32_t, uint8_t>>> updates(threads);
+
+        auto work = [&](int id) {
+            size_t start;
+            while ((start = nextChunk.fetch_add(chunkSize)) < values.size()) {
+                size_t end = std::min(values.size(), start + chunkSize);
+                for (size_t index = start; index < end; ++index) {
+                    if (values[index] != VALUE_DRAW) continue;
+                    uint8_t value = fn(index);
+                    if (value != VALUE_DRAW) updates[id].emplace_back(static_cast<uint32_t>(index), value);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int id = 1; id < threads; ++id) workers.emplace_back(work, id);
+        work(0);
+        for (std::thread& worker : workers) worker.join();
+
+        // Writes are applied after the pass so every thread saw the same table
+        size_t changed = 0;
+        for (const auto& list : updates) {
+            for (const auto& update : list) values[update.first] = update.second;
+            changed += list.size();
+        }
+        return changed;
+    }
+
+public:
+    Generator(const std::string& dir, int threadCount, std::ostream& out)
+        : directory(dir), threads(std::max(1, threadCount)), log(out) {}
+
+    bool obtain(const std::string& signature) {
+        if (tables.count(signature)) return true;
+
+        TBPosition material;
+        if (!parseSignature(signature, material)) {
+            log << "Invalid signature: " << signature << "\n";
+            return false;
+        }
+
+        // Reuse a table that is already on disk
+        TableFile existing;
+        if (existing.open(tablePath(directory, signature)) && existing.signature() == signature &&
+            existing.header.entries == tableSize(material.count)) {
+            existing.decodeAll(tables[signature]);
+        } else if (!build(signature, material)) {
+            return false;
+        }
+
+        int longest = 0;
+        for (uint8_t value : tables[signature]) {
+            if (isWin(value)) longest = std::max(longest, winPlies(value));
+            if (isLoss(value)) longest = std::max(longest, lossPlies(value));
+        }
+        longestMate[signature] = longest;
+        return true;
+    }
+
+    bool build(const std::string& signature, const TBPosition& material) {
+        int longestChildMate = 0;
+        for (const std::string& dependency : dependencies(material)) {
+            if (!obtain(dependency)) return false;
+            longestChildMate = std::max(longestChildMate, longestMate[dependency]);
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        log << "Generating " << signature << "..." << std::flush;
+
+        std::vector<uint8_t>& values = tables[signature];
+        values.assign(tableSize(material.count), VALUE_DRAW);
+
+        // Pass 0: broken positions, checkmates and stalemates
+        parallelPass(values, [&](size_t index) -> uint8_t {
+            TBPosition pos = material;
+            decodeIndex(index, pos);
+
+            int8_t occupant[64];
+            std::memset(occupant, -1, sizeof(occupant));
+            for (int i = 0; i < pos.count; ++i) {
+                if (occupant[pos.squares[i]] >= 0) return VALUE_ILLEGAL;  // Two pieces on one square
+                occupant[pos.squares[i]] = static_cast<int8_t>(i);
+                int row = pos.squares[i] / 8;
+                if (pos.types[i] == PieceType::PAWN && (row == 0 || row == 7)) return VALUE_ILLEGAL;
+            }
+            if (kingAttacked(pos, occupant, opposite(pos.sideToMove))) return VALUE_ILLEGAL;
+
+            bool hasMove = false;
+            forEachChild(pos, [&](const TBPosition&, bool) { hasMove = true; });
+            if (!hasMove && kingAttacked(pos, occupant, pos.sideToMove)) return encodeLoss(0);
+            return VALUE_DRAW;
+        });
+
+        // Pass n finds the wins (odd n) or losses (even n) in exactly n plies
+        int lastChange = 0;
+        for (int plies = 1; plies <= MAX_PLIES; ++plies) {
+            bool winPass = plies % 2 == 1;
+            size_t changed = parallelPass(values, [&](size_t index) -> uint8_t {
+                TBPosition pos = material;
+                decodeIndex(index, pos);
+
+                bool found = false;     // Win pass: a move into a loss in plies-1
+                bool allWins = true;    // Loss pass: every move leads to a win for the opponent
+                int longest = 0;
+                forEachChild(pos, [&](const TBPosition& child, bool materialChanged) {
+                    if (found || (!winPass && !allWins)) return;
+                    uint8_t value = childValue(child, materialChanged, values);
+                    if (winPass) {
+                        found = isLoss(value) && lossPlies(value) == plies - 1;
+                    } else if (isWin(value)) {
+                        longest = std::max(longest, winPlies(value));
+                    } else {
+                        allWins = false;
+                    }
+                });
+
+                if (winPass) return found ? encodeWin(plies) : VALUE_DRAW;
+                return (allWins && longest == plies - 1) ? encodeLoss(plies) : VALUE_DRAW;
+            });
+
+            if (changed > 0) lastChange = plies;
+            if (plies - lastChange >= 2 && plies > longestChildMate + 1) break;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        log << " longest mate " << lastChange << " plies, " << seconds << " s\n";
+
+        if (!writeTable(tablePath(directory, signature), signature, values)) {
+            log << "Error: could not write " << tablePath(directory, signature) << "\n";
+            return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool Tablebase::generate(const std::string& signature, const std::string& directory,
+                         int threads, std::ostream& log) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    
+    Generator generator(directory, threads, log);
+    return generator.obtain(signature);
+}
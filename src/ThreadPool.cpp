@@ -0,0 +1,137 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace {
+    // Index of the pool worker running on this thread, or -1
+    thread_local long currentWorker = -1;
+    thread_local const void* currentPool = nullptr;
+}
+
+ThreadPool::ThreadPool(int threads, bool pinned)
+    : nextQueue(0), queuedTasks(0), pendingTasks(0), stopping(false), pinned(pinned) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    
+    for (int i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Queue a task - on the calling worker's own deque, or round robin
+void ThreadPool::submit(std::function<void()> task) {
+    size_t id;
+    if (currentPool == this && currentWorker >= 0) {
+        id = static_cast<size_t>(currentWorker);
+    } else {
+        id = nextQueue.fetch_add(1) % queues.size();
+    }
+    
+    // Counted in the same critical section as the push, so a thief can't
+    // finish the task (and bring pendingTasks to 0) before it is counted.
+    // Workers never take stateMutex while holding a deque's mutex.
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        std::lock_guard<std::mutex> lock(queues[id]->mutex);
+        queues[id]->tasks.push_back(std::move(task));
+        ++queuedTasks;
+        ++pendingTasks;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pendingTasks == 0; });
+}
+
+// Own deque first (newest task), then steal the oldest task from another
+bool ThreadPool::takeTask(size_t id, std::function<void()>& task) {
+    {
+        TaskQueue& own = *queues[id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        TaskQueue& victim = *queues[(id + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool ThreadPool::pinCurrentThread(int core) {
+    #ifdef __linux__
+        int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % cores, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    #else
+        (void)core;
+        return false;
+    #endif
+}
+
+void ThreadPool::workerLoop(size_t id) {
+    currentWorker = static_cast<long>(id);
+    currentPool = this;
+    if (pinned) {
+        pinCurrentThread(static_cast<int>(id));
+    }
+    
+    while (true) {
+        std::function<void()> task;
+        if (takeTask(id, task)) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                --queuedTasks;
+            }
+            
+            task();
+            
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--pendingTasks == 0) {
+                allDone.notify_all();
+            }
+            continue;
+        }
+        
+        // Nothing to do - sleep until a task is submitted
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "../include/TrainingData.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace TrainingData {
+
+const char MAGIC[8] = {'C', 'C', 'T', 'R', 'A', 'I', 'N', '\0'};
+
+namespace {
+
+const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint64_t);
+
+} // namespace
+
+bool pack(const Board& board, int score, int result, TrainingPosition& position) {
+    PackedPosition packed;
+    if (!PackedPositions::pack(board, packed)) return false;
+
+    std::memset(&position, 0, sizeof(position));
+    position.occupancy = packed.occupancy;
+    std::memcpy(position.pieces, packed.pieces, sizeof(position.pieces));
+    position.score = static_cast<int16_t>(std::max(-MAX_SCORE, std::min(MAX_SCORE, score)));
+    position.result = static_cast<int8_t>(result > 0 ? 1 : result < 0 ? -1 : 0);
+    position.sideToMove = packed.sideToMove;
+    position.castling = packed.castling;
+    position.enPassantCol = packed.enPassantCol;
+    position.fullMoveNumber = packed.fullMoveNumber;
+    return true;
+}
+
+void toPacked(const TrainingPosition& position, PackedPosition& packed) {
+    std::memset(&packed, 0, sizeof(packed));
+    packed.occupancy = position.occupancy;
+    std::memcpy(packed.pieces, position.pieces, sizeof(packed.pieces));
+    packed.sideToMove = position.sideToMove;
+    packed.castling = position.castling;
+    packed.enPassantCol = position.enPassantCol;
+    packed.fullMoveNumber = position.fullMoveNumber;
+}
+
+bool unpack(const TrainingPosition& position, Board& board) {
+    PackedPosition packed;
+    toPacked(position, packed);
+    return PackedPositions::unpack(packed, board);
+}
+
+bool records(const MappedFile& file, const TrainingPosition*& first, size_t& count) {
+    if (!file.isOpen() || file.size() < HEADER_SIZE) return false;
+    if (std::memcmp(file.getData(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    uint64_t stored;
+    std::memcpy(&stored, file.getData() + sizeof(MAGIC), sizeof(stored));
+    if ((file.size() - HEADER_SIZE) / sizeof(TrainingPosition) < stored) return false;
+
+    first = reinterpret_cast<const TrainingPosition*>(file.getData() + HEADER_SIZE);
+    count = static_cast<size_t>(stored);
+    return true;
+}
+
+Writer::Writer(const std::string& path) : path(path), count(0) {
+    if (!out.open(path)) return;
+    uint64_t none = 0;
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(&none, sizeof(none));
+}
+
+bool Writer::finish() {
+    if (!out.isOpen() || !out.close()) return false;
+
+    // Until now the header says the file is empty
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    if (!file) return false;
+    bool written = std::fseek(file, sizeof(MAGIC), SEEK_SET) == 0 && std::fwrite(&count, sizeof(count), 1, file) == 1;
+    return std::fclose(file) == 0 && written;
+}
+
+} // namespace TrainingData
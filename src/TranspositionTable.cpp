@@ -0,0 +1,186 @@
+#include "../include/TranspositionTable.h"
+#include "../include/MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool largePagesEnabled = true;
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t megabytes) : entries(nullptr), count(0), mask(0), zeroed(true) {
+    resize(megabytes);
+}
+
+void TranspositionTable::setLargePages(bool enabled) {
+    largePagesEnabled = enabled;
+}
+
+// Allocate the largest power of two number of entries that fits. The memory
+// comes zeroed, which is an empty table (Bound::NONE is 0).
+void TranspositionTable::resize(size_t megabytes) {
+    size_t maxEntries = std::max<size_t>(1, megabytes) * 1024 * 1024 / sizeof(TTEntry);
+    size_t entryCount = 1;
+    while (entryCount * 2 <= maxEntries) {
+        entryCount *= 2;
+    }
+    
+    entries = static_cast<TTEntry*>(memory.allocate(entryCount * sizeof(TTEntry), largePagesEnabled));
+    if (!entries) throw std::bad_alloc();
+    count = entryCount;
+    mask = count - 1;
+    zeroed = true;
+}
+
+// A table nothing was stored in is still the zeroed mapping: clearing it
+// would only make the clearing threads the first to touch its pages
+void TranspositionTable::clear() {
+    if (zeroed) return;
+    memory.clear(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    zeroed = true;
+}
+
+// For benchmarks: a fresh table otherwise takes its page faults in the
+// first search. Written by the calling thread alone, so the pages are placed
+// on its NUMA node just as the search would have placed them.
+void TranspositionTable::prefault() {
+    memory.clear(1);
+    zeroed = true;
+}
+
+const TTEntry* TranspositionTable::probe(uint64_t key) const {
+    const TTEntry& entry = entries[key & mask];
+    if (entry.bound == Bound::NONE || entry.key != key) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+void TranspositionTable::store(uint64_t key, int score, int depth, Bound bound, uint16_t move) {
+    TTEntry& entry = entries[key & mask];
+    zeroed = false;
+    
+    if (entry.key == key && entry.bound != Bound::NONE) {
+        // A deeper result for the same position (from a loaded snapshot, or
+        // reached again closer to the root) is worth more than this one
+        if (entry.depth > depth) {
+            return;
+        }
+        // Keep the old best move if this search didn't find one
+        if (move == 0) {
+            move = entry.move;
+        }
+    }
+    
+    entry.key = key;
+    entry.score = score;
+    entry.move = move;
+    entry.depth = static_cast<int8_t>(std::min(depth, 127));
+    entry.bound = bound;
+}
+
+namespace {
+
+struct SnapshotHeader {
+    char magic[8];
+    uint64_t entries;
+    uint64_t checksum;   // checksumEntries() of the entries that follow
+    int32_t minDepth;
+    uint8_t perspective; // 0 white, 1 black
+    uint8_t padding[3];
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "SnapshotHeader is part of the file format");
+
+// FNV-1a over 64-bit words
+uint64_t checksumEntries(const TTEntry* entries, size_t count, uint64_t hash = 0xcbf29ce484222325ULL) {
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t words[2];
+        std::memcpy(words, &entries[i], sizeof(words));
+        hash = (hash ^ words[0]) * 0x100000001b3ULL;
+        hash = (hash ^ words[1]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint8_t perspectiveCode(Color color) {
+    return color == Color::BLACK ? 1 : 0;
+}
+
+} // namespace
+
+const char TranspositionTable::SNAPSHOT_MAGIC[8] = {'C', 'C', 'H', 'A', 'S', 'H', '1', '\0'};
+
+long long TranspositionTable::save(const std::string& path, int minDepth, Color perspective) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    SnapshotHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Kept entries are gathered a block at a time and checksummed as written
+    std::vector<TTEntry> block;
+    block.reserve(4096);
+    uint64_t checksum = checksumEntries(nullptr, 0);
+    uint64_t written = 0;
+    auto flush = [&] {
+        checksum = checksumEntries(block.data(), block.size(), checksum);
+        out.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(TTEntry));
+        written += block.size();
+        block.clear();
+    };
+    for (size_t i = 0; i < count; ++i) {
+        const TTEntry& entry = entries[i];
+        if (entry.bound == Bound::NONE || entry.depth < minDepth) continue;
+        block.push_back(entry);
+        if (block.size() == block.capacity()) flush();
+    }
+    flush();
+
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.entries = written;
+    header.checksum = checksum;
+    header.minDepth = minDepth;
+    header.perspective = perspectiveCode(perspective);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    return out.fail() ? -1 : static_cast<long long>(written);
+}
+
+long long TranspositionTable::load(const std::string& path, Color perspective) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) return -1;
+
+    SnapshotHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        (file.size() - sizeof(header)) / sizeof(TTEntry) < header.entries) {
+        return -1;
+    }
+    const TTEntry* stored = reinterpret_cast<const TTEntry*>(file.getData() + sizeof(header));
+    if (checksumEntries(stored, header.entries) != header.checksum) return -1;
+
+    bool negate = header.perspective != perspectiveCode(perspective);
+    long long loaded = 0;
+    for (uint64_t i = 0; i < header.entries; ++i) {
+        TTEntry entry = stored[i];
+        if (entry.bound == Bound::NONE) continue;
+        if (negate) {
+            entry.score = -entry.score;
+            if (entry.bound == Bound::LOWER) entry.bound = Bound::UPPER;
+            else if (entry.bound == Bound::UPPER) entry.bound = Bound::LOWER;
+        }
+
+        TTEntry& slot = entries[entry.key & mask];
+        if (slot.bound == Bound::NONE || slot.depth < entry.depth) {
+            slot = entry;
+            zeroed = false;
+            ++loaded;
+        }
+    }
+    return loaded;
+}
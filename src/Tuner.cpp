@@ -0,0 +1,344 @@
+#include "../include/Tuner.h"
+#include "../include/Mobility.h"
+#include "../include/PawnStructure.h"
+#include "../include/PieceSquareTables.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+
+const char* const PIECE_NAMES[6] = {"Pawn", "Rook", "Knight", "Bishop", "Queen", "King"};
+
+double sigmoid(double x) {
+    return 1.0 / (1.0 + std::exp(-x));
+}
+
+int mirror(int square) {
+    return (7 - square / 8) * 8 + square % 8;
+}
+
+struct RawTerm {
+    int weight;
+    int count;
+    bool operator<(const RawTerm& other) const { return weight < other.weight; }
+};
+
+// Terms of one position, tapered ones first; false for a corrupt record
+bool collectTerms(const TrainingPosition& position, std::vector<RawTerm>& pairs, std::vector<RawTerm>& plain,
+                  int& phase, Mobility::Score& kingSafety) {
+    pairs.clear();
+    plain.clear();
+    phase = 0;
+
+    uint64_t pieces[2][6] = {};
+    int material[6] = {};
+    int index = 0;
+    for (uint64_t bits = position.occupancy; bits; bits &= bits - 1, ++index) {
+        if (index == 32) return false;
+        int code = (position.pieces[index / 2] >> (index % 2 * 4)) & 15;
+        int type = code & 7;
+        if (type > static_cast<int>(PieceType::KING)) return false;
+
+        int side = (code & PackedPositions::BLACK_FLAG) ? 1 : 0;
+        int square = __builtin_ctzll(bits);
+        pieces[side][type] |= 1ULL << square;
+        material[type] += side == 0 ? 1 : -1;
+        phase += PieceSquareTables::phaseWeight(static_cast<PieceType>(type));
+
+        // Black reads the tables upside down
+        pairs.push_back(RawTerm{Tuner::BONUS_PAIRS + type * 64 + (side == 0 ? square : mirror(square)),
+                                side == 0 ? 1 : -1});
+    }
+
+    for (int type = 0; type < 5; ++type) {
+        pairs.push_back(RawTerm{Tuner::MATERIAL_PAIRS + type, material[type]});
+    }
+
+    Mobility::Terms mobility = Mobility::terms(pieces);
+    for (int type = 0; type < 6; ++type) {
+        pairs.push_back(RawTerm{Tuner::MOBILITY_PAIRS + type, mobility.mobility[type]});
+    }
+    kingSafety = mobility.kingSafety;
+
+    const int PAWN = static_cast<int>(PieceType::PAWN);
+    PawnStructure::Terms pawns = PawnStructure::terms(pieces[0][PAWN], pieces[1][PAWN]);
+    plain.push_back(RawTerm{Tuner::DOUBLED, -pawns.doubled});
+    plain.push_back(RawTerm{Tuner::ISOLATED, -pawns.isolated});
+    plain.push_back(RawTerm{Tuner::BACKWARD, -pawns.backward});
+    for (int rank = 0; rank < 8; ++rank) {
+        plain.push_back(RawTerm{Tuner::PASSED + rank, pawns.passed[rank]});
+    }
+
+    // A white and a black piece on mirrored squares cancel out
+    std::sort(pairs.begin(), pairs.end());
+    size_t out = 0;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (out > 0 && pairs[out - 1].weight == pairs[i].weight) pairs[out - 1].count += pairs[i].count;
+        else pairs[out++] = pairs[i];
+    }
+    pairs.resize(out);
+
+    auto unused = [](const RawTerm& term) { return term.count == 0; };
+    pairs.erase(std::remove_if(pairs.begin(), pairs.end(), unused), pairs.end());
+    plain.erase(std::remove_if(plain.begin(), plain.end(), unused), plain.end());
+    return true;
+}
+
+} // namespace
+
+namespace Tuner {
+
+std::vector<double> currentWeights() {
+    std::vector<double> weights(WEIGHT_COUNT, 0.0);
+    for (int type = 0; type < 5; ++type) {
+        weights[2 * (MATERIAL_PAIRS + type)] = PieceSquareTables::MIDGAME_VALUE[type];
+        weights[2 * (MATERIAL_PAIRS + type) + 1] = PieceSquareTables::ENDGAME_VALUE[type];
+    }
+    for (int type = 0; type < 6; ++type) {
+        for (int square = 0; square < 64; ++square) {
+            int pair = BONUS_PAIRS + type * 64 + square;
+            weights[2 * pair] = PieceSquareTables::MIDGAME_BONUS[type][square / 8][square % 8];
+            weights[2 * pair + 1] = PieceSquareTables::ENDGAME_BONUS[type][square / 8][square % 8];
+        }
+        weights[2 * (MOBILITY_PAIRS + type)] = Mobility::MIDGAME_WEIGHT[type];
+        weights[2 * (MOBILITY_PAIRS + type) + 1] = Mobility::ENDGAME_WEIGHT[type];
+    }
+    weights[DOUBLED] = PawnStructure::DOUBLED_PENALTY;
+    weights[ISOLATED] = PawnStructure::ISOLATED_PENALTY;
+    weights[BACKWARD] = PawnStructure::BACKWARD_PENALTY;
+    for (int rank = 0; rank < 8; ++rank) weights[PASSED + rank] = PawnStructure::PASSED_BONUS[rank];
+    return weights;
+}
+
+void Dataset::load(const TrainingPosition* positions, size_t count, ThreadPool& pool) {
+    chunks.assign((count + CHUNK_POSITIONS - 1) / CHUNK_POSITIONS, Chunk());
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        pool.submit([this, positions, count, c] {
+            Chunk& chunk = chunks[c];
+            std::vector<RawTerm> pairs;
+            std::vector<RawTerm> plain;
+            size_t last = std::min(count, (c + 1) * CHUNK_POSITIONS);
+            for (size_t i = c * CHUNK_POSITIONS; i < last; ++i) {
+                int phase = 0;
+                Mobility::Score kingSafety;
+                if (!collectTerms(positions[i], pairs, plain, phase, kingSafety)) continue;
+
+                Position position{};
+                position.firstTerm = static_cast<uint32_t>(chunk.terms.size());
+                position.pairTerms = static_cast<uint8_t>(pairs.size());
+                position.plainTerms = static_cast<uint8_t>(plain.size());
+                position.phase = static_cast<float>(std::min(phase, PieceSquareTables::MAX_PHASE)) /
+                                 PieceSquareTables::MAX_PHASE;
+                position.fixed = position.phase * kingSafety.midgame + (1.0f - position.phase) * kingSafety.endgame;
+                position.result = 0.5f + 0.5f * positions[i].result;
+                position.score = positions[i].score;
+                position.target = position.result;
+                for (const RawTerm& term : pairs) {
+                    chunk.terms.push_back(Term{static_cast<uint16_t>(term.weight), static_cast<int16_t>(term.count)});
+                }
+                for (const RawTerm& term : plain) {
+                    chunk.terms.push_back(Term{static_cast<uint16_t>(term.weight), static_cast<int16_t>(term.count)});
+                }
+                chunk.positions.push_back(position);
+            }
+            chunk.terms.shrink_to_fit();
+        });
+    }
+    pool.wait();
+
+    positionCount = 0;
+    for (const Chunk& chunk : chunks) positionCount += chunk.positions.size();
+}
+
+double Dataset::evaluate(const Term* terms, const Position& position, const double* weights) {
+    double midgame = 0.0;
+    double endgame = 0.0;
+    const Term* term = terms + position.firstTerm;
+    for (const Term* end = term + position.pairTerms; term != end; ++term) {
+        midgame += term->count * weights[2 * term->weight];
+        endgame += term->count * weights[2 * term->weight + 1];
+    }
+    double score = position.fixed + position.phase * midgame + (1.0 - position.phase) * endgame;
+    for (const Term* end = term + position.plainTerms; term != end; ++term) {
+        score += term->count * weights[term->weight];
+    }
+    return score;
+}
+
+double Dataset::evaluate(size_t index, const std::vector<double>& weights) const {
+    for (const Chunk& chunk : chunks) {
+        if (index < chunk.positions.size()) {
+            return evaluate(chunk.terms.data(), chunk.positions[index], weights.data());
+        }
+        index -= chunk.positions.size();
+    }
+    return 0.0;
+}
+
+void Dataset::setTargets(double scale, double lambda) {
+    for (Chunk& chunk : chunks) {
+        for (Position& position : chunk.positions) {
+            position.target = static_cast<float>(lambda * position.result +
+                                                  (1.0 - lambda) * sigmoid(scale * position.score));
+        }
+    }
+}
+
+double Dataset::chunkLoss(const Chunk& chunk, const std::vector<double>& weights, double scale,
+                          double* gradient) const {
+    const double EPSILON = 1e-12;
+    double total = 0.0;
+    for (const Position& position : chunk.positions) {
+        double predicted = sigmoid(scale * evaluate(chunk.terms.data(), position, weights.data()));
+        double target = position.target;
+        total -= target * std::log(std::max(predicted, EPSILON)) +
+                 (1.0 - target) * std::log(std::max(1.0 - predicted, EPSILON));
+        if (!gradient) continue;
+
+        // d(loss)/d(eval) of the cross-entropy of a sigmoid
+        double slope = scale * (predicted - target);
+        double midgame = slope * position.phase;
+        double endgame = slope - midgame;
+        const Term* term = chunk.terms.data() + position.firstTerm;
+        for (const Term* end = term + position.pairTerms; term != end; ++term) {
+            gradient[2 * term->weight] += term->count * midgame;
+            gradient[2 * term->weight + 1] += term->count * endgame;
+        }
+        for (const Term* end = term + position.plainTerms; term != end; ++term) {
+            gradient[term->weight] += term->count * slope;
+        }
+    }
+    return total;
+}
+
+double Dataset::loss(const std::vector<double>& weights, double scale, ThreadPool& pool,
+                     std::vector<double>* gradient) const {
+    if (positionCount == 0) return 0.0;
+
+    // One gradient per chunk, added up in order so results don't depend on timing
+    std::vector<double> losses(chunks.size(), 0.0);
+    std::vector<std::vector<double>> gradients(gradient ? chunks.size() : 0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        pool.submit([&, c] {
+            double* chunkGradient = nullptr;
+            if (gradient) {
+                gradients[c].assign(WEIGHT_COUNT, 0.0);
+                chunkGradient = gradients[c].data();
+            }
+            losses[c] = chunkLoss(chunks[c], weights, scale, chunkGradient);
+        });
+    }
+    pool.wait();
+
+    double total = 0.0;
+    for (double chunkTotal : losses) total += chunkTotal;
+    if (gradient) {
+        gradient->assign(WEIGHT_COUNT, 0.0);
+        for (const std::vector<double>& chunkGradient : gradients) {
+            for (int i = 0; i < WEIGHT_COUNT; ++i) (*gradient)[i] += chunkGradient[i] / positionCount;
+        }
+    }
+    return total / positionCount;
+}
+
+double Dataset::fitScale(const std::vector<double>& weights, ThreadPool& pool) {
+    setTargets(0.0, 1.0);
+
+    // Golden section search; a pawn up is somewhere between a 51% and a
+    // 99% chance to win
+    const double RATIO = (std::sqrt(5.0) - 1.0) / 2.0;
+    double low = 0.0001;
+    double high = 0.05;
+    double a = high - RATIO * (high - low);
+    double b = low + RATIO * (high - low);
+    double lossA = loss(weights, a, pool, nullptr);
+    double lossB = loss(weights, b, pool, nullptr);
+    for (int i = 0; i < 40; ++i) {
+        if (lossA < lossB) {
+            high = b;
+            b = a;
+            lossB = lossA;
+            a = high - RATIO * (high - low);
+            lossA = loss(weights, a, pool, nullptr);
+        } else {
+            low = a;
+            a = b;
+            lossA = lossB;
+            b = low + RATIO * (high - low);
+            lossB = loss(weights, b, pool, nullptr);
+        }
+    }
+    return (low + high) / 2.0;
+}
+
+void writeTables(std::ostream& out, const std::vector<double>& weights) {
+    // A piece always gets its material and one bonus, so moving an amount
+    // from every bonus of a table into the material changes nothing. Keep
+    // each table's average where it is now so the material values stay
+    // comparable; the king has no material and keeps its average too.
+    std::vector<double> tuned = weights;
+    std::vector<double> current = currentWeights();
+    for (int type = 0; type < 6; ++type) {
+        bool pawn = type == static_cast<int>(PieceType::PAWN);
+        int firstSquare = pawn ? 8 : 0;  // Pawns never stand on the first and last rank
+        int lastSquare = pawn ? 56 : 64;
+        for (int phase = 0; phase < 2; ++phase) {
+            double shift = 0.0;
+            for (int square = firstSquare; square < lastSquare; ++square) {
+                int index = 2 * (BONUS_PAIRS + type * 64 + square) + phase;
+                shift += tuned[index] - current[index];
+            }
+            shift /= lastSquare - firstSquare;
+            for (int square = firstSquare; square < lastSquare; ++square) {
+                tuned[2 * (BONUS_PAIRS + type * 64 + square) + phase] -= shift;
+            }
+            if (type < 5) tuned[2 * (MATERIAL_PAIRS + type) + phase] += shift;
+        }
+    }
+
+    auto value = [&tuned](int index) { return static_cast<int>(std::lround(tuned[index])); };
+    // One value per PieceType from a run of pairs (no king when there are 5)
+    auto writeByType = [&](const char* name, int firstPair, int types, int phase) {
+        out << "const int " << name << "[6] = {";
+        for (int type = 0; type < 6; ++type) {
+            out << (type ? ", " : "") << (type < types ? value(2 * (firstPair + type) + phase) : 0);
+        }
+        out << "};\n";
+    };
+
+    out << "// PieceSquareTables.cpp\n";
+    writeByType("MIDGAME_VALUE", MATERIAL_PAIRS, 5, 0);
+    writeByType("ENDGAME_VALUE", MATERIAL_PAIRS, 5, 1);
+
+    for (int phase = 0; phase < 2; ++phase) {
+        out << "\nconst int " << (phase == 0 ? "MIDGAME_BONUS" : "ENDGAME_BONUS") << "[6][8][8] = {\n";
+        for (int type = 0; type < 6; ++type) {
+            out << "    // " << PIECE_NAMES[type] << "\n    {\n";
+            for (int row = 0; row < 8; ++row) {
+                out << "        {";
+                for (int col = 0; col < 8; ++col) {
+                    out << std::setw(4) << value(2 * (BONUS_PAIRS + type * 64 + row * 8 + col) + phase)
+                        << (col < 7 ? "," : "");
+                }
+                out << "}" << (row < 7 ? "," : "") << "\n";
+            }
+            out << "    }" << (type < 5 ? "," : "") << "\n";
+        }
+        out << "};\n";
+    }
+
+    out << "\n// Mobility.cpp\n";
+    writeByType("MIDGAME_WEIGHT", MOBILITY_PAIRS, 6, 0);
+    writeByType("ENDGAME_WEIGHT", MOBILITY_PAIRS, 6, 1);
+
+    out << "\n// PawnStructure\n"
+        << "const int DOUBLED_PENALTY = " << value(DOUBLED) << ";\n"
+        << "const int ISOLATED_PENALTY = " << value(ISOLATED) << ";\n"
+        << "const int BACKWARD_PENALTY = " << value(BACKWARD) << ";\n"
+        << "const int PASSED_BONUS[8] = {";
+    for (int rank = 0; rank < 8; ++rank) out << (rank ? ", " : "") << value(PASSED + rank);
+    out << "};\n";
+}
+
+} // namespace Tuner
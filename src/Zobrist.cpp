@@ -0,0 +1,61 @@
+#include "../include/Zobrist.h"
+
+namespace {
+
+// All keys live in one table filled once at startup
+struct ZobristTable {
+    uint64_t pieces[2][6][64];
+    uint64_t side;
+    uint64_t castling[4];
+    uint64_t enPassant[8];
+
+    ZobristTable() {
+        // SplitMix64 with a fixed seed - deterministic on every platform
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        auto next = [&state]() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+
+        for (auto& color : pieces) {
+            for (auto& type : color) {
+                for (uint64_t& key : type) {
+                    key = next();
+                }
+            }
+        }
+        side = next();
+        for (uint64_t& key : castling) key = next();
+        for (uint64_t& key : enPassant) key = next();
+    }
+};
+
+const ZobristTable& table() {
+    static const ZobristTable instance;
+    return instance;
+}
+
+} // namespace
+
+namespace Zobrist {
+
+uint64_t pieceKey(PieceType type, Color color, int square) {
+    if (type == PieceType::EMPTY || color == Color::NONE) return 0;
+    return table().pieces[color == Color::WHITE ? 0 : 1][static_cast<int>(type)][square];
+}
+
+uint64_t sideKey() {
+    return table().side;
+}
+
+uint64_t castlingKey(int right) {
+    return table().castling[right];
+}
+
+uint64_t enPassantKey(int col) {
+    return table().enPassant[col];
+}
+
+} // namespace Zobrist
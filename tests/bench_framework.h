@@ -0,0 +1,194 @@
+#pragma once
+#include "../include/PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Microbenchmark harness for hot paths.
+//
+// A benchmark body runs one operation; the harness repeats it in batches
+// sized so that a batch takes about BATCH_TIME, which keeps timer overhead
+// out of the numbers. Before measuring, batches run until two in a row
+// agree within WARMUP_TOLERANCE (or WARMUP_LIMIT runs out), so the CPU has
+// left its idle clock and the caches are warm. Then `samples` batches are
+// timed and reported as nanoseconds per operation: the median and the 10th,
+// 90th and 99th percentiles. A wide spread means a noisy machine, not a
+// slow function.
+//
+// With counters set, one more batch is run under hardware counters and
+// their counts are reported per unit of work: per operation, or per
+// generated move for move generators (run's units argument).
+//
+// Results are written as one tab-separated line per benchmark, so the
+// files of two runs can be diffed, or compared with --compare.
+class BenchFramework {
+public:
+    struct Result {
+        std::string name;
+        double median;
+        double p10;
+        double p90;
+        double p99;
+        long long batch;  // Operations per sample
+        std::string unit;                // What the counts are per
+        PerfCounters::Counts perUnit;    // Empty without counters
+    };
+
+    static constexpr double BATCH_TIME = 2e-3;       // Seconds per sample
+    static constexpr double WARMUP_TOLERANCE = 0.05;
+    static constexpr double WARMUP_LIMIT = 1.0;      // Seconds
+    static int samples;
+    static PerfCounters* counters;  // Null to time only
+
+    // Keep a value the compiler would otherwise optimise away
+    template <typename T>
+    static void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    // units: how many of unit one operation does, for the counters
+    template <typename Body>
+    static void run(const std::string& name, Body&& body, double units = 1.0, const std::string& unit = "op") {
+        print(measure(name, body, units, unit));
+    }
+
+    // Measure without printing, for bodies that write to standard output
+    template <typename Body>
+    static Result measure(const std::string& name, Body&& body, double units = 1.0, const std::string& unit = "op") {
+        // Grow the batch until it takes BATCH_TIME
+        long long batch = 1;
+        while (timeBatch(body, batch) < BATCH_TIME && batch < (1LL << 40)) {
+            batch *= 2;
+        }
+
+        // Warm up until the speed settles
+        double previous = timeBatch(body, batch);
+        double warmup = previous;
+        while (warmup < WARMUP_LIMIT) {
+            double current = timeBatch(body, batch);
+            warmup += current;
+            if (std::fabs(current - previous) <= WARMUP_TOLERANCE * previous) break;
+            previous = current;
+        }
+
+        std::vector<double> times;
+        for (int i = 0; i < samples; ++i) {
+            times.push_back(timeBatch(body, batch) * 1e9 / batch);
+        }
+        std::sort(times.begin(), times.end());
+
+        Result result{name, percentile(times, 0.5), percentile(times, 0.1), percentile(times, 0.9),
+                      percentile(times, 0.99), batch, unit, PerfCounters::Counts()};
+        if (counters) {
+            counters->start();
+            timeBatch(body, batch);
+            result.perUnit = counters->stop();
+            for (double& value : result.perUnit.values) value /= batch * units;
+        }
+        results().push_back(result);
+        return result;
+    }
+
+    static void print(const Result& result) {
+        std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.median << std::setw(12) << result.p10 << std::setw(12) << result.p90
+                  << std::setw(12) << result.p99 << std::endl;
+        if (!result.perUnit.any()) return;
+
+        // Indented under the timing, per unit of work
+        const PerfCounters::Counts& counts = result.perUnit;
+        std::cout << "    per " << result.unit << ":" << std::setprecision(2);
+        for (int i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+            if (counts.valid[i]) std::cout << "  " << counts.values[i] << " " << PerfCounters::name(static_cast<PerfCounters::Event>(i));
+        }
+        if (counts.valid[PerfCounters::CYCLES] && counts.valid[PerfCounters::INSTRUCTIONS] &&
+            counts.values[PerfCounters::CYCLES] > 0) {
+            std::cout << "  IPC " << counts.values[PerfCounters::INSTRUCTIONS] / counts.values[PerfCounters::CYCLES];
+        }
+        std::cout << std::endl;
+    }
+
+    static void print_header() {
+        std::cout << std::left << std::setw(32) << "ns per operation" << std::right << std::setw(12) << "median"
+                  << std::setw(12) << "p10" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::endl;
+    }
+
+    static bool save(const std::string& path) {
+        std::ofstream out(path);
+        out << "# name\tmedian_ns\tp10_ns\tp90_ns\tp99_ns\tbatch"
+            << "\tcycles\tinstructions\tl1d_misses\tllc_misses\tbranch_misses (per unit, - if not counted)\n"
+            << std::fixed;
+        for (const Result& result : results()) {
+            out << std::setprecision(1) << result.name << '\t' << result.median << '\t' << result.p10 << '\t'
+                << result.p90 << '\t' << result.p99 << '\t' << result.batch << std::setprecision(3);
+            for (int i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+                out << '\t';
+                if (result.perUnit.valid[i]) out << result.perUnit.values[i];
+                else out << '-';
+            }
+            out << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Median change against an earlier results file
+    static bool compare(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) return false;
+
+        std::map<std::string, double> before;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            std::string name;
+            double median;
+            if (std::getline(fields, name, '\t') && fields >> median) before[name] = median;
+        }
+
+        std::cout << "\nChange of the median against " << path << ":\n";
+        for (const Result& result : results()) {
+            auto old = before.find(result.name);
+            std::cout << std::left << std::setw(32) << result.name << std::right;
+            if (old == before.end() || old->second <= 0.0) {
+                std::cout << "         new\n";
+            } else {
+                std::cout << std::showpos << std::setw(11) << std::setprecision(1)
+                          << 100.0 * (result.median / old->second - 1.0) << "%" << std::noshowpos << "\n";
+            }
+        }
+        return true;
+    }
+
+private:
+    static std::vector<Result>& results() {
+        static std::vector<Result> all;
+        return all;
+    }
+
+    template <typename Body>
+    static double timeBatch(Body& body, long long batch) {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < batch; ++i) {
+            body();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Nearest rank
+    static double percentile(const std::vector<double>& sorted, double fraction) {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+};
+
+int BenchFramework::samples = 50;
+PerfCounters* BenchFramework::counters = nullptr;
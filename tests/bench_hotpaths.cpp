@@ -0,0 +1,201 @@
+// Microbenchmarks of the hot paths of the search and the interface.
+//
+// Usage: bench_hotpaths [--output FILE] [--compare FILE] [--samples N] [--counters]
+// Results go to bench_results.txt unless --output says otherwise; run with
+// --compare on the file of an earlier build to see what changed.
+// --counters adds hardware counters per operation (per generated move for
+// the move generator) where the system lets us read them.
+
+#include "bench_framework.h"
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/PerfCounters.h"
+#include "../include/Piece.h"
+#include "../include/Utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+struct AIHotPaths {
+    static int evaluateBoard(AI& ai, const Board& board) { return ai.evaluateBoard(board, 0); }
+    static void orderMoves(const AI& ai, std::vector<Move>& moves, const Board& board) {
+        ai.orderMoves(moves, board);
+    }
+};
+
+namespace {
+
+const char* const MIDDLEGAME = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+// Every from/to pair of the position's pieces, legal or not, as the
+// interface sees them when a player types moves
+std::vector<Move> candidateMoves(const Board& board) {
+    std::vector<Move> moves;
+    for (int fromRow = 0; fromRow < 8; ++fromRow) {
+        for (int fromCol = 0; fromCol < 8; ++fromCol) {
+            if (board.getPiece(fromRow, fromCol).getColor() != board.getGameState().currentPlayer) continue;
+            for (int toRow = 0; toRow < 8; ++toRow) {
+                for (int toCol = 0; toCol < 8; ++toCol) {
+                    moves.emplace_back(fromRow, fromCol, toRow, toCol);
+                }
+            }
+        }
+    }
+    return moves;
+}
+
+// Board::display writes to standard output; send it to /dev/null meanwhile
+class NullStdout {
+public:
+    NullStdout() : saved(dup(1)) {
+        std::cout.flush();
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, 1);
+        close(null);
+    }
+    ~NullStdout() {
+        dup2(saved, 1);
+        close(saved);
+    }
+
+private:
+    int saved;
+};
+
+void benchBoard() {
+    Board start;
+    Board middlegame;
+    middlegame.loadFEN(MIDDLEGAME);
+    Color toMove = middlegame.getGameState().currentPlayer;
+
+    std::vector<Move> candidates = candidateMoves(middlegame);
+    size_t next = 0;
+    BenchFramework::run("Board::isValidMove", [&] {
+        BenchFramework::keep(middlegame.isValidMove(candidates[next]));
+        if (++next == candidates.size()) next = 0;
+    });
+
+    double startMoves = static_cast<double>(start.getAllLegalMoves(Color::WHITE).size());
+    BenchFramework::run("Board::getAllLegalMoves start", [&] {
+        BenchFramework::keep(start.getAllLegalMoves(Color::WHITE));
+    }, startMoves, "move");
+    double middlegameMoves = static_cast<double>(middlegame.getAllLegalMoves(toMove).size());
+    BenchFramework::run("Board::getAllLegalMoves middle", [&] {
+        BenchFramework::keep(middlegame.getAllLegalMoves(toMove));
+    }, middlegameMoves, "move");
+
+    BenchFramework::run("Board::isInCheck", [&] {
+        BenchFramework::keep(middlegame.isInCheck(toMove));
+    });
+
+    // Boards have no unmake, so every move is made on a copy
+    std::vector<Move> legal = middlegame.getAllLegalMoves(toMove);
+    next = 0;
+    BenchFramework::run("Board copy", [&] {
+        Board copy = middlegame;
+        BenchFramework::keep(copy);
+    });
+    BenchFramework::run("Board copy + makeMove", [&] {
+        Board copy = middlegame;
+        BenchFramework::keep(copy.makeMove(legal[next]));
+        if (++next == legal.size()) next = 0;
+    });
+
+    BenchFramework::Result display;
+    {
+        NullStdout quiet;
+        display = BenchFramework::measure("Board::display", [&] {
+            middlegame.display();
+        });
+    }
+    BenchFramework::print(display);
+}
+
+void benchAI() {
+    Board middlegame;
+    middlegame.loadFEN(MIDDLEGAME);
+    Color toMove = middlegame.getGameState().currentPlayer;
+    AI ai(AILevel::HARD, toMove);
+
+    BenchFramework::run("AI::evaluateBoard", [&] {
+        BenchFramework::keep(AIHotPaths::evaluateBoard(ai, middlegame));
+    });
+
+    std::vector<Move> legal = middlegame.getAllLegalMoves(toMove);
+    std::vector<Move> moves;
+    BenchFramework::run("AI::orderMoves", [&] {
+        moves = legal;
+        AIHotPaths::orderMoves(ai, moves, middlegame);
+        BenchFramework::keep(moves);
+    });
+}
+
+void benchPieceAndUtils() {
+    const Piece pieces[] = {Piece(PieceType::PAWN, Color::WHITE), Piece(PieceType::KNIGHT, Color::WHITE),
+                            Piece(PieceType::BISHOP, Color::BLACK), Piece(PieceType::ROOK, Color::BLACK),
+                            Piece(PieceType::QUEEN, Color::WHITE), Piece(PieceType::KING, Color::BLACK)};
+    int square = 0;
+    BenchFramework::run("Piece::canMoveTo", [&] {
+        const Piece& piece = pieces[square % 6];
+        int from = square % 64;
+        int to = (square * 37 + 11) % 64;
+        BenchFramework::keep(piece.canMoveTo(from / 8, from % 8, to / 8, to % 8));
+        ++square;
+    });
+
+    const std::string inputs[] = {"e2e4", "e2 e4", "g1-f3", "E7E5", "a7a8", "z9z9", "e2"};
+    size_t next = 0;
+    BenchFramework::run("ChessUtils::parseMove", [&] {
+        int fromRow, fromCol, toRow, toCol;
+        BenchFramework::keep(ChessUtils::parseMove(inputs[next], fromRow, fromCol, toRow, toCol));
+        if (++next == sizeof(inputs) / sizeof(inputs[0])) next = 0;
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string outputPath = "bench_results.txt";
+    std::string comparePath;
+    bool counters = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) outputPath = argv[++i];
+        else if (arg == "--compare" && i + 1 < argc) comparePath = argv[++i];
+        else if (arg == "--samples" && i + 1 < argc) BenchFramework::samples = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--counters") counters = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--output FILE] [--compare FILE] [--samples N] [--counters]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    PerfCounters hardware;
+    if (counters) {
+        if (hardware.available()) {
+            BenchFramework::counters = &hardware;
+        } else {
+            std::cout << "Hardware counters unavailable (" << hardware.problem() << "), timing only\n" << std::endl;
+        }
+    }
+
+    BenchFramework::print_header();
+    benchBoard();
+    benchAI();
+    benchPieceAndUtils();
+
+    if (!BenchFramework::save(outputPath)) {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "\nResults written to " << outputPath << std::endl;
+    if (!comparePath.empty() && !BenchFramework::compare(comparePath)) {
+        std::cerr << "Cannot read " << comparePath << std::endl;
+        return 1;
+    }
+    return 0;
+}
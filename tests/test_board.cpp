@@ -1,6 +1,26 @@
 #include "test_framework.h"
+#include "../include/AsyncFileWriter.h"
+#include "../include/Attacks.h"
 #include "../include/Board.h"
+#include "../include/BoardRenderer.h"
+#include "../include/Evaluation.h"
+#include "../include/Mobility.h"
+#include "../include/PackedPosition.h"
+#include "../include/PawnStructure.h"
+#include "../include/PieceSquareTables.h"
+#include "../include/Spectator.h"
+#include "../include/SpscQueue.h"
+#include "../include/ThreadPool.h"
+#include "../include/TrainingData.h"
+#include "../include/Tuner.h"
+#include "../include/Zobrist.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 void test_board_initialization() {
     Board board;
@@ -66,6 +86,10 @@ void test_basic_move_validation() {
     Move invalidMove1(6, 4, 3, 4);  // e2 to e5 (too far)
     TestFramework::assert_true(!board.isValidMove(invalidMove1), "Pawn cannot move three squares");
     
+    Board blocked;
+    blocked.loadFEN("rnbqkbnr/pppppppp/8/8/8/4N3/PPPPPPPP/R1BQKBNR w KQkq - 0 1");
+    TestFramework::assert_true(!blocked.isValidMove(Move(6, 4, 4, 4)), "Pawn cannot jump over a piece");
+    
     Move invalidMove2(6, 4, 6, 5);  // e2 to f2 (sideways)
     TestFramework::assert_true(!board.isValidMove(invalidMove2), "Pawn cannot move sideways");
     
@@ -173,6 +197,560 @@ void test_board_reset() {
     TestFramework::assert_equal(static_cast<int>(Color::WHITE), static_cast<int>(board.getGameState().currentPlayer), "White to move again");
 }
 
+void test_side_to_move_check() {
+    Board board;
+    
+    // Fool's mate: 1. f3 e5 2. g4 Qh4#
+    board.makeMove(Move(6, 5, 5, 5));
+    board.makeMove(Move(1, 4, 3, 4));
+    board.makeMove(Move(6, 6, 4, 6));
+    board.makeMove(Move(0, 3, 4, 7));
+    
+    TestFramework::assert_true(board.isInCheck(Color::WHITE), "Side to move is seen in check");
+    TestFramework::assert_true(board.isCheckmate(Color::WHITE), "Fool's mate is checkmate");
+    TestFramework::assert_equal(0, static_cast<int>(board.getAllLegalMoves(Color::WHITE).size()), "No legal moves when mated");
+    TestFramework::assert_true(board.isSquareAttacked(5, 6, Color::BLACK), "Queen on h4 attacks g3");
+    TestFramework::assert_true(!board.isSquareAttacked(5, 3, Color::BLACK), "d3 is not attacked by black");
+}
+
+void test_special_moves() {
+    Board board;
+    
+    // Clear f1 and g1, then castle kingside
+    board.setPiece(7, 5, Piece());
+    board.setPiece(7, 6, Piece());
+    Move castle(7, 4, 7, 6);
+    TestFramework::assert_true(board.makeMove(castle), "White can castle kingside");
+    TestFramework::assert_equal(static_cast<int>(PieceType::ROOK), static_cast<int>(board.getPiece(7, 5).getType()), "Rook moved to f1");
+    TestFramework::assert_true(!board.getGameState().whiteCanCastleKingside, "Castling right used up");
+    
+    // En passant: 1... a6 2. e4 a5 3. e5 d5 4. exd6
+    board.resetToStartingPosition();
+    board.makeMove(Move(6, 4, 4, 4));
+    board.makeMove(Move(1, 0, 2, 0));
+    board.makeMove(Move(4, 4, 3, 4));
+    board.makeMove(Move(1, 3, 3, 3));
+    TestFramework::assert_equal(3, board.getGameState().enPassantCol, "Double pawn push allows en passant");
+    TestFramework::assert_true(board.makeMove(Move(3, 4, 2, 3)), "En passant capture is legal");
+    TestFramework::assert_true(board.getPiece(3, 3).isEmpty(), "En passant removes the captured pawn");
+    
+    // Underpromotion
+    board.resetToStartingPosition();
+    board.setPiece(1, 0, Piece(PieceType::PAWN, Color::WHITE));
+    board.setPiece(0, 0, Piece());
+    board.setPiece(0, 1, Piece());
+    Move promotion(1, 0, 0, 0);
+    promotion.promotionPiece = PieceType::KNIGHT;
+    board.makeMove(promotion);
+    TestFramework::assert_equal(static_cast<int>(PieceType::KNIGHT), static_cast<int>(board.getPiece(0, 0).getType()), "Pawn promotes to the requested piece");
+}
+
+void test_hash_key() {
+    Board board;
+    Board other;
+    TestFramework::assert_true(board.getHashKey() == other.getHashKey(), "Same position gives same key");
+    
+    // Transposition: 1. Nf3 Nf6 2. Nc3 and 1. Nc3 Nf6 2. Nf3
+    board.makeMove(Move(7, 6, 5, 5));
+    board.makeMove(Move(0, 6, 2, 5));
+    board.makeMove(Move(7, 1, 5, 2));
+    other.makeMove(Move(7, 1, 5, 2));
+    other.makeMove(Move(0, 6, 2, 5));
+    other.makeMove(Move(7, 6, 5, 5));
+    TestFramework::assert_true(board.getHashKey() == other.getHashKey(), "Transposed move orders give same key");
+    
+    board.setCurrentPlayer(Color::WHITE);
+    TestFramework::assert_true(board.getHashKey() != other.getHashKey(), "Side to move changes the key");
+}
+
+void test_fen() {
+    Board board;
+    const std::string start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    TestFramework::assert_equal(start, board.toFEN(), "Starting position FEN");
+    
+    const std::string fen = "r3k2r/pp1b1ppp/8/2pP4/8/8/PPP2PPP/R3K2R w Kq c6 0 12";
+    TestFramework::assert_true(board.loadFEN(fen), "FEN loads");
+    TestFramework::assert_equal(fen, board.toFEN(), "FEN round-trips");
+    TestFramework::assert_equal(2, board.getGameState().enPassantCol, "En passant file is read");
+    TestFramework::assert_true(!board.getGameState().whiteCanCastleQueenside, "Missing castling right is read");
+    
+    TestFramework::assert_true(!board.loadFEN("8/8/8 w - - 0 1"), "Short placement is rejected");
+    TestFramework::assert_true(!board.loadFEN("8/8/8/8/8/8/8/8 w - - 0 1"), "Position without kings is rejected");
+}
+
+void test_draw_detection() {
+    Board board;
+    TestFramework::assert_true(!board.isDraw(), "Starting position is not a draw");
+    
+    board.loadFEN("8/8/4k3/8/8/3NK3/8/8 w - - 0 1");
+    TestFramework::assert_true(board.isDraw(), "King and knight against king is a draw");
+    
+    board.loadFEN("8/8/4k3/8/8/3RK3/8/8 w - - 0 1");
+    TestFramework::assert_true(!board.isDraw(), "King and rook can still mate");
+    
+    board.loadFEN("8/8/4k3/8/8/3RK3/8/8 w - - 100 80");
+    TestFramework::assert_true(board.isDraw(), "Fifty-move rule");
+}
+
+void test_incremental_keys() {
+    Board board;
+    
+    // Castling, en passant and promotion all change several squares at once
+    board.loadFEN("r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+    board.makeMove(Move(3, 4, 2, 3));  // exd6 e.p.
+    board.makeMove(Move(0, 4, 0, 6));  // O-O
+    Move promotion(1, 1, 0, 0);        // bxa8=N
+    promotion.promotionPiece = PieceType::KNIGHT;
+    board.makeMove(promotion);
+    
+    Board reference;
+    reference.loadFEN(board.toFEN());
+    TestFramework::assert_true(board.getHashKey() == reference.getHashKey(), "Incremental key matches a fresh board");
+    TestFramework::assert_true(board.getPawnKey() == reference.getPawnKey(), "Incremental pawn key matches a fresh board");
+    TestFramework::assert_true(board.getPawnBitboard(Color::WHITE) == (1ULL << Zobrist::squareIndex(2, 3)), "Pawn bitboard follows captures and promotion");
+    TestFramework::assert_true(board.getPawnBitboard(Color::BLACK) == 0, "Captured pawn leaves the bitboard");
+    
+    // Piece moves leave the pawn key alone
+    uint64_t pawnKey = board.getPawnKey();
+    board.makeMove(Move(7, 4, 7, 3));
+    TestFramework::assert_true(board.getPawnKey() == pawnKey, "King move keeps the pawn key");
+    board.setPiece(4, 4, Piece(PieceType::PAWN, Color::BLACK));
+    TestFramework::assert_true(board.getPawnKey() != pawnKey, "Adding a pawn changes the pawn key");
+}
+
+void test_pawn_structure() {
+    Board board;
+    auto evaluate = [&board](const std::string& fen) {
+        board.loadFEN(fen);
+        return PawnStructure::evaluate(board.getPawnBitboard(Color::WHITE), board.getPawnBitboard(Color::BLACK));
+    };
+    
+    TestFramework::assert_equal(0, evaluate("4k3/pppppppp/8/8/8/8/PPPPPPPP/4K3 w - - 0 1"), "Symmetric structure scores 0");
+    TestFramework::assert_equal(PawnStructure::PASSED_BONUS[5], evaluate("4k3/8/2P5/8/8/8/8/4K3 w - - 0 1") + PawnStructure::ISOLATED_PENALTY, "Lone pawn is passed and isolated");
+    TestFramework::assert_equal(-PawnStructure::PASSED_BONUS[5], evaluate("4k3/8/8/8/8/2p5/8/4K3 w - - 0 1") - PawnStructure::ISOLATED_PENALTY, "Black passed pawn counts for black");
+    TestFramework::assert_true(evaluate("4k3/8/8/8/8/8/P1P5/4K3 w - - 0 1") > evaluate("4k3/8/8/8/8/2P5/2P5/4K3 w - - 0 1"), "Doubled pawns are worse");
+    
+    // d3 has no pawn beside or behind it and c5 guards d4; on d4 it stands next to e4
+    int backward = evaluate("4k3/8/8/2p5/4P3/3P4/8/4K3 w - - 0 1");
+    int supported = evaluate("4k3/8/8/2p5/3PP3/8/8/4K3 w - - 0 1");
+    TestFramework::assert_equal(PawnStructure::BACKWARD_PENALTY, supported - backward, "Backward pawn is penalized");
+}
+
+void test_tapered_evaluation() {
+    Board board;
+    TestFramework::assert_equal(PieceSquareTables::MAX_PHASE, board.getPhase(), "Starting position is pure midgame");
+    TestFramework::assert_equal(0, board.getMidgameScore(), "Starting position is balanced");
+    
+    // Sums follow captures and promotions
+    board.loadFEN("r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+    board.makeMove(Move(3, 4, 2, 3));
+    Move promotion(1, 1, 0, 0);
+    promotion.promotionPiece = PieceType::QUEEN;
+    board.makeMove(Move(0, 4, 0, 6));
+    board.makeMove(promotion);
+    Board reference;
+    reference.loadFEN(board.toFEN());
+    TestFramework::assert_equal(reference.getMidgameScore(), board.getMidgameScore(), "Incremental midgame sum matches a fresh board");
+    TestFramework::assert_equal(reference.getEndgameScore(), board.getEndgameScore(), "Incremental endgame sum matches a fresh board");
+    TestFramework::assert_equal(reference.getPhase(), board.getPhase(), "Incremental phase matches a fresh board");
+    
+    // Without pieces the king is scored by the endgame table only
+    board.loadFEN("4k3/8/8/8/3K4/8/8/8 w - - 0 1");
+    int central = PieceSquareTables::taper(board.getMidgameScore(), board.getEndgameScore(), board.getPhase());
+    board.loadFEN("4k3/8/8/8/8/8/8/K7 w - - 0 1");
+    int corner = PieceSquareTables::taper(board.getMidgameScore(), board.getEndgameScore(), board.getPhase());
+    TestFramework::assert_equal(0, board.getPhase(), "Kings only is pure endgame");
+    TestFramework::assert_true(central > corner, "Endgame king prefers the centre");
+    
+    TestFramework::assert_equal(15, PieceSquareTables::taper(10, 20, 12), "Half phase blends evenly");
+    TestFramework::assert_equal(10, PieceSquareTables::taper(10, 20, 30), "Phase above the maximum counts as midgame");
+}
+
+void test_attack_bitboards() {
+    Board board;
+    TestFramework::assert_equal(32, Attacks::count(board.getOccupancy()), "Starting position occupies 32 squares");
+    TestFramework::assert_equal(16, Attacks::count(board.getColorBitboard(Color::BLACK)), "Black has 16 pieces");
+    TestFramework::assert_true(board.getPieceBitboard(Color::WHITE, PieceType::KNIGHT) == ((1ULL << 57) | (1ULL << 62)), "White knights start on b1 and g1");
+    board.makeMove(Move(7, 6, 5, 5));
+    TestFramework::assert_true(board.getPieceBitboard(Color::WHITE, PieceType::KNIGHT) == ((1ULL << 57) | (1ULL << 45)), "Knight bitboard follows Nf3");
+    
+    TestFramework::assert_equal(2, Attacks::count(Attacks::knight(56)), "Knight in the corner attacks 2 squares");
+    TestFramework::assert_equal(3, Attacks::count(Attacks::king(0)), "King in the corner attacks 3 squares");
+    TestFramework::assert_equal(14, Attacks::count(Attacks::rook(27, 0)), "Rook on an empty board attacks 14 squares");
+    TestFramework::assert_equal(13, Attacks::count(Attacks::bishop(27, 0)), "Central bishop on an empty board attacks 13 squares");
+    TestFramework::assert_equal(9, Attacks::count(Attacks::rook(56, 1ULL << 40)), "Rook ray stops at and includes the blocker");
+    TestFramework::assert_true(Attacks::pawns(1ULL << 52, Color::WHITE) == ((1ULL << 43) | (1ULL << 45)), "White e2 pawn attacks d3 and f3");
+    TestFramework::assert_true(Attacks::pawns(1ULL << 8, Color::BLACK) == (1ULL << 17), "Black a7 pawn attacks b6 only");
+}
+
+void test_mobility_and_king_safety() {
+    Board board;
+    Mobility::Score score = Mobility::evaluate(board);
+    TestFramework::assert_true(score.midgame == 0 && score.endgame == 0, "Starting position is balanced");
+    
+    board.loadFEN("4k3/8/8/8/3N4/8/8/4K3 w - - 0 1");
+    int central = Mobility::evaluate(board).midgame;
+    board.loadFEN("4k3/8/8/8/8/8/8/N3K3 w - - 0 1");
+    TestFramework::assert_true(central > Mobility::evaluate(board).midgame, "Central knight is more mobile than a cornered one");
+    board.loadFEN("4k3/8/2p1p3/8/3N4/8/8/4K3 w - - 0 1");
+    TestFramework::assert_true(central > Mobility::evaluate(board).midgame, "Squares attacked by pawns don't count");
+    
+    // Pawns in front of the white king on e1; black's king on a8 is covered
+    board.loadFEN("k7/pp6/8/8/8/8/3PPP2/4K3 w - - 0 1");
+    int covered = Mobility::evaluate(board).midgame;
+    board.loadFEN("k7/pp6/8/4p3/8/8/3P1P2/4K3 w - - 0 1");
+    TestFramework::assert_equal(Mobility::SEMI_OPEN_FILE_PENALTY, covered - Mobility::evaluate(board).midgame, "Semi-open file next to the king");
+    board.loadFEN("k7/pp6/8/8/8/8/3P1P2/4K3 w - - 0 1");
+    TestFramework::assert_equal(Mobility::OPEN_FILE_PENALTY, covered - Mobility::evaluate(board).midgame, "Open file next to the king");
+    
+    // Queen and knight both hitting g7 next to the black king, or the
+    // knight on b1 instead - the same mobility, one attacker less
+    board.loadFEN("4N1k1/5ppp/8/8/6Q1/8/8/7K w - - 0 1");
+    int twoAttackers = Mobility::evaluate(board).midgame;
+    board.loadFEN("6k1/5ppp/8/8/6Q1/8/8/1N5K w - - 0 1");
+    int oneAttacker = Mobility::evaluate(board).midgame;
+    int units = Mobility::KING_ATTACK_WEIGHT[static_cast<int>(PieceType::QUEEN)] +
+                Mobility::KING_ATTACK_WEIGHT[static_cast<int>(PieceType::KNIGHT)];
+    TestFramework::assert_equal(Mobility::kingDanger(units), twoAttackers - oneAttacker, "Two attackers on the king zone add danger");
+    TestFramework::assert_equal(0, Mobility::kingDanger(0), "No attack units, no danger");
+    TestFramework::assert_equal(Mobility::MAX_KING_DANGER, Mobility::kingDanger(1000), "King danger is capped");
+}
+
+void test_packed_positions() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/1P6/8/3pP3/8/8/8/R3K2R w Kq d6 12 40",
+        "8/8/4k3/8/8/3K4/8/8 b - - 99 120",
+    };
+    bool roundTrip = true;
+    for (const char* fen : fens) {
+        Board board, unpacked;
+        PackedPosition packed;
+        board.loadFEN(fen);
+        if (!PackedPositions::pack(board, packed) || !PackedPositions::unpack(packed, unpacked) ||
+            unpacked.toFEN() != fen) {
+            roundTrip = false;
+        }
+    }
+    TestFramework::assert_true(roundTrip, "Packing and unpacking keeps pieces, castling, en passant and counters");
+    
+    Board board;
+    PackedPosition packed;
+    PackedPositions::pack(board, packed);
+    TestFramework::assert_equal(32, Attacks::count(packed.occupancy), "Starting position packs 32 pieces");
+    packed.pieces[0] = 0x77;  // Type 7 doesn't exist
+    TestFramework::assert_true(!PackedPositions::unpack(packed, board), "Bad piece code is rejected");
+}
+
+void test_training_data() {
+    Board board, unpacked;
+    board.loadFEN("r3k2r/1P6/8/3pP3/8/8/8/R3K2R w Kq d6 0 40");
+    TrainingPosition position;
+    TestFramework::assert_true(TrainingData::pack(board, 55, 1, position), "Position packs with score and result");
+    TestFramework::assert_true(TrainingData::unpack(position, unpacked) && unpacked.toFEN() == board.toFEN(),
+                               "Unpacking restores the board");
+    TestFramework::assert_equal(55, static_cast<int>(position.score), "Score is kept");
+    TrainingData::pack(board, 1000000, -1, position);
+    TestFramework::assert_equal(TrainingData::MAX_SCORE, static_cast<int>(position.score), "Mate scores are clamped");
+    TestFramework::assert_equal(-1, static_cast<int>(position.result), "Result is kept");
+    
+    // Small buffers, so the writer thread takes many of them
+    const std::string rawPath = "test_async.tmp";
+    AsyncFileWriter raw(100);
+    TestFramework::assert_true(raw.open(rawPath), "Async writer opens a file");
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        std::string line = std::to_string(i) + "\n";
+        raw.write(line.data(), line.size());
+        expected += line;
+    }
+    TestFramework::assert_true(raw.close(), "Async writer closes cleanly");
+    MappedFile rawFile;
+    rawFile.open(rawPath);
+    TestFramework::assert_true(rawFile.size() == expected.size() &&
+                               std::string(reinterpret_cast<const char*>(rawFile.getData()), rawFile.size()) == expected,
+                               "Async writes reach the file complete and in order");
+    std::remove(rawPath.c_str());
+    
+    const std::string path = "test_training.tmp";
+    const int count = 5000;  // Several buffers' worth
+    {
+        TrainingData::Writer writer(path);
+        for (int i = 0; i < count; ++i) {
+            TrainingData::pack(board, i, i % 3 - 1, position);
+            writer.add(position);
+        }
+        TestFramework::assert_true(writer.finish(), "Training data is written");
+    }
+    MappedFile file;
+    const TrainingPosition* records = nullptr;
+    size_t stored = 0;
+    TestFramework::assert_true(file.open(path) && TrainingData::records(file, records, stored),
+                               "Training data file maps");
+    TestFramework::assert_equal(count, static_cast<int>(stored), "Header counts every record");
+    bool allMatch = stored == static_cast<size_t>(count);
+    for (size_t i = 0; allMatch && i < stored; ++i) {
+        allMatch = records[i].score == static_cast<int>(i) && records[i].result == static_cast<int>(i % 3) - 1 &&
+                   records[i].occupancy == position.occupancy;
+    }
+    TestFramework::assert_true(allMatch, "Records read back in the order written");
+    std::remove(path.c_str());
+}
+
+void test_evaluation_tuning() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+        "6k1/5ppp/8/8/6Q1/8/5PPP/1N5K w - - 0 1",
+        "8/2k5/3p4/p2P1p2/P2P1P2/8/8/4K3 b - - 0 1",
+        "r4rk1/pp3ppp/2n5/3q4/3P4/2Q2N2/PP3PPP/R4RK1 b - - 0 15",
+    };
+    const int results[] = {0, 1, 1, -1, 0};
+    const size_t count = sizeof(fens) / sizeof(fens[0]);
+    
+    std::vector<TrainingPosition> positions(count);
+    std::vector<PackedPosition> packed(count);
+    for (size_t i = 0; i < count; ++i) {
+        Board board;
+        board.loadFEN(fens[i]);
+        TrainingData::pack(board, 0, results[i], positions[i]);
+        TrainingData::toPacked(positions[i], packed[i]);
+    }
+    std::vector<int> scores(count);
+    Evaluation::evaluateBatch(packed.data(), count, scores.data());
+    
+    ThreadPool pool(2);
+    Tuner::Dataset data;
+    data.load(positions.data(), count, pool);
+    std::vector<double> weights = Tuner::currentWeights();
+    bool matches = data.size() == count;
+    for (size_t i = 0; matches && i < count; ++i) {
+        matches = std::fabs(data.evaluate(i, weights) - scores[i]) < 1.0;  // The evaluation rounds
+    }
+    TestFramework::assert_true(matches, "Evaluation terms reproduce the evaluation");
+    
+    // The gradient against central differences, for a material, a
+    // piece-square, a mobility and a pawn weight
+    const double scale = 0.01;
+    std::vector<double> gradient;
+    double loss = data.loss(weights, scale, pool, &gradient);
+    const int checked[] = {2 * (Tuner::MATERIAL_PAIRS + 2), 2 * (Tuner::BONUS_PAIRS + 12) + 1,
+                           2 * (Tuner::MOBILITY_PAIRS + 3), Tuner::PASSED + 4};
+    bool exact = true;
+    for (int index : checked) {
+        std::vector<double> changed = weights;
+        changed[index] += 0.01;
+        double up = data.loss(changed, scale, pool, nullptr);
+        changed[index] -= 0.02;
+        double down = data.loss(changed, scale, pool, nullptr);
+        double numeric = (up - down) / 0.02;
+        if (std::fabs(numeric - gradient[index]) > 1e-6 + 1e-3 * std::fabs(numeric)) exact = false;
+    }
+    TestFramework::assert_true(exact, "Loss gradient matches finite differences");
+    
+    std::vector<double> stepped = weights;
+    for (size_t i = 0; i < stepped.size(); ++i) stepped[i] -= 100.0 * gradient[i];
+    TestFramework::assert_true(data.loss(stepped, scale, pool, nullptr) < loss, "A step down the gradient lowers the loss");
+    
+    std::ostringstream tables;
+    Tuner::writeTables(tables, weights);
+    TestFramework::assert_true(tables.str().find("const int MIDGAME_VALUE[6] = {100, 500, 320, 330, 900, 0};") !=
+                               std::string::npos, "Untuned weights print as the current tables");
+}
+
+void test_batch_evaluation() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+        "6k1/5ppp/8/8/6Q1/8/5PPP/1N5K w - - 0 1",
+        "8/2k5/3p4/p2P1p2/P2P1P2/8/8/4K3 b - - 0 1",
+        "4k3/8/8/8/8/8/8/4K3 w - - 0 1",
+    };
+    const size_t count = sizeof(fens) / sizeof(fens[0]);
+    
+    std::vector<PackedPosition> positions(count);
+    std::vector<int> expected(count);
+    for (size_t i = 0; i < count; ++i) {
+        Board board;
+        board.loadFEN(fens[i]);
+        PackedPositions::pack(board, positions[i]);
+        Mobility::Score mobility = Mobility::evaluate(board);
+        expected[i] = PieceSquareTables::taper(board.getMidgameScore() + mobility.midgame,
+                                               board.getEndgameScore() + mobility.endgame, board.getPhase()) +
+                      PawnStructure::evaluate(board.getPawnBitboard(Color::WHITE), board.getPawnBitboard(Color::BLACK));
+    }
+    
+    std::vector<int> scores(count);
+    Evaluation::evaluateBatch(positions.data(), count, scores.data());
+    TestFramework::assert_true(scores == expected, "Batch scores match the evaluation of each board");
+    
+    // More positions than one chunk
+    std::vector<PackedPosition> many;
+    for (size_t i = 0; i < Evaluation::BATCH_CHUNK + 3; ++i) many.push_back(positions[i % count]);
+    std::vector<int> manyScores(many.size());
+    Evaluation::evaluateBatch(many.data(), many.size(), manyScores.data());
+    bool allMatch = true;
+    for (size_t i = 0; i < many.size(); ++i) {
+        if (manyScores[i] != expected[i % count]) allMatch = false;
+    }
+    TestFramework::assert_true(allMatch, "Batches longer than a chunk are scored completely");
+}
+
+void test_board_rendering() {
+    Board board;
+    BoardRenderer renderer(-1);  // Frames are built, never written
+    
+    renderer.drawBoard(board);
+    std::string frame(renderer.frame());
+    TestFramework::assert_equal(64, renderer.getSquaresDrawn(), "Full frame draws every square");
+    TestFramework::assert_true(frame.find("♜") != std::string::npos && frame.find("♙") != std::string::npos,
+                               "Full frame has piece symbols");
+    TestFramework::assert_true(frame.find("Current player: White") != std::string::npos, "Full frame has the status line");
+    TestFramework::assert_true(renderer.flush(), "Flush without a terminal succeeds");
+    TestFramework::assert_true(renderer.frame().empty(), "Flush starts a new frame");
+    
+    TestFramework::assert_equal(std::string("♔"), std::string(Piece(PieceType::KING, Color::WHITE).getSymbolView()), "Symbol view of white king");
+    TestFramework::assert_equal(std::string(" "), std::string(Piece().getSymbolView()), "Symbol view of empty square");
+    
+    // First screen is drawn whole, the next only repaints what moved
+    renderer.setScreenLines(40);  // Room under the board, as on a tall terminal
+    renderer.updateScreen(board, "Header\n\n");
+    TestFramework::assert_equal(64, renderer.getSquaresDrawn(), "First screen draws every square");
+    TestFramework::assert_true(renderer.frame().find("\033[2J") != std::string::npos, "First screen clears the terminal");
+    size_t fullSize = renderer.frame().size();
+    renderer.flush();
+    
+    board.makeMove(Move(6, 4, 4, 4));  // e2-e4
+    renderer.updateScreen(board, "Header\n\n");
+    frame = std::string(renderer.frame());
+    TestFramework::assert_equal(2, renderer.getSquaresDrawn(), "A quiet move repaints two squares");
+    TestFramework::assert_true(frame.find("\033[2J") == std::string::npos, "Update doesn't clear the terminal");
+    TestFramework::assert_true(frame.find("\033[14;41H") != std::string::npos, "e4 is repainted in place");
+    TestFramework::assert_true(frame.find("Current player: Black") != std::string::npos, "Update redraws the status line");
+    TestFramework::assert_true(frame.size() < fullSize / 4, "Update is much smaller than a full screen");
+    renderer.flush();
+    
+    renderer.updateScreen(board, "Header\n\n");
+    TestFramework::assert_equal(0, renderer.getSquaresDrawn(), "Nothing changed, nothing repainted");
+    renderer.flush();
+    
+    renderer.updateScreen(board, "Other header\n\n");
+    TestFramework::assert_equal(64, renderer.getSquaresDrawn(), "A new header redraws the screen");
+    renderer.flush();
+    
+    renderer.invalidate();
+    renderer.updateScreen(board, "Other header\n\n");
+    TestFramework::assert_equal(64, renderer.getSquaresDrawn(), "Invalidate redraws the screen");
+    renderer.flush();
+    
+    // Output under the board: a few lines leave it in place, enough to
+    // go past the last line (here 2 + 22 + 16 = 40) scrolled it
+    board.makeMove(Move(1, 4, 3, 4));  // e7-e5
+    renderer.printedBelow("AI is thinking...\nAI moves: e7e5\nPress Enter to continue...\n");
+    renderer.updateScreen(board, "Other header\n\n");
+    TestFramework::assert_equal(2, renderer.getSquaresDrawn(), "A few lines below keep the update incremental");
+    renderer.flush();
+    
+    renderer.printedBelow(std::string(14, '\n'));
+    renderer.printedBelow(std::string(200, 'x'));  // Wraps twice, past the last line
+    renderer.updateScreen(board, "Other header\n\n");
+    TestFramework::assert_equal(64, renderer.getSquaresDrawn(), "Output that scrolled the screen redraws it whole");
+    TestFramework::assert_true(renderer.frame().find("\033[2J") != std::string::npos, "The scrolled screen is cleared first");
+    renderer.flush();
+    
+    renderer.setScreenLines(BoardRenderer::DEFAULT_SCREEN_LINES);
+    renderer.updateScreen(board, "Other header\n\n");
+    TestFramework::assert_equal(64, renderer.getSquaresDrawn(), "A 24 line terminal has no room, every frame is whole");
+}
+
+void test_spectator() {
+    SpscQueue<int, 4> queue;
+    int value = 0;
+    TestFramework::assert_true(!queue.tryPop(value), "New queue is empty");
+    for (int i = 1; i <= 4; ++i) queue.tryPush(i);
+    TestFramework::assert_true(!queue.tryPush(5), "Full queue refuses a push");
+    TestFramework::assert_true(queue.tryPop(value) && value == 1, "Queue pops in order");
+    TestFramework::assert_true(queue.tryPush(5), "Popping makes room");
+    int last = 0;
+    while (queue.tryPop(value)) last = value;
+    TestFramework::assert_equal(5, last, "Queue wraps around");
+    
+    // Producer and consumer on separate threads see every item in order
+    SpscQueue<int, 64> shared;
+    const int items = 100000;
+    std::thread producer([&] {
+        for (int i = 0; i < items; ++i) {
+            while (!shared.tryPush(i)) std::this_thread::yield();
+        }
+    });
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < items) {
+        if (!shared.tryPop(value)) continue;
+        if (value != expected) inOrder = false;
+        ++expected;
+    }
+    producer.join();
+    TestFramework::assert_true(inOrder, "Queue between threads keeps every item in order");
+    
+    Spectator spectator(2, 50, -1);
+    int first = spectator.attach();
+    int second = spectator.attach();
+    TestFramework::assert_true(first == 0 && second == 1, "Each game gets its own board");
+    TestFramework::assert_equal(-1, spectator.attach(), "No board left for a third game");
+    spectator.detach(first);
+    TestFramework::assert_equal(first, spectator.attach(), "A detached board is reused");
+    
+    // Publishing never waits - without a render thread the queue fills up
+    BoardSnapshot snapshot{};
+    Board board;
+    PackedPositions::pack(board, snapshot.position);
+    snapshot.game = 1;
+    int accepted = 0;
+    for (size_t i = 0; i < Spectator::QUEUE_SIZE + 10; ++i) {
+        if (spectator.publish(first, snapshot)) ++accepted;
+    }
+    TestFramework::assert_equal(static_cast<int>(Spectator::QUEUE_SIZE), accepted, "Full board queue drops snapshots");
+    TestFramework::assert_equal(10, static_cast<int>(spectator.getDropped()), "Dropped snapshots are counted");
+    TestFramework::assert_true(!spectator.publish(5, snapshot), "Publishing to a bad board is ignored");
+    
+    spectator.start();
+    spectator.publish(second, snapshot);
+    spectator.stop();
+    TestFramework::assert_true(spectator.getFramesDrawn() >= 1, "Render thread draws frames");
+    TestFramework::assert_true(spectator.publish(first, snapshot), "Render thread drained the queues");
+}
+
+void test_thread_pool() {
+    // Tasks that submit subtasks: wait() must not return before the
+    // subtasks, however quickly other workers steal them
+    ThreadPool pool(4);
+    const int rounds = 200;
+    const int parents = 8;
+    const int children = 16;
+    std::atomic<int> finished{0};
+    bool allCounted = true;
+    for (int round = 1; round <= rounds && allCounted; ++round) {
+        for (int i = 0; i < parents; ++i) {
+            pool.submit([&] {
+                for (int j = 0; j < children; ++j) {
+                    pool.submit([&] { ++finished; });
+                }
+                std::this_thread::yield();  // Give the thieves time to finish the subtasks
+                ++finished;
+            });
+        }
+        pool.wait();
+        allCounted = finished == round * parents * (children + 1);
+    }
+    TestFramework::assert_true(allCounted, "wait() covers subtasks submitted by tasks");
+    
+    std::atomic<int> late{0};
+    pool.submit([&] { ++late; });
+    pool.wait();
+    TestFramework::assert_equal(1, late.load(), "Pool keeps working after wait()");
+}
+
 void test_game_state_structure() {
     GameState state;
     
@@ -201,6 +779,23 @@ int main() {
     TestFramework::run_test("Legal Moves Generation", test_legal_moves_generation);
     TestFramework::run_test("Board Reset", test_board_reset);
     TestFramework::run_test("GameState Structure", test_game_state_structure);
+    TestFramework::run_test("Side To Move Check", test_side_to_move_check);
+    TestFramework::run_test("Special Moves", test_special_moves);
+    TestFramework::run_test("Hash Key", test_hash_key);
+    TestFramework::run_test("FEN", test_fen);
+    TestFramework::run_test("Draw Detection", test_draw_detection);
+    TestFramework::run_test("Incremental Keys", test_incremental_keys);
+    TestFramework::run_test("Pawn Structure", test_pawn_structure);
+    TestFramework::run_test("Tapered Evaluation", test_tapered_evaluation);
+    TestFramework::run_test("Attack Bitboards", test_attack_bitboards);
+    TestFramework::run_test("Mobility And King Safety", test_mobility_and_king_safety);
+    TestFramework::run_test("Packed Positions", test_packed_positions);
+    TestFramework::run_test("Training Data", test_training_data);
+    TestFramework::run_test("Evaluation Tuning", test_evaluation_tuning);
+    TestFramework::run_test("Batch Evaluation", test_batch_evaluation);
+    TestFramework::run_test("Board Rendering", test_board_rendering);
+    TestFramework::run_test("Spectator", test_spectator);
+    TestFramework::run_test("Thread Pool", test_thread_pool);
     
     TestFramework::print_summary();
     
@@ -0,0 +1,538 @@
+#include "test_framework.h"
+#include "../include/Batch.h"
+#include "../include/Board.h"
+#include "../include/Epd.h"
+#include "../include/GameArchive.h"
+#include "../include/MappedPgn.h"
+#include "../include/MoveGen.h"
+#include "../include/Notation.h"
+#include "../include/OpeningBook.h"
+#include "../include/Pgn.h"
+#include "../include/PositionIndex.h"
+#include "../include/Zobrist.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+
+void test_san_parsing() {
+    Board board;
+    Move move(0, 0, 0, 0);
+
+    TestFramework::assert_true(Notation::fromSAN(board, "e4", move), "Pawn push parses");
+    TestFramework::assert_true(move.fromRow == 6 && move.fromCol == 4 && move.toRow == 4 && move.toCol == 4, "e4 is e2-e4");
+
+    TestFramework::assert_true(Notation::fromSAN(board, "Nf3", move), "Knight move parses");
+    TestFramework::assert_true(move.fromRow == 7 && move.fromCol == 6, "Nf3 comes from g1");
+
+    TestFramework::assert_true(!Notation::fromSAN(board, "Nd4", move), "Unreachable square is rejected");
+    TestFramework::assert_true(!Notation::fromSAN(board, "O-O", move), "Castling through pieces is rejected");
+    TestFramework::assert_true(!Notation::fromSAN(board, "xyz", move), "Garbage is rejected");
+
+    // Two knights can reach d2 after 1. d4 d5 2. Nf3 Nf6 3. Nbd2 ... disambiguation by file
+    Notation::fromSAN(board, "d4", move); board.makeMove(move);
+    Notation::fromSAN(board, "d5", move); board.makeMove(move);
+    Notation::fromSAN(board, "Nf3", move); board.makeMove(move);
+    Notation::fromSAN(board, "Nf6", move); board.makeMove(move);
+    TestFramework::assert_true(Notation::fromSAN(board, "Nbd2", move), "File disambiguation parses");
+    TestFramework::assert_true(move.fromCol == 1, "Nbd2 comes from the b-file");
+    TestFramework::assert_true(Notation::fromSAN(board, "Nfd2+", move), "Check suffix is ignored");
+    TestFramework::assert_true(move.fromCol == 5, "Nfd2 comes from the f-file");
+}
+
+void test_pgn_reader() {
+    std::istringstream input(
+        "[Event \"Test\"]\n"
+        "[White \"Alice\"]\n"
+        "\n"
+        "1. e4 {best by test} e5 2. Nf3 (2. f4 exf4) Nc6 $1 3. Bb5 a6 1-0\n"
+        "\n"
+        "[Event \"Second\"]\n"
+        "\n"
+        "1.d4 d5 2.c4 ; queen's gambit\n"
+        "dxc4 1/2-1/2\n");
+
+    PgnReader reader(input);
+    PgnGame game;
+
+    TestFramework::assert_true(reader.readGame(game), "First game is read");
+    TestFramework::assert_equal("Alice", game.getTag("White"), "Tag value is read");
+    TestFramework::assert_equal("1-0", game.result, "Result is read");
+    TestFramework::assert_equal(6, static_cast<int>(game.moves.size()), "Comments, variations and NAGs are skipped");
+    TestFramework::assert_equal("Bb5", game.moves[4], "Moves are kept in order");
+
+    TestFramework::assert_true(reader.readGame(game), "Second game is read");
+    TestFramework::assert_equal("Second", game.getTag("Event"), "Second game tags are separate");
+    TestFramework::assert_equal(4, static_cast<int>(game.moves.size()), "Attached move numbers and line comments are handled");
+    TestFramework::assert_equal("1/2-1/2", game.result, "Draw result is read");
+
+    TestFramework::assert_true(!reader.readGame(game), "No more games");
+}
+
+void test_san_writing() {
+    Board board;
+    TestFramework::assert_equal("e4", Notation::toSAN(board, Move(6, 4, 4, 4)), "Pawn push");
+    TestFramework::assert_equal("Nf3", Notation::toSAN(board, Move(7, 6, 5, 5)), "Knight move");
+    
+    // Both knights reach d2 after 1. d4 d5 2. Nf3 Nf6
+    const char* moves[] = {"d4", "d5", "Nf3", "Nf6"};
+    Move move(0, 0, 0, 0);
+    for (const char* san : moves) {
+        Notation::fromSAN(board, san, move);
+        board.makeMove(move);
+    }
+    TestFramework::assert_equal("Nbd2", Notation::toSAN(board, Move(7, 1, 6, 3)), "File disambiguation");
+    
+    board.loadFEN("4k3/1P6/8/8/8/8/8/R3K3 w Q - 0 1");
+    Move promotion(1, 1, 0, 1);
+    promotion.promotionPiece = PieceType::QUEEN;
+    TestFramework::assert_equal("b8=Q+", Notation::toSAN(board, promotion), "Promotion with check");
+    TestFramework::assert_equal("O-O-O", Notation::toSAN(board, Move(7, 4, 7, 2)), "Queenside castling");
+    
+    // Every generated SAN must parse back to the same move
+    board.resetToStartingPosition();
+    bool roundTrip = true;
+    for (const Move& legal : board.getAllLegalMoves(Color::WHITE)) {
+        Move parsed(0, 0, 0, 0);
+        roundTrip = roundTrip && Notation::fromSAN(board, Notation::toSAN(board, legal), parsed) &&
+                    parsed.fromRow == legal.fromRow && parsed.fromCol == legal.fromCol &&
+                    parsed.toRow == legal.toRow && parsed.toCol == legal.toCol;
+    }
+    TestFramework::assert_true(roundTrip, "SAN round-trips for every legal move");
+}
+
+void test_san_edge_cases() {
+    Board board;
+    Move move(0, 0, 0, 0);
+
+    // Rooks on a1 and a5 both reach a3: disambiguation by rank
+    board.loadFEN("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1");
+    TestFramework::assert_equal("R1a3", Notation::toSAN(board, Move(7, 0, 5, 0)), "Rank disambiguation");
+    TestFramework::assert_true(!Notation::fromSAN(board, "Ra3", move), "Ambiguous move is rejected");
+    TestFramework::assert_true(Notation::fromSAN(board, "R5a3", move) && move.fromRow == 3, "R5a3 comes from a5");
+
+    // Queens on a1, a3 and c1 all reach c3: file and rank needed
+    board.loadFEN("4k3/8/8/8/8/Q7/8/Q1Q1K3 w - - 0 1");
+    TestFramework::assert_equal("Qa1c3", Notation::toSAN(board, Move(7, 0, 5, 2)), "Square disambiguation");
+
+    // A pinned knight doesn't make the other one ambiguous
+    board.loadFEN("4k3/4r3/8/8/8/2N5/4N3/4K3 w - - 0 1");
+    TestFramework::assert_equal("Nd4", Notation::toSAN(board, Move(5, 2, 4, 3)), "Pinned piece is not a candidate");
+
+    board.loadFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 2");
+    TestFramework::assert_equal("exd6", Notation::toSAN(board, Move(3, 4, 2, 3)), "En passant is a capture");
+    TestFramework::assert_true(Notation::fromSAN(board, "exd6", move) && move.isEnPassant, "En passant parses");
+
+    board.loadFEN("6k1/5ppp/8/8/8/8/8/R3K2R w KQ - 0 1");
+    TestFramework::assert_equal("Ra8#", Notation::toSAN(board, Move(7, 0, 0, 0)), "Mate suffix");
+    TestFramework::assert_true(Notation::fromSAN(board, "O-O", move) && move.isCastling && move.toCol == 6, "Kingside castling parses");
+    TestFramework::assert_true(Notation::fromSAN(board, "0-0-0", move) && move.toCol == 2, "Castling with zeros parses");
+
+    board.loadFEN("3rk3/2P5/8/8/8/8/8/4K3 w - - 0 1");
+    Move underpromotion(1, 2, 0, 3);
+    underpromotion.promotionPiece = PieceType::KNIGHT;
+    TestFramework::assert_equal("cxd8=N", Notation::toSAN(board, underpromotion), "Capturing underpromotion");
+    TestFramework::assert_true(Notation::fromSAN(board, "cxd8=N", move) && move.promotionPiece == PieceType::KNIGHT, "Underpromotion parses");
+    TestFramework::assert_true(Notation::fromSAN(board, "cxd8", move) && move.promotionPiece == PieceType::QUEEN, "Promotion defaults to a queen");
+    TestFramework::assert_true(Notation::fromSAN(board, "c8=R+", move) && move.promotionPiece == PieceType::ROOK, "Promotion push parses");
+}
+
+// Moves from a position to the given depth
+long long perft(const MoveGen::Position& position, int depth) {
+    if (depth == 0) return 1;
+    MoveGen::MoveList moves;
+    MoveGen::generate(position, moves);
+    long long nodes = 0;
+    for (const Move& move : moves) {
+        MoveGen::Position after = position;
+        after.play(move);
+        nodes += perft(after, depth - 1);
+    }
+    return nodes;
+}
+
+void test_move_generation() {
+    Board board;
+    TestFramework::assert_equal(400, static_cast<int>(perft(MoveGen::Position(board), 2)), "Start position perft(2)");
+
+    // Castling, en passant, promotions and pins - the standard "Kiwipete" counts
+    board.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    MoveGen::Position position(board);
+    TestFramework::assert_equal(48, static_cast<int>(perft(position, 1)), "Kiwipete perft(1)");
+    TestFramework::assert_equal(2039, static_cast<int>(perft(position, 2)), "Kiwipete perft(2)");
+
+    MoveGen::MoveList moves;
+    MoveGen::generate(position, moves);
+    TestFramework::assert_equal(static_cast<int>(board.getAllLegalMoves(Color::WHITE).size()), moves.size(),
+                                "Same moves as the Board");
+    MoveGen::generate(position, moves, 1ULL << Zobrist::squareIndex(7, 6));
+    TestFramework::assert_equal(2, moves.size(), "Targets limit the destinations (Rg1 and O-O)");
+
+    board.loadFEN("6k1/5ppp/8/8/8/8/8/R3K3 w Q - 0 1");
+    MoveGen::Position mate(board);
+    mate.play(Move(7, 0, 0, 0));
+    TestFramework::assert_true(mate.inCheck() && !MoveGen::hasLegalMove(mate), "Back rank mate has no reply");
+}
+
+void test_pgn_writer() {
+    PgnGame game;
+    game.tags = {{"Event", "Test"}, {"FEN", "4k3/8/8/8/8/8/8/4K2R b K - 0 30"}};
+    game.moves = {"Kd7", "O-O", "Ke6"};
+    game.result = "*";
+    
+    std::ostringstream out;
+    writePgnGame(out, game);
+    std::string text = out.str();
+    TestFramework::assert_true(text.find("[Event \"Test\"]") == 0, "Tags are written first");
+    TestFramework::assert_true(text.find("30... Kd7 31. O-O Ke6 *") != std::string::npos, "Numbering starts from the FEN");
+    
+    std::istringstream in(text);
+    PgnReader reader(in);
+    PgnGame reread;
+    TestFramework::assert_true(reader.readGame(reread), "Written game reads back");
+    TestFramework::assert_equal(3, static_cast<int>(reread.moves.size()), "Moves survive the round trip");
+}
+
+void test_epd_parsing() {
+    EpdRecord record;
+    TestFramework::assert_true(parseEpd("r3k3/8/8/3N4/8/8/8/4K3 w - - bm Nc7+; id \"fork; knight\";", record), "EPD line parses");
+    TestFramework::assert_equal("r3k3/8/8/3N4/8/8/8/4K3 w - - 0 1", record.fen, "Move counters default to 0 1");
+    TestFramework::assert_equal("Nc7+", record.getOperation("bm"), "Operation operands are read");
+    TestFramework::assert_equal("fork; knight", record.getOperation("id"), "Quoted operands may contain semicolons");
+    TestFramework::assert_true(!record.hasOperation("am"), "Missing operation is reported");
+    
+    TestFramework::assert_true(parseEpd("8/8/8/8/8/8/8/K1k5 b - - hmvc 7; fmvn 40;", record), "Counter operations parse");
+    TestFramework::assert_equal("8/8/8/8/8/8/8/K1k5 b - - 7 40", record.fen, "hmvc and fmvn set the counters");
+    
+    TestFramework::assert_true(parseEpd("8/8/8/8/8/8/8/K1k5 w - - 3 12", record), "Plain FEN line parses");
+    TestFramework::assert_equal("8/8/8/8/8/8/8/K1k5 w - - 3 12", record.fen, "FEN counters are kept");
+    
+    TestFramework::assert_true(!parseEpd("# comment", record), "Comment lines are skipped");
+    TestFramework::assert_true(!parseEpd("   ", record), "Blank lines are skipped");
+}
+
+void test_move_encoding() {
+    Move move(1, 4, 0, 4);
+    move.promotionPiece = PieceType::KNIGHT;
+    Move decoded = OpeningBook::decodeMove(OpeningBook::encodeMove(move));
+
+    TestFramework::assert_true(decoded.fromRow == 1 && decoded.fromCol == 4, "From square survives encoding");
+    TestFramework::assert_true(decoded.toRow == 0 && decoded.toCol == 4, "To square survives encoding");
+    TestFramework::assert_equal(static_cast<int>(PieceType::KNIGHT), static_cast<int>(decoded.promotionPiece), "Promotion survives encoding");
+}
+
+void test_book_probe() {
+    Board board;
+    const std::string path = "test_book.tmp";
+
+    // Two moves from the starting position, one with zero weight
+    BookEntry entries[2] = {
+        {board.getHashKey(), OpeningBook::encodeMove(Move(6, 4, 4, 4)), 10, 5},
+        {board.getHashKey(), OpeningBook::encodeMove(Move(6, 3, 4, 3)), 0, 1},
+    };
+    {
+        std::ofstream out(path, std::ios::binary);
+        OpeningBook::writeHeader(out, 2);
+        out.write(reinterpret_cast<const char*>(entries), sizeof(entries));
+    }
+
+    OpeningBook book;
+    TestFramework::assert_true(book.load(path), "Book file loads");
+    TestFramework::assert_equal(2, static_cast<int>(book.probe(board.getHashKey()).size()), "Probe finds both entries");
+
+    Move move(0, 0, 0, 0);
+    TestFramework::assert_true(book.pickMove(board, move), "Book move is found");
+    TestFramework::assert_true(move.fromCol == 4 && move.toRow == 4, "Zero-weight moves are never picked");
+
+    board.makeMove(move);
+    TestFramework::assert_true(!book.pickMove(board, move), "Position outside the book has no move");
+
+    // A header claiming more entries than the file holds
+    {
+        std::ofstream out(path, std::ios::binary);
+        OpeningBook::writeHeader(out, 1ULL << 40);
+        out.write(reinterpret_cast<const char*>(entries), sizeof(entries));
+    }
+    TestFramework::assert_true(!book.load(path), "Truncated book fails to load");
+
+    std::remove(path.c_str());
+    TestFramework::assert_true(!book.load(path), "Missing file fails to load");
+}
+
+void test_batch_games() {
+    Board board;
+    uint64_t played = 0;
+    std::string error;
+    
+    TestFramework::assert_true(Batch::playMoves(board, "1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 *", played, error), "SAN moves with numbers");
+    TestFramework::assert_equal(6, static_cast<int>(played), "Move numbers and result aren't moves");
+    TestFramework::assert_equal("r1bqkbnr/1ppp1ppp/p1n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 0 4", board.toFEN(),
+                                "SAN moves reach the right position");
+    
+    board.resetToStartingPosition();
+    TestFramework::assert_true(Batch::playMoves(board, "e2e4 e7e5 f1c4 b8c6 d1h5 g8f6 h5f7#", played, error),
+                               "Coordinate moves");
+    TestFramework::assert_equal("1-0", Batch::result(board), "Scholar's mate is a white win");
+    
+    board.loadFEN("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    TestFramework::assert_true(Batch::playMoves(board, "a7a8=N", played, error), "Coordinate promotion");
+    TestFramework::assert_equal(static_cast<int>(PieceType::KNIGHT), static_cast<int>(board.getPiece(0, 0).getType()),
+                                "Promotion piece is kept");
+    TestFramework::assert_equal("1/2-1/2", Batch::result(board), "King and knight can't mate");
+    
+    board.resetToStartingPosition();
+    TestFramework::assert_true(!Batch::playMoves(board, "e4 e5 Ke3 Nf6", played, error), "Illegal move stops the game");
+    TestFramework::assert_equal(2, static_cast<int>(played), "Moves before the illegal one are played");
+    TestFramework::assert_true(error.find("Ke3") != std::string::npos, "Error names the move");
+    TestFramework::assert_equal("*", Batch::result(board), "Unfinished game has no result");
+    
+    std::istringstream input("# comment\n"
+                             "1.f3 e5 2.g4 Qh4#\n"
+                             "\n"
+                             "fen 8/8/8/8/8/5k2/8/5K2 w - - 0 1 moves f1e1\n"
+                             "e2e5\n");
+    std::ostringstream output;
+    std::ostringstream errors;
+    Batch::Summary summary = Batch::run(input, output, errors);
+    TestFramework::assert_equal(3, static_cast<int>(summary.games), "One game per line");
+    TestFramework::assert_equal(5, static_cast<int>(summary.moves), "Moves of every game are counted");
+    TestFramework::assert_equal(1, static_cast<int>(summary.failed), "Bad game is counted");
+    TestFramework::assert_equal("0-1 rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3\n"
+                                "1/2-1/2 8/8/8/8/8/5k2/8/4K3 b - - 1 1\n"
+                                "* rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n",
+                                output.str(), "Result and final position per game");
+    TestFramework::assert_true(errors.str().find("Game 3") != std::string::npos, "Errors name the game");
+}
+
+void test_mapped_pgn() {
+    const std::string path = "test_mapped.tmp";
+    {
+        std::ofstream out(path);
+        out << "\n"
+            << "[Event \"Test\"]\n"
+            << "[White \"Alice \\\"A\\\"\"]\n"
+            << "\n"
+            << "1. e4 {best by test} e5 2. Nf3 (2. f4 exf4) Nc6 $1 3. Bb5 a6 1-0\n"
+            << "\n"
+            << "[Event \"Second\"]\n"
+            << "[FEN \"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1\"]\n"
+            << "%escape line\n"
+            << "1.e4 Kd7 2.e5\n"
+            << "; comment\n"
+            << "Ke6\n"
+            << "\n"
+            << "[Event \"Third\"]\n"
+            << "1. e4 Ke7 *\n";
+    }
+    
+    MappedPgn pgn;
+    TestFramework::assert_true(pgn.open(path, 2), "PGN file is mapped");
+    TestFramework::assert_equal(3, static_cast<int>(pgn.gameCount()), "Games are split at tag lines after movetext");
+    TestFramework::assert_equal("Second", std::string(MappedPgn::tag(pgn.game(1), "Event")), "Tag is read from its own game");
+    TestFramework::assert_equal("Alice \\\"A\\\"", std::string(MappedPgn::tag(pgn.game(0), "White")), "Tag value keeps escapes");
+    TestFramework::assert_true(MappedPgn::tag(pgn.game(0), "FEN").empty(), "Missing tag is empty");
+    
+    PgnTokenizer tokens(pgn.game(0));
+    std::vector<std::string> moves;
+    std::string_view san;
+    while (tokens.nextMove(san)) moves.push_back(std::string(san));
+    TestFramework::assert_equal(6, static_cast<int>(moves.size()), "Comments, variations and NAGs are skipped");
+    TestFramework::assert_equal("Bb5", moves[4], "Moves are kept in order");
+    TestFramework::assert_equal("1-0", std::string(tokens.getResult()), "Result is read");
+    
+    PgnTokenizer second(pgn.game(1));
+    moves.clear();
+    while (second.nextMove(san)) moves.push_back(std::string(san));
+    TestFramework::assert_equal(4, static_cast<int>(moves.size()), "Escape lines and line comments are skipped");
+    TestFramework::assert_equal("*", std::string(second.getResult()), "Missing result reads as *");
+    
+    // Positions per game, in order within each game
+    std::mutex mutex;
+    std::vector<std::vector<int>> plies(pgn.gameCount());
+    std::string lastOfSecond;
+    MappedPgn::ReplayStats stats = pgn.replay(2, [&](const ReplayPosition& position) {
+        std::lock_guard<std::mutex> lock(mutex);
+        plies[position.game].push_back(position.ply);
+        if (position.game == 1) lastOfSecond = position.board.toFEN();
+    });
+    TestFramework::assert_equal(3, static_cast<int>(stats.games), "Every game is replayed");
+    TestFramework::assert_equal(7 + 5 + 2, static_cast<int>(stats.positions), "Every position is reached");
+    TestFramework::assert_equal(1, static_cast<int>(stats.failed), "Illegal move stops its game");
+    TestFramework::assert_true(plies[0] == std::vector<int>({0, 1, 2, 3, 4, 5, 6}), "Callbacks come in game order");
+    TestFramework::assert_equal("8/8/4k3/4P3/8/8/8/4K3 w - - 1 3", lastOfSecond, "Game starts from its FEN tag");
+    
+    std::remove(path.c_str());
+    TestFramework::assert_true(!pgn.open(path), "Missing file fails to open");
+}
+
+// Main function for standalone execution
+void test_position_index() {
+    const std::string pgnPath = "test_index.pgn.tmp";
+    const std::string indexPath = "test_index.tmp";
+    {
+        std::ofstream out(pgnPath);
+        out << "[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 1-0\n\n"
+            << "[Result \"1/2-1/2\"]\n\n1. e4 e5 2. Bc4 1/2-1/2\n\n"
+            << "[Result \"0-1\"]\n\n1. d4 d5 0-1\n\n"
+            << "[Result \"*\"]\n\n1. e4 c5 *\n";
+    }
+
+    MappedPgn archive;
+    TestFramework::assert_true(archive.open(pgnPath, 2), "Archive maps");
+    PositionIndex::BuildOptions options;
+    options.threads = 2;
+    PositionIndex::BuildStats stats;
+    TestFramework::assert_true(PositionIndex::build(archive, indexPath, options, stats), "Index builds");
+    TestFramework::assert_equal(10, static_cast<int>(stats.positions), "Every move is a record");
+
+    PositionIndex index;
+    TestFramework::assert_true(index.open(indexPath), "Index opens");
+    TestFramework::assert_equal(4, static_cast<int>(index.gameCount()), "Games are counted");
+    TestFramework::assert_equal(7, static_cast<int>(index.size()), "Repeated position/move pairs are combined");
+
+    Board board;
+    std::vector<PositionIndex::MoveStats> moves = index.lookup(board);
+    TestFramework::assert_equal(2, static_cast<int>(moves.size()), "Two moves from the start");
+    TestFramework::assert_true(moves[0].move == OpeningBook::encodeMove(Move(6, 4, 4, 4)) && moves[0].games == 3,
+                               "Most played move first");
+    TestFramework::assert_true(moves[0].whiteWins == 1 && moves[0].draws == 1 && moves[0].blackWins == 0,
+                               "Results add up, unfinished games count as games only");
+    TestFramework::assert_true(moves[1].games == 1 && moves[1].blackWins == 1, "Second move and its result");
+
+    board.makeMove(Move(6, 4, 4, 4));
+    moves = index.lookup(board);
+    TestFramework::assert_true(moves.size() == 2 && moves[0].games == 2, "Positions after a move are indexed");
+    board.makeMove(Move(1, 0, 2, 0));
+    TestFramework::assert_true(index.lookup(board).empty(), "Unreached position has no moves");
+
+    // Entries of one key spread over several blocks
+    {
+        PositionIndex::Writer writer(indexPath, 1);
+        for (uint16_t move = 0; move < 3 * PositionIndex::BLOCK_ENTRIES; ++move) {
+            writer.add(PositionIndex::Record{move < 10 ? 5ULL : 7ULL, {move, 1, 0, 1, 0}});
+        }
+        writer.add(PositionIndex::Record{~0ULL, {1, 2, 2, 0, 0}});
+        TestFramework::assert_true(writer.finish(), "Writer finishes");
+    }
+    TestFramework::assert_true(index.open(indexPath), "Written index opens");
+    TestFramework::assert_equal(10, static_cast<int>(index.lookup(5).size()), "Key inside one block");
+    TestFramework::assert_equal(3 * static_cast<int>(PositionIndex::BLOCK_ENTRIES) - 10,
+                                static_cast<int>(index.lookup(7).size()), "Key across block boundaries");
+    TestFramework::assert_true(index.lookup(~0ULL).size() == 1 && index.lookup(~0ULL)[0].whiteWins == 2,
+                               "Largest key");
+    TestFramework::assert_true(index.lookup(6).empty() && index.lookup(0).empty(), "Missing keys");
+
+    std::remove(pgnPath.c_str());
+    std::remove(indexPath.c_str());
+    TestFramework::assert_true(!index.open(indexPath), "Missing file fails to open");
+}
+
+void test_game_archive() {
+    const std::string path = "test_archive.tmp";
+
+    PgnGame opening;
+    opening.tags = {{"Event", "Archive test"}, {"Result", "1-0"}};
+    opening.moves = {"e4", "e5", "Nf3", "Nc6", "Bc4", "Nf6", "O-O", "Bc5", "d4", "exd4"};
+    opening.result = "1-0";
+
+    PgnGame promotion;
+    promotion.tags = {{"SetUp", "1"}, {"FEN", "3rk3/2P5/8/8/8/8/8/4K2R w K - 0 1"}};
+    promotion.moves = {"cxd8=N", "Kxd8", "O-O"};
+    promotion.result = "*";
+
+    PgnGame broken = opening;
+    broken.moves.push_back("Nd5");  // No knight reaches d5
+
+    {
+        GameArchive::Writer writer(path);
+        TestFramework::assert_true(writer.isOpen(), "Archive writer opens");
+        TestFramework::assert_true(writer.add(opening), "Game is encoded");
+        TestFramework::assert_true(!writer.add(broken), "Game with an illegal move is refused");
+        TestFramework::assert_true(writer.add(promotion), "Game from a FEN is encoded");
+        TestFramework::assert_true(writer.add(PgnGame{{}, {}, "1/2-1/2"}), "Game without moves is encoded");
+        TestFramework::assert_equal(3, static_cast<int>(writer.gameCount()), "Refused game isn't counted");
+        TestFramework::assert_true(writer.finish(), "Archive finishes");
+    }
+
+    GameArchive archive;
+    TestFramework::assert_true(archive.open(path), "Archive opens");
+    TestFramework::assert_equal(3, static_cast<int>(archive.gameCount()), "Game count is stored");
+
+    PgnGame game;
+    TestFramework::assert_true(archive.readGame(1, game), "Games are read by number");
+    TestFramework::assert_true(game.tags == promotion.tags && game.result == "*", "Tags and result come back");
+    TestFramework::assert_true(game.moves == std::vector<std::string>({"cxd8=N", "Kxd8", "O-O"}),
+                               "Underpromotion and castling come back in SAN");
+
+    TestFramework::assert_true(archive.readGame(0, game), "First game is read");
+    TestFramework::assert_true(game.moves == opening.moves && game.result == "1-0", "Moves come back in order");
+
+    Board start;
+    std::vector<Move> moves;
+    TestFramework::assert_true(archive.readMoves(0, start, moves), "Moves alone are read");
+    TestFramework::assert_true(moves.size() == 10 && moves[6].isCastling, "Decoded moves carry their flags");
+    TestFramework::assert_true(archive.readMoves(2, start, moves) && moves.empty(), "Empty game");
+    TestFramework::assert_true(!archive.readGame(3, game), "Out of range game fails");
+
+    // Tags and index included, the ten-move game takes a few bytes
+    TestFramework::assert_true(archive.size() < 200, "Archive is compact");
+
+    // Damaged copies: a game count that would wrap the index size around,
+    // and game offsets that run backwards
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    uint64_t indexOffset;
+    std::memcpy(&indexOffset, bytes.data() + 16, sizeof(indexOffset));
+    const std::string badPath = "test_archive_bad.tmp";
+    auto writeCopy = [&](const std::string& data) {
+        std::ofstream out(badPath, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+    };
+
+    std::string damaged = bytes;
+    uint64_t hugeCount = 1ULL << 61;
+    std::memcpy(&damaged[8], &hugeCount, sizeof(hugeCount));
+    writeCopy(damaged);
+    TestFramework::assert_true(!archive.open(badPath), "Game count larger than the index fails to open");
+
+    damaged = bytes;
+    uint64_t second;
+    std::memcpy(&second, bytes.data() + indexOffset + 16, sizeof(second));
+    second += 1;
+    std::memcpy(&damaged[indexOffset + 8], &second, sizeof(second));
+    writeCopy(damaged);
+    TestFramework::assert_true(!archive.open(badPath), "Offsets out of order fail to open");
+    std::remove(badPath.c_str());
+
+    std::remove(path.c_str());
+    TestFramework::assert_true(!archive.open(path), "Missing file fails to open");
+}
+
+int main() {
+    std::cout << "Running Book Tests" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+
+    TestFramework::run_test("SAN Parsing", test_san_parsing);
+    TestFramework::run_test("PGN Reader", test_pgn_reader);
+    TestFramework::run_test("SAN Writing", test_san_writing);
+    TestFramework::run_test("SAN Edge Cases", test_san_edge_cases);
+    TestFramework::run_test("Move Generation", test_move_generation);
+    TestFramework::run_test("PGN Writer", test_pgn_writer);
+    TestFramework::run_test("EPD Parsing", test_epd_parsing);
+    TestFramework::run_test("Move Encoding", test_move_encoding);
+    TestFramework::run_test("Book Probe", test_book_probe);
+    TestFramework::run_test("Batch Games", test_batch_games);
+    TestFramework::run_test("Mapped PGN", test_mapped_pgn);
+    TestFramework::run_test("Position Index", test_position_index);
+    TestFramework::run_test("Game Archive", test_game_archive);
+
+    TestFramework::print_summary();
+
+    return TestFramework::all_tests_passed() ? 0 : 1;
+}
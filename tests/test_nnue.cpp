@@ -0,0 +1,203 @@
+#include "test_framework.h"
+#include "../include/Board.h"
+#include "../include/Nnue.h"
+#include "../include/Notation.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+const std::string NETWORK_FILE = "nnue_test.tmp";
+
+bool sameAccumulator(const Nnue::Accumulator& a, const Nnue::Accumulator& b, int hiddenSize) {
+    for (int side = 0; side < 2; ++side) {
+        if (a.kingSquare[side] != b.kingSquare[side]) return false;
+        if (std::memcmp(a.values[side], b.values[side], hiddenSize * sizeof(int16_t)) != 0) return false;
+    }
+    return true;
+}
+
+// Make a move and check the updated accumulator against a fresh one
+bool updateMatchesRefresh(const Nnue::Network& network, Board& board, const Move& move) {
+    Nnue::Accumulator parent, updated, fresh;
+    network.refresh(parent, board);
+    if (!board.makeMove(move)) return false;
+    network.update(updated, parent, board);
+    network.refresh(fresh, board);
+    return sameAccumulator(updated, fresh, network.getHiddenSize());
+}
+
+bool playSan(const Nnue::Network& network, const std::string& fen, const std::string& san) {
+    Board board;
+    Move move(0, 0, 0, 0);
+    return board.loadFEN(fen) && Notation::fromSAN(board, san, move) && updateMatchesRefresh(network, board, move);
+}
+
+// The same position with colors swapped and the board turned around
+Board mirror(const Board& board) {
+    Board mirrored;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Piece& piece = board.getPiece(7 - row, col);
+            Color color = piece.getColor() == Color::WHITE ? Color::BLACK : Color::WHITE;
+            mirrored.setPiece(row, col, piece.isEmpty() ? Piece() : Piece(piece.getType(), color));
+        }
+    }
+    Color toMove = board.getGameState().currentPlayer;
+    mirrored.setCurrentPlayer(toMove == Color::WHITE ? Color::BLACK : Color::WHITE);
+    return mirrored;
+}
+
+} // namespace
+
+void test_network_file() {
+    Nnue::Network network;
+    TestFramework::assert_true(!network.load("no_such_network.nnue"), "Missing file is rejected");
+
+    {
+        std::ofstream out(NETWORK_FILE, std::ios::binary);
+        out << "not a network at all, but long enough to hold a header..................";
+    }
+    TestFramework::assert_true(!network.load(NETWORK_FILE), "File without the magic is rejected");
+    TestFramework::assert_true(!network.isLoaded(), "Failed load leaves no network");
+
+    TestFramework::assert_true(!Nnue::writeRandomNetwork(NETWORK_FILE, 40, 8, 1), "Hidden size must be a multiple of 32");
+    TestFramework::assert_true(Nnue::writeRandomNetwork(NETWORK_FILE, 64, 8, 1), "Random network is written");
+    TestFramework::assert_true(network.load(NETWORK_FILE), "Random network loads");
+    TestFramework::assert_equal(64, network.getHiddenSize(), "Hidden size is read from the header");
+    TestFramework::assert_equal(8, network.getOutputHidden(), "Second layer size is read from the header");
+
+    // A truncated file is rejected
+    std::vector<char> bytes;
+    {
+        std::ifstream in(NETWORK_FILE, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(NETWORK_FILE, std::ios::binary);
+        out.write(bytes.data(), bytes.size() - 64);
+    }
+    Nnue::Network truncated;
+    TestFramework::assert_true(!truncated.load(NETWORK_FILE), "Truncated network is rejected");
+    std::remove(NETWORK_FILE.c_str());
+}
+
+void test_feature_index() {
+    Piece whiteKnight(PieceType::KNIGHT, Color::WHITE);
+    Piece blackKnight(PieceType::KNIGHT, Color::BLACK);
+
+    int white = Nnue::featureIndex(Color::WHITE, 60, whiteKnight, 57);
+    int black = Nnue::featureIndex(Color::BLACK, 60 ^ 56, blackKnight, 57 ^ 56);
+    TestFramework::assert_equal(white, black, "Black's view is white's view mirrored");
+    TestFramework::assert_true(white != Nnue::featureIndex(Color::WHITE, 60, blackKnight, 57), "Own and opponent's pieces differ");
+    TestFramework::assert_true(white != Nnue::featureIndex(Color::WHITE, 59, whiteKnight, 57), "Features depend on the king square");
+    TestFramework::assert_equal(Nnue::INPUT_SIZE - 1,
+                                Nnue::featureIndex(Color::WHITE, 63, Piece(PieceType::QUEEN, Color::BLACK), 63),
+                                "Last feature is the end of the input layer");
+}
+
+void test_incremental_update() {
+    Nnue::writeRandomNetwork(NETWORK_FILE, 64, 8, 7);
+    Nnue::Network network;
+    network.load(NETWORK_FILE);
+
+    TestFramework::assert_true(playSan(network, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "Nf3"),
+                               "Quiet move updates incrementally");
+    TestFramework::assert_true(playSan(network, "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "O-O"),
+                               "Castling refreshes the mover's side");
+    TestFramework::assert_true(playSan(network, "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "exd6"),
+                               "En passant removes the captured pawn");
+    TestFramework::assert_true(playSan(network, "1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1", "axb8=Q"),
+                               "Promotion with capture updates three squares");
+    TestFramework::assert_true(playSan(network, "4k3/8/8/8/8/8/3r4/4K3 w - - 0 1", "Kxd2"),
+                               "King capture refreshes only the king's side");
+
+    // Random games, updating along the way like the search does
+    std::mt19937 rng(3);
+    int mismatches = 0;
+    int positions = 0;
+    for (int game = 0; game < 20; ++game) {
+        Board board;
+        Nnue::Accumulator accumulators[2];
+        network.refresh(accumulators[0], board);
+        for (int ply = 1; ply <= 120; ++ply) {
+            std::vector<Move> moves = board.getAllLegalMoves(board.getGameState().currentPlayer);
+            if (moves.empty()) break;
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            board.makeMove(moves[pick(rng)]);
+
+            Nnue::Accumulator fresh;
+            network.update(accumulators[ply % 2], accumulators[(ply + 1) % 2], board);
+            network.refresh(fresh, board);
+            if (!sameAccumulator(accumulators[ply % 2], fresh, network.getHiddenSize())) ++mismatches;
+            ++positions;
+        }
+    }
+    TestFramework::assert_true(positions > 1000, "Random games cover many positions");
+    TestFramework::assert_equal(0, mismatches, "Incremental updates match refreshes over random games");
+
+    Board board;
+    board.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    const SquareChange* changes;
+    int count;
+    TestFramework::assert_true(!board.getLastChanges(changes, count), "Loading a position can't be updated incrementally");
+    std::remove(NETWORK_FILE.c_str());
+}
+
+void test_evaluation() {
+    Nnue::writeRandomNetwork(NETWORK_FILE, 128, 16, 11);
+    Nnue::Network network;
+    network.load(NETWORK_FILE);
+
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+        "8/2k5/3p4/p2P1p2/P2P1P2/8/8/4K3 b - - 0 1",
+        "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+    };
+
+    bool symmetric = true;
+    for (const char* fen : fens) {
+        Board board;
+        board.loadFEN(fen);
+        if (network.evaluate(board) != network.evaluate(mirror(board))) symmetric = false;
+    }
+    TestFramework::assert_true(symmetric, "Mirrored positions evaluate the same for the side to move");
+
+    if (Nnue::avx2Supported()) {
+        bool same = true;
+        for (const char* fen : fens) {
+            Board board;
+            board.loadFEN(fen);
+            Nnue::setKernel(Nnue::Kernel::SCALAR);
+            int scalar = network.evaluate(board);
+            Nnue::setKernel(Nnue::Kernel::AVX2);
+            if (network.evaluate(board) != scalar) same = false;
+        }
+        TestFramework::assert_true(same, "AVX2 and scalar kernels agree");
+        TestFramework::assert_true(Nnue::getKernel() == Nnue::Kernel::AVX2, "AVX2 kernel can be selected");
+    } else {
+        TestFramework::assert_true(!Nnue::setKernel(Nnue::Kernel::AVX2), "AVX2 can't be selected without CPU support");
+        TestFramework::assert_true(Nnue::getKernel() == Nnue::Kernel::SCALAR, "Scalar kernel stays selected");
+    }
+    std::remove(NETWORK_FILE.c_str());
+}
+
+// Main function for standalone execution
+int main() {
+    std::cout << "Running NNUE Tests" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+
+    TestFramework::run_test("Network File", test_network_file);
+    TestFramework::run_test("Feature Index", test_feature_index);
+    TestFramework::run_test("Incremental Update", test_incremental_update);
+    TestFramework::run_test("Evaluation", test_evaluation);
+
+    TestFramework::print_summary();
+
+    return TestFramework::all_tests_passed() ? 0 : 1;
+}
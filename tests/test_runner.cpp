@@ -75,6 +75,21 @@ int test_board_main() {
     extern void test_legal_moves_generation();
     extern void test_board_reset();
     extern void test_game_state_structure();
+    extern void test_side_to_move_check();
+    extern void test_special_moves();
+    extern void test_hash_key();
+    extern void test_fen();
+    extern void test_draw_detection();
+    extern void test_incremental_keys();
+    extern void test_pawn_structure();
+    extern void test_tapered_evaluation();
+    extern void test_attack_bitboards();
+    extern void test_mobility_and_king_safety();
+    extern void test_packed_positions();
+    extern void test_batch_evaluation();
+    extern void test_board_rendering();
+    extern void test_spectator();
+    extern void test_thread_pool();
     
     TestFramework::run_test("Board Initialization", test_board_initialization);
     TestFramework::run_test("Board Utilities", test_board_utilities);
@@ -85,6 +100,21 @@ int test_board_main() {
     TestFramework::run_test("Legal Moves Generation", test_legal_moves_generation);
     TestFramework::run_test("Board Reset", test_board_reset);
     TestFramework::run_test("GameState Structure", test_game_state_structure);
+    TestFramework::run_test("Side To Move Check", test_side_to_move_check);
+    TestFramework::run_test("Special Moves", test_special_moves);
+    TestFramework::run_test("Hash Key", test_hash_key);
+    TestFramework::run_test("FEN", test_fen);
+    TestFramework::run_test("Draw Detection", test_draw_detection);
+    TestFramework::run_test("Incremental Keys", test_incremental_keys);
+    TestFramework::run_test("Pawn Structure", test_pawn_structure);
+    TestFramework::run_test("Tapered Evaluation", test_tapered_evaluation);
+    TestFramework::run_test("Attack Bitboards", test_attack_bitboards);
+    TestFramework::run_test("Mobility And King Safety", test_mobility_and_king_safety);
+    TestFramework::run_test("Packed Positions", test_packed_positions);
+    TestFramework::run_test("Batch Evaluation", test_batch_evaluation);
+    TestFramework::run_test("Board Rendering", test_board_rendering);
+    TestFramework::run_test("Spectator", test_spectator);
+    TestFramework::run_test("Thread Pool", test_thread_pool);
     
     TestFramework::print_summary();
     return (TestFramework::tests_run == TestFramework::tests_passed) ? 0 : 1;
@@ -0,0 +1,163 @@
+#include "test_framework.h"
+#include "../include/Board.h"
+#include "../include/LargePages.h"
+#include "../include/Tablebase.h"
+#include "../include/TranspositionTable.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const std::string TABLE_DIR = "tablebase_test.tmp";
+
+void clearBoard(Board& board) {
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            board.setPiece(row, col, Piece());
+        }
+    }
+}
+
+// Kings on a8 (black) and b6 (white) plus one more piece
+Board cornerPosition(int row, int col, Piece piece, Color toMove) {
+    Board board;
+    clearBoard(board);
+    board.setPiece(0, 0, Piece(PieceType::KING, Color::BLACK));
+    board.setPiece(2, 1, Piece(PieceType::KING, Color::WHITE));
+    board.setPiece(row, col, piece);
+    board.setCurrentPlayer(toMove);
+    return board;
+}
+
+} // namespace
+
+void test_tablebase_generation() {
+    std::ostringstream log;
+    TestFramework::assert_true(Tablebase::generate("KQK", TABLE_DIR, 2, log), "KQK table generates");
+    TestFramework::assert_true(!Tablebase::generate("KKQ", TABLE_DIR, 2, log), "Non-canonical signature is rejected");
+    TestFramework::assert_equal(5, static_cast<int>(Tablebase::allSignatures(3).size()), "Five 3-piece signatures");
+    TestFramework::assert_equal(35, static_cast<int>(Tablebase::allSignatures(4).size()), "Thirty-five 3- and 4-piece signatures");
+}
+
+void test_tablebase_probe() {
+    Tablebase tables;
+    TestFramework::assert_equal(1, tables.load(TABLE_DIR), "Table file is mapped");
+    TestFramework::assert_equal(3, tables.getMaxPieces(), "Max pieces comes from the loaded tables");
+
+    Piece whiteQueen(PieceType::QUEEN, Color::WHITE);
+
+    // Qc7 with black to move is stalemate
+    Tablebase::ProbeResult result = tables.probe(cornerPosition(1, 2, whiteQueen, Color::BLACK));
+    TestFramework::assert_true(result.result == Tablebase::Result::DRAW, "Stalemate is a draw");
+
+    // With white to move, Qa7 or Qb7 mates at once
+    result = tables.probe(cornerPosition(1, 2, whiteQueen, Color::WHITE));
+    TestFramework::assert_true(result.result == Tablebase::Result::WIN, "Side with the queen wins");
+    TestFramework::assert_equal(1, result.pliesToMate, "Mate in one ply");
+
+    // Qb7 is already mate
+    result = tables.probe(cornerPosition(1, 1, whiteQueen, Color::BLACK));
+    TestFramework::assert_true(result.result == Tablebase::Result::LOSS, "Checkmated side loses");
+    TestFramework::assert_equal(0, result.pliesToMate, "Checkmate is zero plies from mate");
+
+    // Same positions with the colors swapped are probed by mirroring
+    Board mirrored;
+    clearBoard(mirrored);
+    mirrored.setPiece(7, 0, Piece(PieceType::KING, Color::WHITE));
+    mirrored.setPiece(5, 1, Piece(PieceType::KING, Color::BLACK));
+    mirrored.setPiece(6, 2, Piece(PieceType::QUEEN, Color::BLACK));
+    mirrored.setCurrentPlayer(Color::BLACK);
+    result = tables.probe(mirrored);
+    TestFramework::assert_true(result.result == Tablebase::Result::WIN && result.pliesToMate == 1, "Black queen side is probed by mirroring");
+
+    // Material without a table
+    Board start;
+    TestFramework::assert_true(tables.probe(start).result == Tablebase::Result::UNKNOWN, "Starting position is not in the tables");
+    Board rookEnding = cornerPosition(4, 4, Piece(PieceType::ROOK, Color::WHITE), Color::WHITE);
+    TestFramework::assert_true(tables.probe(rookEnding).result == Tablebase::Result::UNKNOWN, "Missing KRK table gives unknown");
+
+    std::filesystem::remove_all(TABLE_DIR);
+}
+
+void test_hash_snapshot() {
+    const std::string path = "hash_snapshot.tmp";
+    TranspositionTable table(1);
+    table.store(1, 50, 6, Bound::EXACT, 100);
+    table.store(2, -30, 3, Bound::LOWER, 200);
+    table.store(3, 10, 1, Bound::EXACT, 300);  // Too shallow to keep
+    TestFramework::assert_equal(2, static_cast<int>(table.save(path, 2, Color::WHITE)), "Snapshot keeps the deep entries");
+    
+    TranspositionTable same(1);
+    TestFramework::assert_equal(2, static_cast<int>(same.load(path, Color::WHITE)), "Snapshot loads");
+    const TTEntry* entry = same.probe(1);
+    TestFramework::assert_true(entry && entry->score == 50 && entry->depth == 6 && entry->move == 100,
+                               "Loaded entry is unchanged");
+    TestFramework::assert_true(same.probe(3) == nullptr, "Shallow entry was left out");
+    
+    // A deeper result for the same position survives a shallower search
+    same.store(1, 20, 2, Bound::EXACT, 0);
+    TestFramework::assert_equal(6, same.probe(1) ? static_cast<int>(same.probe(1)->depth) : 0,
+                                "Shallower result doesn't replace a loaded one");
+    
+    TranspositionTable other(1);
+    other.load(path, Color::BLACK);
+    entry = other.probe(2);
+    TestFramework::assert_true(entry && entry->score == 30 && entry->bound == Bound::UPPER,
+                               "Other side's view negates scores and swaps bounds");
+    
+    // Flip one bit of an entry
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    std::fseek(file, 40, SEEK_SET);
+    int byte = std::fgetc(file);
+    std::fseek(file, 40, SEEK_SET);
+    std::fputc(byte ^ 1, file);
+    std::fclose(file);
+    TestFramework::assert_equal(-1, static_cast<int>(TranspositionTable(1).load(path, Color::WHITE)),
+                                "Corrupt snapshot fails its checksum");
+    std::remove(path.c_str());
+    TestFramework::assert_equal(-1, static_cast<int>(TranspositionTable(1).load(path, Color::WHITE)),
+                                "Missing snapshot is reported");
+}
+
+void test_large_pages() {
+    LargePages block;
+    const size_t bytes = 3 * LargePages::PAGE_SIZE + 100;
+    unsigned char* data = static_cast<unsigned char*>(block.allocate(bytes));
+    TestFramework::assert_true(data != nullptr && block.kind() != LargePages::Kind::NONE, "Large block allocated");
+    TestFramework::assert_true(data[0] == 0 && data[bytes - 1] == 0, "Large block starts zeroed");
+    
+    data[0] = 1;
+    data[bytes - 1] = 1;
+    block.clear(4);
+    TestFramework::assert_true(data[0] == 0 && data[bytes - 1] == 0, "Clear zeroes the whole block");
+    
+    block.allocate(bytes, false);
+    TestFramework::assert_true(block.kind() == LargePages::Kind::NORMAL, "Huge pages can be turned off");
+    
+    // A fresh table skips its clear; one that was stored in is still cleared
+    TranspositionTable table(1);
+    table.clear();
+    table.store(42, 10, 3, Bound::EXACT, 0);
+    table.clear();
+    TestFramework::assert_true(table.probe(42) == nullptr, "Clear empties a table after stores");
+    table.store(42, 10, 3, Bound::EXACT, 0);
+    table.clear();
+    TestFramework::assert_true(table.probe(42) == nullptr, "Clear empties a table again after more stores");
+}
+
+// Main function for standalone execution
+int main() {
+    std::cout << "Running Tablebase Tests" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+
+    TestFramework::run_test("Tablebase Generation", test_tablebase_generation);
+    TestFramework::run_test("Tablebase Probe", test_tablebase_probe);
+    TestFramework::run_test("Hash Snapshot", test_hash_snapshot);
+    TestFramework::run_test("Large Pages", test_large_pages);
+
+    TestFramework::print_summary();
+
+    return TestFramework::all_tests_passed() ? 0 : 1;
+}
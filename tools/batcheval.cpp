@@ -0,0 +1,208 @@
+// batcheval - score a file of positions with the batched evaluation
+//
+// Reads a packed position file (mapped, not copied) or FEN/EPD lines, splits
+// the positions into chunks and scores the chunks in parallel with
+// Evaluation::evaluateBatch. Reports positions per second; --compare also
+// times AI::staticEvaluation one Board at a time and checks both agree.
+//
+// A Board that already exists evaluates faster than a packed position
+// (its piece-square sums and bitboards are kept up to date as moves are
+// made, while the batch decodes every position), so --compare also times
+// building the Boards, which is what scoring stored positions one Board
+// at a time really costs.
+
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/Epd.h"
+#include "../include/Evaluation.h"
+#include "../include/MappedFile.h"
+#include "../include/PackedPosition.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string inputPath;
+    int randomGames = 0;
+    std::string scoresPath;
+    std::string packPath;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunk = 16384;  // Positions per task
+    bool compare = false;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool loadText(const std::string& path, std::vector<PackedPosition>& positions) {
+    std::ifstream input(path);
+    if (!input) return false;
+
+    std::string line;
+    EpdRecord record;
+    Board board;
+    PackedPosition packed;
+    while (std::getline(input, line)) {
+        if (!parseEpd(line, record)) continue;
+        if (!board.loadFEN(record.fen) || !PackedPositions::pack(board, packed)) {
+            std::cerr << "Warning: skipping bad position: " << line << std::endl;
+            continue;
+        }
+        positions.push_back(packed);
+    }
+    return true;
+}
+
+void playRandomGames(int games, std::vector<PackedPosition>& positions) {
+    std::mt19937 rng(1);
+    PackedPosition packed;
+    for (int game = 0; game < games; ++game) {
+        Board board;
+        for (int ply = 0; ply < 200; ++ply) {
+            std::vector<Move> moves = board.getAllLegalMoves(board.getGameState().currentPlayer);
+            if (moves.empty() || board.isDraw()) break;
+
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            board.makeMove(moves[pick(rng)]);
+            PackedPositions::pack(board, packed);
+            positions.push_back(packed);
+        }
+    }
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <positions> [options]\n\n"
+              << "Positions are a packed position file or FEN/EPD lines.\n\n"
+              << "Options:\n"
+              << "  --random N          Score positions from N random games instead of a file\n"
+              << "  --threads N         Worker threads (default: all cores)\n"
+              << "  --chunk N           Positions per task (default 16384)\n"
+              << "  --scores FILE       Write one score per line, white's view\n"
+              << "  --pack FILE         Write the positions as a packed position file\n"
+              << "  --compare           Also time AI::staticEvaluation per Board and check the scores\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--random" && hasValue) options.randomGames = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--chunk" && hasValue) options.chunk = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--scores" && hasValue) options.scoresPath = argv[++i];
+        else if (arg == "--pack" && hasValue) options.packPath = argv[++i];
+        else if (arg == "--compare") options.compare = true;
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else if (options.inputPath.empty()) options.inputPath = arg;
+        else return false;
+    }
+    return !options.inputPath.empty() || options.randomGames > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Positions either point into the mapped file or into the vector
+    MappedFile file;
+    std::vector<PackedPosition> loaded;
+    const PackedPosition* positions = nullptr;
+    size_t count = 0;
+    if (!options.inputPath.empty() && file.open(options.inputPath) &&
+        PackedPositions::records(file, positions, count)) {
+        std::cout << "Mapped " << count << " packed positions" << std::endl;
+    } else {
+        if (options.randomGames > 0) {
+            playRandomGames(options.randomGames, loaded);
+        } else if (!loadText(options.inputPath, loaded)) {
+            std::cerr << "Error: cannot open " << options.inputPath << std::endl;
+            return 1;
+        }
+        positions = loaded.data();
+        count = loaded.size();
+        std::cout << "Read " << count << " positions" << std::endl;
+    }
+
+    if (!options.packPath.empty()) {
+        std::ofstream out(options.packPath, std::ios::binary);
+        PackedPositions::writeHeader(out, count);
+        out.write(reinterpret_cast<const char*>(positions), count * sizeof(PackedPosition));
+        if (!out) {
+            std::cerr << "Error: cannot write " << options.packPath << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<int> scores(count);
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(options.threads);
+        for (size_t first = 0; first < count; first += options.chunk) {
+            size_t size = std::min(options.chunk, count - first);
+            pool.submit([&, first, size] {
+                Evaluation::evaluateBatch(positions + first, size, scores.data() + first);
+            });
+        }
+        pool.wait();
+    }
+    double seconds = secondsSince(start);
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "Batch:      " << count << " positions in " << std::setprecision(3) << seconds << " s, "
+              << std::setprecision(0) << (seconds > 0 ? count / seconds : 0.0) << " positions/s with "
+              << options.threads << " threads" << std::endl;
+
+    if (options.compare) {
+        // Boards are built first and timed on their own
+        std::vector<Board> boards(count);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) PackedPositions::unpack(positions[i], boards[i]);
+        double unpackSeconds = secondsSince(start);
+
+        AI ai(AILevel::HARD, Color::WHITE);
+        size_t mismatches = 0;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            if (ai.staticEvaluation(boards[i]) != scores[i]) ++mismatches;
+        }
+        seconds = secondsSince(start);
+        std::cout << "Per board:  " << count << " positions in " << std::setprecision(3) << seconds << " s, "
+                  << std::setprecision(0) << (seconds > 0 ? count / seconds : 0.0) << " positions/s with 1 thread, "
+                  << mismatches << " scores differ" << std::endl;
+        std::cout << "  building the boards took " << std::setprecision(3) << unpackSeconds << " s more, "
+                  << std::setprecision(0) << (seconds + unpackSeconds > 0 ? count / (seconds + unpackSeconds) : 0.0)
+                  << " positions/s in all" << std::endl;
+        if (mismatches > 0) return 1;
+    }
+
+    if (!options.scoresPath.empty()) {
+        std::ofstream out(options.scoresPath);
+        for (int score : scores) out << score << '\n';
+        if (!out) {
+            std::cerr << "Error: cannot write " << options.scoresPath << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
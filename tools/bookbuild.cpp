@@ -0,0 +1,299 @@
+// bookbuild - build an opening book from a PGN file
+//
+// Games are read one at a time and replayed on worker threads. Every position
+// up to the ply limit produces a (key, move, result) record. When a worker's
+// buffer fills up it is sorted, combined and written to a temporary run file,
+// so the input can be much larger than memory. The runs are merged at the end
+// into the final sorted book.
+
+#include "../include/Board.h"
+#include "../include/ExternalSort.h"
+#include "../include/Notation.h"
+#include "../include/OpeningBook.h"
+#include "../include/Pgn.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string inputPath;
+    std::string outputPath;
+    std::string tempDir = ".";
+    int maxPly = 24;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int memoryMB = 256;
+    int minGames = 2;
+};
+
+// One position/move pair and how it scored for the side that played it
+struct BookRecord {
+    uint64_t key;
+    uint16_t move;
+    uint32_t games;
+    uint32_t points;  // Half points: win = 2, draw = 1
+};
+
+// Records in key order, then move; the same position and move add up
+struct RecordTraits {
+    static bool less(const BookRecord& a, const BookRecord& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return a.move < b.move;
+    }
+
+    static void combine(BookRecord& total, const BookRecord& more) {
+        total.games += more.games;
+        total.points += more.points;
+    }
+};
+
+using RunSort = ExternalSort<BookRecord, RecordTraits>;
+
+// Bounded queue of game batches between the reader and the workers
+class GameQueue {
+private:
+    std::queue<std::vector<PgnGame>> batches;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    size_t capacity;
+    bool closed = false;
+
+public:
+    explicit GameQueue(size_t maxBatches) : capacity(maxBatches) {}
+
+    void push(std::vector<PgnGame> batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return batches.size() < capacity; });
+        batches.push(std::move(batch));
+        notEmpty.notify_one();
+    }
+
+    bool pop(std::vector<PgnGame>& batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return !batches.empty() || closed; });
+        if (batches.empty()) return false;
+        batch = std::move(batches.front());
+        batches.pop();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+    }
+};
+
+struct Counters {
+    std::atomic<long long> gamesReplayed{0};
+    std::atomic<long long> gamesSkipped{0};
+    std::atomic<long long> positions{0};
+};
+
+// Replay a game and append one record per position
+bool replayGame(const PgnGame& game, int maxPly, std::vector<BookRecord>& records) {
+    int whitePoints;
+    if (game.result == "1-0") whitePoints = 2;
+    else if (game.result == "0-1") whitePoints = 0;
+    else if (game.result == "1/2-1/2") whitePoints = 1;
+    else return false;  // Unfinished games say nothing about the moves
+
+    if (!game.getTag("FEN").empty()) return false;  // Only games from the starting position
+
+    Board board;
+    int plies = std::min(maxPly, static_cast<int>(game.moves.size()));
+    for (int ply = 0; ply < plies; ++ply) {
+        Move move(0, 0, 0, 0);
+        if (!Notation::fromSAN(board, game.moves[ply], move)) {
+            return ply > 0;  // Keep what was replayed before the bad move
+        }
+
+        bool whiteToMove = board.getGameState().currentPlayer == Color::WHITE;
+        uint32_t points = whiteToMove ? whitePoints : 2 - whitePoints;
+        records.push_back(BookRecord{board.getHashKey(), OpeningBook::encodeMove(move), 1, points});
+
+        board.makeMove(move);
+    }
+    return true;
+}
+
+// Returns false if a run could not be written. The queue is still drained
+// after that, so the reader never waits on a worker that has given up.
+bool workerLoop(GameQueue& queue, RunSort& runs, Counters& counters, const Options& options,
+                size_t bufferLimit) {
+    std::vector<BookRecord> records;
+    records.reserve(bufferLimit);
+    std::vector<PgnGame> batch;
+    bool ok = true;
+
+    while (queue.pop(batch)) {
+        if (!ok) continue;
+        for (const PgnGame& game : batch) {
+            size_t before = records.size();
+            if (replayGame(game, options.maxPly, records)) {
+                ++counters.gamesReplayed;
+                counters.positions += records.size() - before;
+            } else {
+                ++counters.gamesSkipped;
+            }
+
+            if (records.size() >= bufferLimit && !runs.spill(records)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    return ok && runs.spill(records);
+}
+
+// K-way merge of all runs into a book at path. Returns the number of entries.
+long long mergeRuns(const RunSort& runs, const std::string& path, const Options& options) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return -1;
+    OpeningBook::writeHeader(out, 0);  // Count is patched in at the end
+
+    long long written = 0;
+    runs.merge([&](const BookRecord& record) {
+        if (static_cast<int>(record.games) < options.minGames) return;
+        BookEntry entry{record.key, record.move,
+                        static_cast<uint16_t>(std::min<uint32_t>(record.points, 65535)), record.games};
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        ++written;
+    });
+
+    out.seekp(0);
+    OpeningBook::writeHeader(out, static_cast<uint64_t>(written));
+    out.close();  // Flushes - a full disk shows up here
+    return out ? written : -1;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <input.pgn> <output.bin> [options]\n\n"
+              << "Options:\n"
+              << "  --max-ply N     Positions per game to include (default 24)\n"
+              << "  --min-games N   Drop moves played in fewer games (default 2)\n"
+              << "  --threads N     Worker threads (default: all cores)\n"
+              << "  --memory MB     Records kept in memory before spilling (default 256)\n"
+              << "  --tmp DIR       Directory for temporary run files (default .)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--max-ply" && hasValue) options.maxPly = std::stoi(argv[++i]);
+        else if (arg == "--min-games" && hasValue) options.minGames = std::stoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--memory" && hasValue) options.memoryMB = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--tmp" && hasValue) options.tempDir = argv[++i];
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else positional.push_back(arg);
+    }
+
+    if (positional.size() != 2) return false;
+    options.inputPath = positional[0];
+    options.outputPath = positional[1];
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ifstream input(options.inputPath);
+    if (!input) {
+        std::cerr << "Error: cannot open " << options.inputPath << std::endl;
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    size_t bufferLimit = static_cast<size_t>(options.memoryMB) * 1024 * 1024 /
+                         sizeof(BookRecord) / options.threads;
+    bufferLimit = std::max<size_t>(bufferLimit, 1024);
+
+    GameQueue queue(options.threads * 4);
+    RunSort runs(options.tempDir, "bookbuild");
+    Counters counters;
+
+    std::vector<std::thread> workers;
+    std::vector<char> workerOk(options.threads, 1);
+    for (int i = 0; i < options.threads; ++i) {
+        workers.emplace_back([&, i] {
+            workerOk[i] = workerLoop(queue, runs, counters, options, bufferLimit);
+        });
+    }
+
+    // Stream the PGN file to the workers in batches
+    PgnReader reader(input);
+    long long gamesRead = 0;
+    const size_t batchSize = 256;
+    std::vector<PgnGame> batch;
+    PgnGame game;
+    while (reader.readGame(game)) {
+        batch.push_back(std::move(game));
+        ++gamesRead;
+        if (batch.size() == batchSize) {
+            queue.push(std::move(batch));
+            batch = std::vector<PgnGame>();
+        }
+    }
+    if (!batch.empty()) queue.push(std::move(batch));
+    queue.close();
+
+    for (std::thread& worker : workers) worker.join();
+
+    // A missing run would silently leave its positions out of the book
+    if (std::find(workerOk.begin(), workerOk.end(), 0) != workerOk.end()) {
+        std::cerr << "Error: not all positions could be spilled to " << options.tempDir
+                  << ", no book written" << std::endl;
+        return 1;
+    }
+
+    // Merged next to the output and renamed into place once complete, so a
+    // failed merge never leaves a partial book (or replaces a good one)
+    std::string partialPath = options.outputPath + ".partial";
+    long long entries = mergeRuns(runs, partialPath, options);
+    runs.removeRuns();
+
+    if (entries < 0 || std::rename(partialPath.c_str(), options.outputPath.c_str()) != 0) {
+        std::remove(partialPath.c_str());
+        std::cerr << "Error: could not write " << options.outputPath << std::endl;
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Games read:      " << gamesRead << "\n"
+              << "Games replayed:  " << counters.gamesReplayed << "\n"
+              << "Games skipped:   " << counters.gamesSkipped << "\n"
+              << "Positions:       " << counters.positions << "\n"
+              << "Sorted runs:     " << runs.runCount() << "\n"
+              << "Book entries:    " << entries << "\n"
+              << "Time:            " << seconds << " s\n";
+
+    return 0;
+}
@@ -0,0 +1,347 @@
+// epdtest - run the AI over an EPD test suite
+//
+// Each position carries the expected best move(s) ("bm") and/or moves to
+// avoid ("am"). The AI searches every position with a fixed time, node or
+// depth budget; positions are spread over a thread pool. The report shows
+// how many were solved, how long it took to settle on the right move, and
+// the search speed. --json writes the same data for scripts and CI.
+
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/Epd.h"
+#include "../include/Notation.h"
+#include "../include/Tablebase.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> suitePaths;
+    std::string jsonPath;
+    std::string tablebaseDir;
+    int timeMs = 0;
+    long long nodes = 0;
+    int depth = 0;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int hashMB = static_cast<int>(TranspositionTable::DEFAULT_SIZE_MB);
+    bool pin = false;
+    bool printStats = false;
+};
+
+struct TestPosition {
+    std::string source;  // file:line
+    std::string id;
+    EpdRecord record;
+};
+
+struct TestResult {
+    bool valid = false;         // Position and expected moves could be read
+    bool solved = false;
+    std::string played;         // SAN of the move chosen
+    std::string expected;       // "bm ..." / "am ..."
+    std::string statsReport;    // SearchStats::print output, with --stats
+    double solveMs = -1.0;      // Time of the iteration from which the answer stayed right
+    double searchMs = 0.0;
+    long long nodes = 0;
+    int depth = 0;              // Deepest completed iteration
+    int peakPly = 0;
+    double ttHitRate = 0.0;
+    double pawnHitRate = 0.0;
+    double firstMoveCutoffRate = 0.0;
+    double branchingFactor = 0.0;  // Of the last iteration
+};
+
+// Moves listed in an operation like "bm Nf3 Qxd5+"; false if one doesn't parse.
+// Moves are kept as generated SAN, so "e8Q" and "e8=Q" compare equal.
+bool parseMoveList(const Board& board, const std::string& text, std::vector<std::string>& moves) {
+    std::istringstream stream(text);
+    std::string san;
+    while (stream >> san) {
+        Move move(0, 0, 0, 0);
+        if (!Notation::fromSAN(board, san, move)) return false;
+        moves.push_back(Notation::toSAN(board, move));
+    }
+    return true;
+}
+
+bool contains(const std::vector<std::string>& moves, const std::string& move) {
+    return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+TestResult runPosition(const TestPosition& position, const Options& options,
+                       const std::shared_ptr<const Tablebase>& tablebase) {
+    TestResult result;
+
+    Board board;
+    if (!board.loadFEN(position.record.fen)) return result;
+
+    std::vector<std::string> bestMoves;
+    std::vector<std::string> avoidMoves;
+    std::string bm = position.record.getOperation("bm");
+    std::string am = position.record.getOperation("am");
+    if (!parseMoveList(board, bm, bestMoves) || !parseMoveList(board, am, avoidMoves)) return result;
+    if (bestMoves.empty() && avoidMoves.empty()) return result;
+
+    result.expected = bestMoves.empty() ? "am " + am : "bm " + bm;
+    if (!bestMoves.empty() && !avoidMoves.empty()) result.expected += "; am " + am;
+    result.valid = true;
+
+    auto isCorrect = [&](const Move& move) {
+        std::string code = Notation::toSAN(board, move);
+        return (bestMoves.empty() || contains(bestMoves, code)) && !contains(avoidMoves, code);
+    };
+
+    AI ai(AILevel::HARD, board.getGameState().currentPlayer);
+    ai.setHashSize(options.hashMB);
+    ai.setSearchDepth(options.depth);
+    ai.setTimeLimit(options.timeMs);
+    ai.setNodeLimit(options.nodes);
+    ai.setTablebase(tablebase);
+    ai.setIterationCallback([&](const SearchIteration& iteration) {
+        result.depth = iteration.depth;
+        if (!isCorrect(iteration.bestMove)) {
+            result.solveMs = -1.0;
+        } else if (result.solveMs < 0.0) {
+            result.solveMs = iteration.milliseconds;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    Move move = ai.getBestMove(board);
+    result.searchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const SearchStats& stats = ai.getLastSearchStats();
+    result.nodes = stats.nodes;
+    result.peakPly = stats.peakPly;
+    result.ttHitRate = stats.getTTHitRate();
+    result.pawnHitRate = stats.getPawnHitRate();
+    result.firstMoveCutoffRate = stats.getFirstMoveCutoffRate();
+    if (stats.iterations.size() > 1) {
+        result.branchingFactor = stats.iterations.back().branchingFactor;
+    }
+    if (options.printStats) {
+        std::ostringstream report;
+        stats.print(report);
+        result.statsReport = report.str();
+    }
+    result.played = Notation::toSAN(board, move);
+    result.solved = isCorrect(move);
+    if (!result.solved) result.solveMs = -1.0;
+    return result;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            out += buffer;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+bool loadSuite(const std::string& path, std::vector<TestPosition>& positions) {
+    std::ifstream input(path);
+    if (!input) return false;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        TestPosition position;
+        if (!parseEpd(line, position.record)) continue;
+        position.source = path + ":" + std::to_string(lineNumber);
+        position.id = position.record.getOperation("id");
+        if (position.id.empty()) position.id = position.source;
+        positions.push_back(position);
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <suite.epd>... [options]\n\n"
+              << "Options:\n"
+              << "  --time MS       Search time per position (default 1000 if no other limit)\n"
+              << "  --nodes N       Node budget per position\n"
+              << "  --depth N       Fixed search depth\n"
+              << "  --threads N     Positions searched at once (default: all cores)\n"
+              << "  --hash MB       Transposition table size per search (default 16)\n"
+              << "  --pin           Pin every search thread to its own core\n"
+              << "  --tb DIR        Probe endgame tablebases from DIR\n"
+              << "  --json FILE     Write the results as JSON\n"
+              << "  --stats         Print the search statistics of every position\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--time" && hasValue) options.timeMs = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--nodes" && hasValue) options.nodes = std::max(1LL, std::stoll(argv[++i]));
+        else if (arg == "--depth" && hasValue) options.depth = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--hash" && hasValue) options.hashMB = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--pin") options.pin = true;
+        else if (arg == "--tb" && hasValue) options.tablebaseDir = argv[++i];
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--stats") options.printStats = true;
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else options.suitePaths.push_back(arg);
+    }
+
+    if (options.timeMs == 0 && options.nodes == 0 && options.depth == 0) {
+        options.timeMs = 1000;
+    }
+    return !options.suitePaths.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<TestPosition> positions;
+    for (const std::string& path : options.suitePaths) {
+        if (!loadSuite(path, positions)) {
+            std::cerr << "Error: cannot open " << path << std::endl;
+            return 1;
+        }
+    }
+
+    std::shared_ptr<const Tablebase> tablebase;
+    if (!options.tablebaseDir.empty()) {
+        auto tables = std::make_shared<Tablebase>();
+        if (tables->load(options.tablebaseDir) == 0) {
+            std::cerr << "Error: no tablebases found in " << options.tablebaseDir << std::endl;
+            return 1;
+        }
+        tablebase = tables;
+    }
+
+    std::vector<TestResult> results(positions.size());
+    std::mutex outputMutex;
+    auto startTime = std::chrono::steady_clock::now();
+
+    {
+        ThreadPool pool(options.threads, options.pin);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            pool.submit([&, i] {
+                TestResult result = runPosition(positions[i], options, tablebase);
+
+                std::lock_guard<std::mutex> lock(outputMutex);
+                results[i] = result;
+                std::cout << std::left << std::setw(24) << positions[i].id << std::right;
+                if (!result.valid) {
+                    std::cout << "  skipped (bad position or no bm/am)" << std::endl;
+                    return;
+                }
+                std::cout << (result.solved ? "  solved  " : "  FAILED  ")
+                          << std::setw(8) << result.played << "  " << std::setw(16) << result.expected
+                          << "  depth " << std::setw(2) << result.depth
+                          << "  nodes " << std::setw(10) << result.nodes << std::endl;
+                std::cout << result.statsReport;
+            });
+        }
+        pool.wait();
+    }
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    int tested = 0;
+    int solved = 0;
+    long long totalNodes = 0;
+    double searchMs = 0.0;
+    double solveMs = 0.0;
+    for (const TestResult& result : results) {
+        if (!result.valid) continue;
+        ++tested;
+        totalNodes += result.nodes;
+        searchMs += result.searchMs;
+        if (result.solved) {
+            ++solved;
+            solveMs += result.solveMs;
+        }
+    }
+
+    double averageSolveMs = solved > 0 ? solveMs / solved : 0.0;
+    long long nps = searchMs > 0.0 ? static_cast<long long>(totalNodes / (searchMs / 1000.0)) : 0;
+
+    std::cout << "\nSolved:                " << solved << " / " << tested << "\n"
+              << "Average time to solve: " << std::fixed << std::setprecision(1) << averageSolveMs << " ms\n"
+              << "Total nodes:           " << totalNodes << "\n"
+              << "Nodes per second:      " << nps << " (per search thread)\n"
+              << "Wall time:             " << std::setprecision(2) << wallSeconds << " s\n";
+
+    if (!options.jsonPath.empty()) {
+        std::ofstream json(options.jsonPath);
+        if (!json) {
+            std::cerr << "Error: cannot write " << options.jsonPath << std::endl;
+            return 1;
+        }
+
+        json << std::fixed << std::setprecision(3)
+             << "{\n"
+             << "  \"limits\": {\"time_ms\": " << options.timeMs << ", \"nodes\": " << options.nodes
+             << ", \"depth\": " << options.depth << "},\n"
+             << "  \"positions\": " << tested << ",\n"
+             << "  \"solved\": " << solved << ",\n"
+             << "  \"average_solve_ms\": " << averageSolveMs << ",\n"
+             << "  \"total_nodes\": " << totalNodes << ",\n"
+             << "  \"nps\": " << nps << ",\n"
+             << "  \"wall_seconds\": " << wallSeconds << ",\n"
+             << "  \"results\": [";
+
+        bool first = true;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const TestResult& result = results[i];
+            if (!result.valid) continue;
+            json << (first ? "\n" : ",\n")
+                 << "    {\"id\": " << jsonString(positions[i].id)
+                 << ", \"fen\": " << jsonString(positions[i].record.fen)
+                 << ", \"expected\": " << jsonString(result.expected)
+                 << ", \"played\": " << jsonString(result.played)
+                 << ", \"solved\": " << (result.solved ? "true" : "false")
+                 << ", \"solve_ms\": " << result.solveMs
+                 << ", \"search_ms\": " << result.searchMs
+                 << ", \"depth\": " << result.depth
+                 << ", \"nodes\": " << result.nodes
+                 << ", \"peak_ply\": " << result.peakPly
+                 << ", \"tt_hit_rate\": " << result.ttHitRate
+                 << ", \"pawn_hit_rate\": " << result.pawnHitRate
+                 << ", \"first_move_cutoff_rate\": " << result.firstMoveCutoffRate
+                 << ", \"ebf\": " << result.branchingFactor << "}";
+            first = false;
+        }
+        json << "\n  ]\n}\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+// evalbench - cost of the static evaluation in nanoseconds per call
+//
+// Plays random games to collect positions, then times the full hand-written
+// evaluation and its parts over them. The full evaluation has a cost
+// budget: the exit status is 1 when it is slower, so a change that makes
+// the evaluation much more expensive shows up like a failing test.
+
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/Mobility.h"
+#include "../include/PawnStructure.h"
+#include "../include/PieceSquareTables.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Full evaluation budget. Generous for a desktop CPU from the last decade;
+// it is there to catch evaluation terms that cost far more than planned.
+const double DEFAULT_BUDGET_NS = 1000.0;
+
+struct Options {
+    int games = 200;
+    double seconds = 0.5;  // Per measurement
+    double budgetNs = DEFAULT_BUDGET_NS;
+    uint32_t seed = 1;
+};
+
+std::vector<Board> playRandomGames(int games, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Board> positions;
+    for (int game = 0; game < games; ++game) {
+        Board board;
+        for (int ply = 0; ply < 200; ++ply) {
+            std::vector<Move> moves = board.getAllLegalMoves(board.getGameState().currentPlayer);
+            if (moves.empty() || board.isDraw()) break;
+
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            board.makeMove(moves[pick(rng)]);
+            positions.push_back(board);
+        }
+    }
+    return positions;
+}
+
+// Nanoseconds per call, running passes over the positions until the time is up.
+// The checksum keeps the compiler from dropping the calls.
+template <typename Evaluate>
+double measure(const std::vector<Board>& positions, double seconds, long long& checksum, Evaluate evaluate) {
+    long long calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        for (const Board& board : positions) checksum += evaluate(board);
+        calls += static_cast<long long>(positions.size());
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return elapsed * 1e9 / calls;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Options:\n"
+              << "  --games N           Random games to take positions from (default 200)\n"
+              << "  --seconds S         Time per measurement (default 0.5)\n"
+              << "  --budget NS         Fail if the full evaluation takes longer (default "
+              << DEFAULT_BUDGET_NS << ")\n"
+              << "  --seed N            Seed for the random games\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) options.games = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--seconds" && hasValue) options.seconds = std::max(0.01, std::stod(argv[++i]));
+        else if (arg == "--budget" && hasValue) options.budgetNs = std::stod(argv[++i]);
+        else if (arg == "--seed" && hasValue) options.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Board> positions = playRandomGames(options.games, options.seed);
+    std::cout << positions.size() << " positions from " << options.games << " random games" << std::endl;
+
+    AI ai(AILevel::HARD, Color::WHITE);
+    long long checksum = 0;
+
+    struct Part {
+        const char* name;
+        double ns;
+    };
+    std::vector<Part> parts = {
+        {"tapered material/PST", measure(positions, options.seconds, checksum, [](const Board& board) {
+            return PieceSquareTables::taper(board.getMidgameScore(), board.getEndgameScore(), board.getPhase());
+        })},
+        {"pawn structure (uncached)", measure(positions, options.seconds, checksum, [](const Board& board) {
+            return PawnStructure::evaluate(board.getPawnBitboard(Color::WHITE), board.getPawnBitboard(Color::BLACK));
+        })},
+        {"mobility and king safety", measure(positions, options.seconds, checksum, [](const Board& board) {
+            Mobility::Score score = Mobility::evaluate(board);
+            return score.midgame + score.endgame;
+        })},
+    };
+    double full = measure(positions, options.seconds, checksum, [&ai](const Board& board) {
+        return ai.staticEvaluation(board);
+    });
+    parts.push_back({"full evaluation", full});
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Part& part : parts) {
+        std::cout << std::left << std::setw(28) << part.name << std::right << std::setw(10) << part.ns
+                  << " ns/call" << std::endl;
+    }
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+    if (full > options.budgetNs) {
+        std::cout << "FAILED: full evaluation takes " << full << " ns, budget " << options.budgetNs << " ns"
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "Full evaluation is within the budget of " << options.budgetNs << " ns" << std::endl;
+    return 0;
+}
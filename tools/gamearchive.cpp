@@ -0,0 +1,240 @@
+// gamearchive - convert PGN to the binary game archive and compare the two
+//
+// Converts one game at a time, then reports the size of both files and how
+// fast each one decodes on one thread: the PGN read and its SAN resolved
+// move by move, against the archive's move indexes (and, for comparison,
+// the archive decoded all the way back to SAN). --verify checks every
+// decoded game against the PGN; --game N prints one game from the archive.
+
+#include "../include/Board.h"
+#include "../include/GameArchive.h"
+#include "../include/Notation.h"
+#include "../include/Pgn.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string pgnPath;
+    std::string archivePath;
+    bool verify = false;
+    long long game = -1;  // Print this game instead of converting
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Decoded {
+    size_t games = 0;
+    size_t moves = 0;
+    double seconds = 0.0;
+};
+
+void printRate(const char* name, const Decoded& decoded) {
+    double rate = decoded.seconds > 0 ? 1.0 / decoded.seconds : 0.0;
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+              << decoded.seconds << " s  " << std::setprecision(0) << std::setw(9) << decoded.games * rate
+              << " games/s  " << std::setw(10) << decoded.moves * rate << " moves/s" << std::endl;
+}
+
+// PGN text to moves on a Board, as every PGN consumer has to
+Decoded decodePgn(const std::string& path) {
+    Decoded decoded;
+    auto start = std::chrono::steady_clock::now();
+    std::ifstream input(path);
+    PgnReader reader(input);
+    PgnGame game;
+    Board board;
+    Move move;
+    while (reader.readGame(game)) {
+        std::string fen = game.getTag("FEN");
+        if (fen.empty() || !board.loadFEN(fen)) board.resetToStartingPosition();
+        for (const std::string& san : game.moves) {
+            if (!Notation::fromSAN(board, san, move) || !board.makeMove(move)) break;
+            ++decoded.moves;
+        }
+        ++decoded.games;
+    }
+    decoded.seconds = secondsSince(start);
+    return decoded;
+}
+
+template <typename Read>
+Decoded decodeArchive(const GameArchive& archive, Read read) {
+    Decoded decoded;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < archive.gameCount(); ++index) {
+        decoded.moves += read(index);
+        ++decoded.games;
+    }
+    decoded.seconds = secondsSince(start);
+    return decoded;
+}
+
+int printGame(const Options& options) {
+    GameArchive archive;
+    if (!archive.open(options.archivePath)) {
+        std::cerr << "Error: cannot open " << options.archivePath << std::endl;
+        return 1;
+    }
+    PgnGame game;
+    if (options.game < 0 || !archive.readGame(static_cast<size_t>(options.game), game)) {
+        std::cerr << "Error: no game " << options.game << " (" << archive.gameCount() << " games)" << std::endl;
+        return 1;
+    }
+    writePgnGame(std::cout, game);
+    return 0;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <games.pgn> <games.cga> [--verify]\n"
+              << "       " << program << " --game N <games.cga>\n\n"
+              << "Options:\n"
+              << "  --verify            Check every archived game against the PGN\n"
+              << "  --game N            Print game N (from 0) of an archive as PGN\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--verify") options.verify = true;
+        else if (arg == "--game" && hasValue) options.game = std::stoll(argv[++i]);
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else positional.push_back(arg);
+    }
+
+    if (options.game >= 0) {
+        if (positional.size() != 1) return false;
+        options.archivePath = positional[0];
+        return true;
+    }
+    if (positional.size() != 2) return false;
+    options.pgnPath = positional[0];
+    options.archivePath = positional[1];
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.game >= 0) return printGame(options);
+
+    std::ifstream input(options.pgnPath);
+    if (!input) {
+        std::cerr << "Error: cannot open " << options.pgnPath << std::endl;
+        return 1;
+    }
+    GameArchive::Writer writer(options.archivePath);
+    if (!writer.isOpen()) {
+        std::cerr << "Error: cannot write " << options.archivePath << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    PgnReader reader(input);
+    PgnGame game;
+    size_t skipped = 0;
+    size_t moves = 0;
+    while (reader.readGame(game)) {
+        if (writer.add(game)) moves += game.moves.size();
+        else ++skipped;
+    }
+    if (!writer.finish()) {
+        std::cerr << "Error: could not write " << options.archivePath << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(start);
+
+    GameArchive archive;
+    if (!archive.open(options.archivePath)) {
+        std::cerr << "Error: cannot read back " << options.archivePath << std::endl;
+        return 1;
+    }
+    input.clear();
+    input.seekg(0, std::ios::end);
+    double pgnBytes = static_cast<double>(input.tellg());
+    double archiveBytes = static_cast<double>(archive.size());
+
+    std::cout << std::fixed << std::setprecision(2) << "Converted " << archive.gameCount() << " games, " << moves
+              << " moves in " << seconds << " s";
+    if (skipped > 0) std::cout << " (" << skipped << " games with unreadable moves skipped)";
+    std::cout << "\n"
+              << "PGN:      " << std::setw(10) << pgnBytes / 1048576.0 << " MB\n"
+              << "Archive:  " << std::setw(10) << archiveBytes / 1048576.0 << " MB  ("
+              << std::setprecision(1) << 100.0 * archiveBytes / std::max(1.0, pgnBytes) << "% of the PGN, "
+              << std::setprecision(2) << archiveBytes * 8.0 / std::max<size_t>(1, moves)
+              << " bits per move with tags and index)" << std::endl;
+
+    printRate("PGN to moves", decodePgn(options.pgnPath));
+    Board board;
+    std::vector<Move> decoded;
+    printRate("Archive to moves", decodeArchive(archive, [&](size_t index) {
+        archive.readMoves(index, board, decoded);
+        return decoded.size();
+    }));
+    PgnGame back;
+    printRate("Archive to SAN", decodeArchive(archive, [&](size_t index) {
+        archive.readGame(index, back);
+        return back.moves.size();
+    }));
+
+    if (options.verify) {
+        input.clear();
+        input.seekg(0);
+        PgnReader again(input);
+        size_t index = 0;
+        size_t different = 0;
+        while (again.readGame(game)) {
+            Board check;
+            std::string fen = game.getTag("FEN");
+            if (!fen.empty() && !check.loadFEN(fen)) continue;
+            bool readable = true;
+            Move move;
+            for (const std::string& san : game.moves) {
+                readable = readable && Notation::fromSAN(check, san, move) && check.makeMove(move);
+            }
+            if (!readable) continue;  // Skipped when converting
+
+            if (!archive.readGame(index++, back) || back.tags != game.tags || back.result != game.result ||
+                back.moves.size() != game.moves.size()) {
+                ++different;
+                continue;
+            }
+            // Compare through fresh SAN, so "Nf3+" and "Nf3" are the same move
+            Board replay;
+            if (!fen.empty()) replay.loadFEN(fen);
+            for (size_t ply = 0; ply < game.moves.size(); ++ply) {
+                Notation::fromSAN(replay, game.moves[ply], move);
+                if (Notation::toSAN(replay, move) != back.moves[ply]) {
+                    ++different;
+                    break;
+                }
+                replay.makeMove(move);
+            }
+        }
+        std::cout << (different == 0 ? "Verified: every game decodes to the same moves"
+                                     : "VERIFY FAILED: " + std::to_string(different) + " games differ")
+                  << std::endl;
+        if (different > 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+// hashbench - measure what huge pages do for the transposition table
+//
+// Searches a fixed set of middlegame positions to a fixed depth with a
+// large transposition table, once on ordinary pages and once on huge pages
+// (explicit if the system has reserved some, transparent otherwise), a few
+// rounds each, alternating. Every page of both tables is written once before
+// anything is timed, and the table is cleared between searches, so the
+// timed searches pay no page faults; what is left is the cost of the TLB
+// misses of the probes. Node counts must be the same for both kinds of
+// page - only the speed may differ.
+
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/LargePages.h"
+#include "../include/ThreadPool.h"
+#include "../include/TranspositionTable.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+struct Options {
+    int hashMB = 256;
+    int depth = 4;
+    int rounds = 3;
+    bool pin = false;
+};
+
+const char* const POSITIONS[] = {
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r1bq1rk1/ppp2ppp/2np1n2/2b1p3/2B1P3/2NP1N2/PPP2PPP/R1BQ1RK1 w - - 0 7",
+    "rnbqkb1r/pp3ppp/4pn2/2pp4/3P4/2PBPN2/PP3PPP/RNBQK2R b KQkq - 1 5",
+    "r2q1rk1/pb1nbppp/1p2pn2/2pp4/3P4/1P2PNP1/PBPNQPBP/R4RK1 w - - 2 10",
+    "2rq1rk1/pp1bppbp/3p1np1/4n3/3NP3/1BN1BP2/PPPQ2PP/2KR3R w - - 7 12",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+struct Round {
+    long long nodes = 0;
+    double seconds = 0.0;
+};
+
+Round searchAll(AI& ai) {
+    Round round;
+    for (const char* fen : POSITIONS) {
+        Board board;
+        board.loadFEN(fen);
+        ai.setColor(board.getGameState().currentPlayer);
+        ai.clearHash();
+
+        auto start = std::chrono::steady_clock::now();
+        ai.getBestMove(board);
+        round.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        round.nodes += ai.getLastSearchStats().nodes;
+    }
+    return round;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Options:\n"
+              << "  --hash MB       Transposition table size (default 256)\n"
+              << "  --depth N       Search depth (default 4)\n"
+              << "  --rounds N      Rounds per kind of page (default 3)\n"
+              << "  --pin           Pin the search to one core\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--hash" && hasValue) options.hashMB = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--depth" && hasValue) options.depth = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--rounds" && hasValue) options.rounds = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--pin") options.pin = true;
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.pin && !ThreadPool::pinCurrentThread(0)) {
+        std::cerr << "Warning: cannot pin threads on this system" << std::endl;
+    }
+
+    // One engine per kind of page, so each table is allocated (and its
+    // pages chosen) once, before anything is timed. A fresh table is not
+    // cleared, so without the prefault the first search would fault its
+    // pages in.
+    std::unique_ptr<AI> engines[2];
+    for (int large = 0; large < 2; ++large) {
+        TranspositionTable::setLargePages(large == 1);
+        engines[large] = std::make_unique<AI>(AILevel::HARD);
+        engines[large]->setHashSize(options.hashMB);
+        engines[large]->setSearchDepth(options.depth);
+        engines[large]->prefaultHash();
+    }
+    TranspositionTable::setLargePages(true);
+
+    const char* names[2] = {"Normal pages", "Huge pages"};
+    double bestNps[2] = {0.0, 0.0};
+    long long nodes[2] = {0, 0};
+    std::cout << std::fixed << std::setprecision(0);
+    for (int round = 1; round <= options.rounds; ++round) {
+        for (int large = 0; large < 2; ++large) {
+            Round result = searchAll(*engines[large]);
+            double nps = result.nodes / std::max(result.seconds, 1e-9);
+            bestNps[large] = std::max(bestNps[large], nps);
+            nodes[large] = result.nodes;
+            std::cout << "Round " << round << "  " << std::left << std::setw(14) << names[large] << std::right
+                      << std::setw(10) << result.nodes << " nodes  " << std::setw(10) << nps << " nodes/s" << std::endl;
+        }
+    }
+
+    std::cout << "\nTable:         " << options.hashMB << " MB per search, depth " << options.depth << "\n";
+    for (int large = 0; large < 2; ++large) {
+        std::cout << std::left << std::setw(15) << (std::string(names[large]) + ":") << std::right
+                  << LargePages::describe(engines[large]->getHashPageKind()) << ", best "
+                  << bestNps[large] << " nodes/s\n";
+    }
+    std::cout << std::setprecision(1) << "Speedup:       "
+              << 100.0 * (bestNps[1] / std::max(bestNps[0], 1e-9) - 1.0) << "%\n";
+
+    if (nodes[0] != nodes[1]) {
+        std::cerr << "Error: node counts differ between page kinds" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+// nnuebench - measure the speed of the neural network evaluation
+//
+// Plays random games to collect positions, then evaluates them over and
+// over: once refreshing the accumulator from scratch for every position,
+// once updating it incrementally along each game as the search does. Each
+// kernel the CPU supports is measured; the checksums show they agree.
+// Without --net a network with random weights of the given size is used.
+
+#include "../include/Board.h"
+#include "../include/Nnue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string networkPath;
+    int hiddenSize = 256;
+    int outputHidden = 32;
+    int games = 200;
+    double seconds = 1.0;  // Per measurement
+    uint32_t seed = 1;
+    std::string kernel = "all";
+};
+
+// A position and whether it follows the previous one by a single move
+struct Sample {
+    Board board;
+    bool continuesGame;
+};
+
+std::vector<Sample> playRandomGames(int games, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Sample> samples;
+    for (int game = 0; game < games; ++game) {
+        Board board;
+        samples.push_back(Sample{board, false});
+        for (int ply = 0; ply < 200; ++ply) {
+            std::vector<Move> moves = board.getAllLegalMoves(board.getGameState().currentPlayer);
+            if (moves.empty() || board.isDraw()) break;
+
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            board.makeMove(moves[pick(rng)]);
+            samples.push_back(Sample{board, true});
+        }
+    }
+    return samples;
+}
+
+struct Measurement {
+    double evalsPerSecond;
+    long long checksum;  // Sum of the scores of one pass
+};
+
+// Run passes over the samples until the time is used up
+template <typename Pass>
+Measurement measure(const std::vector<Sample>& samples, double seconds, Pass pass) {
+    long long checksum = pass();
+    long long evaluations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        pass();
+        evaluations += static_cast<long long>(samples.size());
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return Measurement{evaluations / elapsed, checksum};
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Options:\n"
+              << "  --net FILE          Network to measure (default: random weights)\n"
+              << "  --hidden N          Accumulator size of the random network (default 256)\n"
+              << "  --hidden2 N         Second layer size of the random network (default 32)\n"
+              << "  --games N           Random games to take positions from (default 200)\n"
+              << "  --seconds S         Time per measurement (default 1)\n"
+              << "  --seed N            Seed for the games and the random network\n"
+              << "  --kernel K          scalar, avx2 or all (default all)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--net" && hasValue) options.networkPath = argv[++i];
+        else if (arg == "--hidden" && hasValue) options.hiddenSize = std::stoi(argv[++i]);
+        else if (arg == "--hidden2" && hasValue) options.outputHidden = std::stoi(argv[++i]);
+        else if (arg == "--games" && hasValue) options.games = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--seconds" && hasValue) options.seconds = std::max(0.01, std::stod(argv[++i]));
+        else if (arg == "--seed" && hasValue) options.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--kernel" && hasValue) options.kernel = argv[++i];
+        else return false;
+    }
+    return options.kernel == "all" || options.kernel == "scalar" || options.kernel == "avx2";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Nnue::Network network;
+    if (!options.networkPath.empty()) {
+        if (!network.load(options.networkPath)) {
+            std::cerr << "Error: cannot load network " << options.networkPath << std::endl;
+            return 1;
+        }
+    } else {
+        const std::string path = "nnuebench.tmp";
+        if (!Nnue::writeRandomNetwork(path, options.hiddenSize, options.outputHidden, options.seed) ||
+            !network.load(path)) {
+            std::cerr << "Error: bad network size " << options.hiddenSize << "x" << options.outputHidden
+                      << " (hidden must be a multiple of 32 up to " << Nnue::MAX_HIDDEN << ")" << std::endl;
+            std::remove(path.c_str());
+            return 1;
+        }
+        std::remove(path.c_str());  // Stays mapped until the network goes away
+    }
+
+    std::vector<Sample> samples = playRandomGames(options.games, options.seed);
+    std::cout << "Network " << Nnue::INPUT_SIZE << "x2 -> " << network.getHiddenSize() << "x2 -> "
+              << network.getOutputHidden() << " -> 1, " << samples.size() << " positions from "
+              << options.games << " random games" << std::endl;
+
+    std::vector<Nnue::Kernel> kernels;
+    if (options.kernel != "avx2") kernels.push_back(Nnue::Kernel::SCALAR);
+    if (options.kernel != "scalar") {
+        if (Nnue::avx2Supported()) {
+            kernels.push_back(Nnue::Kernel::AVX2);
+        } else {
+            std::cout << "AVX2 is not supported on this CPU" << std::endl;
+        }
+    }
+
+    std::vector<Nnue::Accumulator> accumulators(2);
+    std::cout << std::fixed << std::setprecision(0);
+    for (Nnue::Kernel kernel : kernels) {
+        Nnue::setKernel(kernel);
+
+        Measurement full = measure(samples, options.seconds, [&] {
+            long long sum = 0;
+            for (const Sample& sample : samples) sum += network.evaluate(sample.board);
+            return sum;
+        });
+
+        Measurement incremental = measure(samples, options.seconds, [&] {
+            long long sum = 0;
+            for (size_t i = 0; i < samples.size(); ++i) {
+                Nnue::Accumulator& current = accumulators[i % 2];
+                if (samples[i].continuesGame) {
+                    network.update(current, accumulators[(i + 1) % 2], samples[i].board);
+                } else {
+                    network.refresh(current, samples[i].board);
+                }
+                sum += network.evaluate(current, samples[i].board.getGameState().currentPlayer);
+            }
+            return sum;
+        });
+
+        std::cout << std::left << std::setw(7) << Nnue::kernelName(kernel) << std::right
+                  << "  refresh " << std::setw(10) << full.evalsPerSecond << " evals/s"
+                  << "  incremental " << std::setw(10) << incremental.evalsPerSecond << " evals/s"
+                  << " (" << std::setprecision(1) << 1e9 / incremental.evalsPerSecond << std::setprecision(0)
+                  << " ns)  checksum " << full.checksum << "/" << incremental.checksum << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+// pgnreplay - read a PGN archive through a memory mapping and replay every game
+//
+// The file is indexed by game on all threads, then the games are replayed
+// on Boards in parallel, with a callback per position that folds the
+// position hash keys into a checksum. Reports games and positions per
+// second; --compare reads the same file with the streaming PgnReader on one
+// thread and checks both reach the same positions.
+
+#include "../include/Board.h"
+#include "../include/MappedPgn.h"
+#include "../include/Notation.h"
+#include "../include/Pgn.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string path;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int randomGames = 0;
+    bool compare = false;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Random legal games, for building a test archive of any size
+bool writeRandomGames(const std::string& path, int games) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::mt19937 rng(1);
+    for (int i = 0; i < games; ++i) {
+        Board board;
+        PgnGame game;
+        game.tags = {{"Event", "Random game"}, {"Round", std::to_string(i + 1)}, {"Result", "*"}};
+        for (int ply = 0; ply < 160; ++ply) {
+            std::vector<Move> moves = board.getAllLegalMoves(board.getGameState().currentPlayer);
+            if (moves.empty() || board.isDraw()) break;
+
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            const Move& move = moves[pick(rng)];
+            game.moves.push_back(Notation::toSAN(board, move));
+            board.makeMove(move);
+        }
+        game.result = "*";
+        writePgnGame(out, game);
+    }
+    return static_cast<bool>(out);
+}
+
+// The same replay through PgnReader, one game at a time
+uint64_t streamChecksum(const std::string& path, size_t& games, size_t& positions) {
+    std::ifstream input(path);
+    PgnReader reader(input);
+    PgnGame game;
+    Board board;
+    uint64_t checksum = 0;
+    games = 0;
+    positions = 0;
+    while (reader.readGame(game)) {
+        ++games;
+        std::string fen = game.getTag("FEN");
+        if (fen.empty() || !board.loadFEN(fen)) board.resetToStartingPosition();
+        checksum ^= board.getHashKey();
+        ++positions;
+
+        Move move(0, 0, 0, 0);
+        for (const std::string& san : game.moves) {
+            if (!Notation::fromSAN(board, san, move) || !board.makeMove(move)) break;
+            checksum ^= board.getHashKey();
+            ++positions;
+        }
+    }
+    return checksum;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <games.pgn> [options]\n\n"
+              << "Options:\n"
+              << "  --threads N         Worker threads (default: all cores)\n"
+              << "  --random N          First write N random games to the file\n"
+              << "  --compare           Also replay with the streaming PgnReader and check the positions\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--threads" && hasValue) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--random" && hasValue) options.randomGames = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--compare") options.compare = true;
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else if (options.path.empty()) options.path = arg;
+        else return false;
+    }
+    return !options.path.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.randomGames > 0) {
+        auto start = std::chrono::steady_clock::now();
+        if (!writeRandomGames(options.path, options.randomGames)) {
+            std::cerr << "Error: cannot write " << options.path << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << options.randomGames << " random games in " << std::fixed << std::setprecision(2)
+                  << secondsSince(start) << " s" << std::endl;
+    }
+
+    MappedPgn pgn;
+    auto start = std::chrono::steady_clock::now();
+    if (!pgn.open(options.path, options.threads)) {
+        std::cerr << "Error: cannot open " << options.path << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(start);
+    double megabytes = pgn.size() / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(3) << "Indexed:  " << pgn.gameCount() << " games, "
+              << std::setprecision(1) << megabytes << " MB in " << std::setprecision(3) << seconds << " s"
+              << std::endl;
+
+    std::atomic<uint64_t> checksum(0);
+    MappedPgn::ReplayStats stats = pgn.replay(options.threads, [&](const ReplayPosition& position) {
+        checksum.fetch_xor(position.board.getHashKey(), std::memory_order_relaxed);
+    });
+    double rate = stats.seconds > 0 ? 1.0 / stats.seconds : 0.0;
+    std::cout << std::setprecision(0) << "Replayed: " << stats.games << " games, " << stats.positions
+              << " positions in " << std::setprecision(3) << stats.seconds << " s - " << std::setprecision(0)
+              << stats.games * rate << " games/s, " << stats.positions * rate << " positions/s, "
+              << std::setprecision(1) << megabytes * rate << " MB/s with " << options.threads << " threads"
+              << std::endl;
+    if (stats.failed > 0) {
+        std::cout << stats.failed << " games stopped at a move that didn't resolve" << std::endl;
+    }
+
+    if (options.compare) {
+        size_t games = 0;
+        size_t positions = 0;
+        start = std::chrono::steady_clock::now();
+        uint64_t expected = streamChecksum(options.path, games, positions);
+        seconds = secondsSince(start);
+        bool same = expected == checksum && games == stats.games && positions == stats.positions;
+        std::cout << std::setprecision(0) << "Stream:   " << games << " games, " << positions << " positions in "
+                  << std::setprecision(3) << seconds << " s - " << std::setprecision(0)
+                  << (seconds > 0 ? games / seconds : 0.0) << " games/s with 1 thread, "
+                  << (same ? "same positions" : "POSITIONS DIFFER") << std::endl;
+        if (!same) return 1;
+    }
+
+    return 0;
+}
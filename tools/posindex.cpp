@@ -0,0 +1,176 @@
+// posindex - build a position index from a PGN archive, or look a position up
+//
+// Building maps the PGN file, replays the games on all threads and sorts the
+// (position, move, result) records in runs on disk before merging them into
+// the index, so archives larger than memory work. Afterwards lookups are
+// timed on positions from the first games of the archive.
+
+#include "../include/Board.h"
+#include "../include/MappedPgn.h"
+#include "../include/Notation.h"
+#include "../include/OpeningBook.h"
+#include "../include/PositionIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string pgnPath;
+    std::string indexPath;
+    std::string probeFen;  // Empty when building
+    bool probe = false;
+    PositionIndex::BuildOptions build;
+};
+
+// Keys of the positions in the first games, for timing lookups
+std::vector<uint64_t> sampleKeys(const MappedPgn& archive, size_t games) {
+    std::vector<uint64_t> keys;
+    Board board;
+    for (size_t index = 0; index < std::min(games, archive.gameCount()); ++index) {
+        std::string_view text = archive.game(index);
+        std::string_view fen = MappedPgn::tag(text, "FEN");
+        if (fen.empty() || !board.loadFEN(std::string(fen))) board.resetToStartingPosition();
+
+        PgnTokenizer tokens(text);
+        std::string_view san;
+        Move move;
+        while (tokens.nextMove(san)) {
+            keys.push_back(board.getHashKey());
+            if (!Notation::fromSAN(board, san, move) || !board.makeMove(move)) break;
+        }
+    }
+    return keys;
+}
+
+int probe(const Options& options) {
+    PositionIndex index;
+    if (!index.open(options.indexPath)) {
+        std::cerr << "Error: cannot open " << options.indexPath << std::endl;
+        return 1;
+    }
+    Board board;
+    if (!options.probeFen.empty() && !board.loadFEN(options.probeFen)) {
+        std::cerr << "Error: bad FEN '" << options.probeFen << "'" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PositionIndex::MoveStats> moves = index.lookup(board);
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << board.toFEN() << "\n"
+              << moves.size() << " moves played here (lookup " << std::fixed << std::setprecision(1) << micros
+              << " us)\n";
+    for (const PositionIndex::MoveStats& stats : moves) {
+        Move move = OpeningBook::decodeMove(stats.move);
+        std::string name = board.isValidMove(move) ? Notation::toSAN(board, move) : "?";
+        std::cout << "  " << std::left << std::setw(8) << name << std::right << std::setw(8) << stats.games
+                  << " games  +" << stats.whiteWins << " =" << stats.draws << " -" << stats.blackWins << "\n";
+    }
+    return 0;
+}
+
+int build(const Options& options) {
+    MappedPgn archive;
+    if (!archive.open(options.pgnPath, options.build.threads)) {
+        std::cerr << "Error: cannot open " << options.pgnPath << std::endl;
+        return 1;
+    }
+
+    PositionIndex::BuildStats stats;
+    if (!PositionIndex::build(archive, options.indexPath, options.build, stats)) {
+        std::cerr << "Error: could not write " << options.indexPath << std::endl;
+        return 1;
+    }
+
+    PositionIndex index;
+    if (!index.open(options.indexPath)) {
+        std::cerr << "Error: cannot read back " << options.indexPath << std::endl;
+        return 1;
+    }
+    MappedFile written;
+    written.open(options.indexPath);
+    std::cout << std::fixed << std::setprecision(2)
+              << "Games:           " << stats.games << "\n"
+              << "Positions:       " << stats.positions << "\n"
+              << "Sorted runs:     " << stats.runs << "\n"
+              << "Index entries:   " << stats.entries << " (" << written.size() / 1048576.0 << " MB, "
+              << (stats.entries > 0 ? static_cast<double>(written.size()) / stats.entries : 0.0)
+              << " bytes per entry)\n"
+              << "Build time:      " << stats.seconds << " s\n";
+
+    std::vector<uint64_t> keys = sampleKeys(archive, 1000);
+    if (keys.empty()) return 0;
+
+    size_t lookups = 0;
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        for (uint64_t key : keys) found += !index.lookup(key).empty();
+        lookups += keys.size();
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.5);
+    std::cout << "Lookup:          " << elapsed * 1e6 / lookups << " us (" << lookups << " lookups, "
+              << std::setprecision(1) << 100.0 * found / lookups << "% found)" << std::endl;
+    return 0;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <games.pgn> <index.bin> [options]\n"
+              << "       " << program << " --probe <index.bin> [FEN]\n\n"
+              << "Options:\n"
+              << "  --max-ply N     Positions per game to index (default: all)\n"
+              << "  --threads N     Worker threads (default: all cores)\n"
+              << "  --memory MB     Records kept in memory before spilling (default 256)\n"
+              << "  --tmp DIR       Directory for temporary run files (default .)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--probe") options.probe = true;
+        else if (arg == "--max-ply" && hasValue) options.build.maxPly = std::max(0, std::stoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) options.build.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--memory" && hasValue) options.build.memoryMB = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--tmp" && hasValue) options.build.tempDir = argv[++i];
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else positional.push_back(arg);
+    }
+
+    if (options.probe) {
+        if (positional.empty() || positional.size() > 2) return false;
+        options.indexPath = positional[0];
+        if (positional.size() == 2) options.probeFen = positional[1];
+        return true;
+    }
+    if (positional.size() != 2) return false;
+    options.pgnPath = positional[0];
+    options.indexPath = positional[1];
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return options.probe ? probe(options) : build(options);
+}
@@ -0,0 +1,139 @@
+// sanbench - SAN conversions per second
+//
+// Plays random games and takes every legal move of every position reached,
+// checks that each one survives toSAN and back through fromSAN, then times
+// both directions over the whole set.
+
+#include "../include/Board.h"
+#include "../include/MoveGen.h"
+#include "../include/Notation.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 50;
+    double seconds = 0.5;  // Per measurement
+    uint32_t seed = 1;
+};
+
+struct Sample {
+    size_t position;  // Index into the boards
+    Move move;
+    std::string san;
+};
+
+void playRandomGames(const Options& options, std::vector<Board>& boards, std::vector<Sample>& samples) {
+    std::mt19937 rng(options.seed);
+    MoveGen::MoveList moves;
+    for (int game = 0; game < options.games; ++game) {
+        Board board;
+        for (int ply = 0; ply < 200; ++ply) {
+            MoveGen::generate(MoveGen::Position(board), moves);
+            if (moves.size() == 0 || board.isDraw()) break;
+
+            boards.push_back(board);
+            for (const Move& move : moves) samples.push_back({boards.size() - 1, move, std::string()});
+
+            std::uniform_int_distribution<int> pick(0, moves.size() - 1);
+            board.makeMove(moves.moves[pick(rng)]);
+        }
+    }
+}
+
+bool sameMove(const Move& a, const Move& b) {
+    return a.fromRow == b.fromRow && a.fromCol == b.fromCol && a.toRow == b.toRow && a.toCol == b.toCol &&
+           a.promotionPiece == b.promotionPiece;
+}
+
+// Conversions per second, running passes over the samples until the time is up
+template <typename Convert>
+double measure(const std::vector<Sample>& samples, double seconds, Convert convert) {
+    long long calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        for (const Sample& sample : samples) convert(sample);
+        calls += static_cast<long long>(samples.size());
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return calls / elapsed;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Options:\n"
+              << "  --games N           Random games to take positions from (default 50)\n"
+              << "  --seconds S         Time per measurement (default 0.5)\n"
+              << "  --seed N            Seed for the random games\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) options.games = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--seconds" && hasValue) options.seconds = std::max(0.01, std::stod(argv[++i]));
+        else if (arg == "--seed" && hasValue) options.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Board> boards;
+    std::vector<Sample> samples;
+    playRandomGames(options, boards, samples);
+    std::cout << samples.size() << " moves in " << boards.size() << " positions from " << options.games
+              << " random games" << std::endl;
+
+    // Round trip first: every legal move must come back from its own SAN
+    size_t failed = 0;
+    for (Sample& sample : samples) {
+        const Board& board = boards[sample.position];
+        sample.san = Notation::toSAN(board, sample.move);
+        Move parsed;
+        if (!Notation::fromSAN(board, sample.san, parsed) || !sameMove(parsed, sample.move)) {
+            if (failed++ < 5) std::cout << "Round trip failed: " << sample.san << " in " << board.toFEN() << std::endl;
+        }
+    }
+    if (failed > 0) {
+        std::cout << "FAILED: " << failed << " moves didn't survive the round trip" << std::endl;
+        return 1;
+    }
+
+    size_t length = 0;
+    double toRate = measure(samples, options.seconds, [&](const Sample& sample) {
+        length += Notation::toSAN(boards[sample.position], sample.move).size();
+    });
+    size_t resolved = 0;
+    double fromRate = measure(samples, options.seconds, [&](const Sample& sample) {
+        Move move;
+        resolved += Notation::fromSAN(boards[sample.position], sample.san, move);
+    });
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "toSAN     " << std::setw(8) << toRate / 1e6 << " M conversions/s" << std::endl
+              << "fromSAN   " << std::setw(8) << fromRate / 1e6 << " M conversions/s" << std::endl
+              << "(checksum " << length + resolved << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,606 @@
+// selfplay - play AI-vs-AI matches between two engine configurations
+//
+// Every opening from the suite is played twice, once with each engine as
+// white. Games run in parallel on a work-stealing thread pool, one game per
+// task. Results are reported as an Elo difference with a 95% confidence
+// interval, and an optional SPRT (sequential probability ratio test) stops
+// the match as soon as the result is statistically clear. --watch tiles
+// the running games across the terminal while they play. --positions
+// samples scored positions from the games as training data.
+
+#include "../include/AI.h"
+#include "../include/Board.h"
+#include "../include/Epd.h"
+#include "../include/GameArchive.h"
+#include "../include/Notation.h"
+#include "../include/Nnue.h"
+#include "../include/OpeningBook.h"
+#include "../include/PackedPosition.h"
+#include "../include/Pgn.h"
+#include "../include/Spectator.h"
+#include "../include/Tablebase.h"
+#include "../include/ThreadPool.h"
+#include "../include/TrainingData.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+struct EngineConfig {
+    std::string name;
+    AILevel level = AILevel::MEDIUM;
+    int depth = 0;  // 0 = depth of the level
+    std::string bookPath;
+    std::string tablebaseDir;
+    std::string networkPath;
+
+    // Loaded once and shared by every game
+    std::shared_ptr<const OpeningBook> book;
+    std::shared_ptr<const Tablebase> tablebase;
+    std::shared_ptr<const Nnue::Network> network;
+};
+
+struct SprtConfig {
+    bool enabled = false;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+// Which positions go into the training data
+struct SampleConfig {
+    int rate = 4;        // Keep about one position in this many
+    int skipPlies = 8;   // Never from the first plies of a game
+    int maxScore = 3000; // Positions already decided teach the evaluation nothing
+};
+
+struct Options {
+    int games = 100;
+    int concurrency = std::max(1u, std::thread::hardware_concurrency());
+    bool pin = false;  // One core per game thread
+    int maxPlies = 400;
+    std::string openingsPath;
+    std::string pgnPath;
+    std::string archivePath;
+    std::string positionsPath;
+    SampleConfig sampling;
+    EngineConfig engines[2];
+    SprtConfig sprt;
+    int watch = 0;  // Boards shown while playing
+    int fps = 10;
+};
+
+enum class Outcome { WHITE_WINS, BLACK_WINS, DRAW };
+
+struct GameRecord {
+    PgnGame pgn;
+    Outcome outcome;
+    std::vector<TrainingPosition> samples;
+};
+
+// Split "a=1,b=2" into key/value pairs
+std::vector<std::pair<std::string, std::string>> parseKeyValues(const std::string& text) {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("expected key=value: " + item);
+        }
+        pairs.emplace_back(item.substr(0, equals), item.substr(equals + 1));
+    }
+    return pairs;
+}
+
+void parseEngine(const std::string& text, EngineConfig& engine) {
+    for (const auto& pair : parseKeyValues(text)) {
+        const std::string& key = pair.first;
+        const std::string& value = pair.second;
+        if (key == "name") engine.name = value;
+        else if (key == "depth") engine.depth = std::stoi(value);
+        else if (key == "book") engine.bookPath = value;
+        else if (key == "tb") engine.tablebaseDir = value;
+        else if (key == "nnue") engine.networkPath = value;
+        else if (key == "level") {
+            if (value == "easy") engine.level = AILevel::EASY;
+            else if (value == "medium") engine.level = AILevel::MEDIUM;
+            else if (value == "hard") engine.level = AILevel::HARD;
+            else throw std::invalid_argument("unknown level: " + value);
+        }
+        else throw std::invalid_argument("unknown engine option: " + key);
+    }
+}
+
+void parseSprt(const std::string& text, SprtConfig& sprt) {
+    sprt.enabled = true;
+    for (const auto& pair : parseKeyValues(text)) {
+        double value = std::stod(pair.second);
+        if (pair.first == "elo0") sprt.elo0 = value;
+        else if (pair.first == "elo1") sprt.elo1 = value;
+        else if (pair.first == "alpha") sprt.alpha = value;
+        else if (pair.first == "beta") sprt.beta = value;
+        else throw std::invalid_argument("unknown SPRT option: " + pair.first);
+    }
+}
+
+// One FEN or EPD position per line; '#' starts a comment line
+bool loadOpenings(const std::string& path, std::vector<std::string>& openings) {
+    std::ifstream input(path);
+    if (!input) return false;
+
+    std::string line;
+    EpdRecord record;
+    while (std::getline(input, line)) {
+        if (!parseEpd(line, record)) continue;
+
+        Board board;
+        if (!board.loadFEN(record.fen)) {
+            std::cerr << "Warning: skipping bad opening: " << line << std::endl;
+            continue;
+        }
+        openings.push_back(record.fen);
+    }
+    return true;
+}
+
+bool loadEngineData(EngineConfig& engine) {
+    if (!engine.bookPath.empty()) {
+        auto book = std::make_shared<OpeningBook>();
+        if (!book->load(engine.bookPath)) {
+            std::cerr << "Error: cannot load opening book " << engine.bookPath << std::endl;
+            return false;
+        }
+        engine.book = book;
+    }
+    if (!engine.tablebaseDir.empty()) {
+        auto tables = std::make_shared<Tablebase>();
+        if (tables->load(engine.tablebaseDir) == 0) {
+            std::cerr << "Error: no tablebases found in " << engine.tablebaseDir << std::endl;
+            return false;
+        }
+        engine.tablebase = tables;
+    }
+    if (!engine.networkPath.empty()) {
+        auto net = std::make_shared<Nnue::Network>();
+        if (!net->load(engine.networkPath)) {
+            std::cerr << "Error: cannot load network " << engine.networkPath << std::endl;
+            return false;
+        }
+        engine.network = net;
+    }
+    return true;
+}
+
+std::unique_ptr<AI> createEngine(const EngineConfig& config, Color color) {
+    auto ai = std::make_unique<AI>(config.level, color);
+    ai->setSearchDepth(config.depth);
+    ai->setOpeningBook(config.book);
+    ai->setTablebase(config.tablebase);
+    ai->setNetwork(config.network);
+    return ai;
+}
+
+// Hand the position to the spectator; never waits for the terminal
+void showPosition(Spectator* spectator, int board, int round, int ply, const Board& position,
+                  const std::string& result) {
+    if (!spectator || board < 0) return;
+    BoardSnapshot snapshot{};
+    PackedPositions::pack(position, snapshot.position);
+    snapshot.game = round;
+    snapshot.ply = ply;
+    result.copy(snapshot.result, sizeof(snapshot.result) - 1);
+    spectator->publish(board, snapshot);
+}
+
+// Training positions are quiet positions the engine searched: not in check,
+// and the move played isn't a capture, so the static evaluation of the
+// position is comparable to the search score
+bool isQuiet(const Board& board, const Move& move) {
+    Color toMove = board.getGameState().currentPlayer;
+    return !board.isInCheck(toMove) && board.getPiece(move.toRow, move.toCol).isEmpty();
+}
+
+// Play one game from a position to the end. With sampling, positions are
+// kept in record.samples with the game result filled in.
+GameRecord playGame(const std::string& fen, const EngineConfig& white, const EngineConfig& black,
+                    int round, int maxPlies, Spectator* spectator, const SampleConfig* sampling) {
+    Board board;
+    board.loadFEN(fen);
+    int shownOn = spectator ? spectator->attach() : -1;
+    showPosition(spectator, shownOn, round, 0, board, "");
+
+    std::unique_ptr<AI> engines[2] = {createEngine(white, Color::WHITE), createEngine(black, Color::BLACK)};
+
+    // Score of the last completed iteration, side to move's view; unset
+    // after a book, tablebase or random move
+    const int NO_SCORE = INT_MIN;
+    int searchScore = NO_SCORE;
+    std::mt19937 random(static_cast<unsigned>(round));
+    if (sampling) {
+        for (auto& engine : engines) {
+            engine->setIterationCallback([&searchScore](const SearchIteration& iteration) {
+                searchScore = iteration.score;
+            });
+        }
+    }
+
+    GameRecord record;
+    record.pgn.tags = {
+        {"Event", "Self-play match"},
+        {"Site", "?"},
+        {"Round", std::to_string(round)},
+        {"White", white.name},
+        {"Black", black.name},
+        {"Result", "*"},
+    };
+    if (fen != START_FEN) {
+        record.pgn.tags.emplace_back("SetUp", "1");
+        record.pgn.tags.emplace_back("FEN", fen);
+    }
+
+    // Positions seen since the last irreversible move, for threefold repetition
+    std::unordered_map<uint64_t, int> seen;
+    seen[board.getHashKey()] = 1;
+
+    std::string termination;
+    record.outcome = Outcome::DRAW;
+
+    for (int ply = 0; ; ++ply) {
+        Color toMove = board.getGameState().currentPlayer;
+
+        if (board.isCheckmate(toMove)) {
+            record.outcome = toMove == Color::WHITE ? Outcome::BLACK_WINS : Outcome::WHITE_WINS;
+            termination = "checkmate";
+            break;
+        }
+        if (board.isStalemate(toMove)) {
+            termination = "stalemate";
+            break;
+        }
+        if (board.isDraw()) {
+            termination = "fifty-move rule or insufficient material";
+            break;
+        }
+        if (ply >= maxPlies) {
+            termination = "adjudicated draw after " + std::to_string(maxPlies) + " plies";
+            break;
+        }
+
+        AI& engine = *engines[toMove == Color::WHITE ? 0 : 1];
+        searchScore = NO_SCORE;
+        Move move = engine.getBestMove(board);
+
+        if (sampling && ply >= sampling->skipPlies && searchScore != NO_SCORE &&
+            std::abs(searchScore) <= sampling->maxScore && random() % sampling->rate == 0 && isQuiet(board, move)) {
+            TrainingPosition sample;
+            int whiteScore = toMove == Color::WHITE ? searchScore : -searchScore;
+            if (TrainingData::pack(board, whiteScore, 0, sample)) record.samples.push_back(sample);
+        }
+
+        record.pgn.moves.push_back(Notation::toSAN(board, move));
+        board.makeMove(move);
+        showPosition(spectator, shownOn, round, ply + 1, board, "");
+
+        if (board.getGameState().halfMoveClock == 0) {
+            seen.clear();
+        }
+        if (++seen[board.getHashKey()] >= 3) {
+            termination = "threefold repetition";
+            break;
+        }
+    }
+
+    switch (record.outcome) {
+        case Outcome::WHITE_WINS: record.pgn.result = "1-0"; break;
+        case Outcome::BLACK_WINS: record.pgn.result = "0-1"; break;
+        case Outcome::DRAW: record.pgn.result = "1/2-1/2"; break;
+    }
+    record.pgn.tags[5].second = record.pgn.result;
+    int8_t result = record.outcome == Outcome::WHITE_WINS ? 1 : record.outcome == Outcome::BLACK_WINS ? -1 : 0;
+    for (TrainingPosition& sample : record.samples) sample.result = result;
+    record.pgn.tags.emplace_back("Termination", termination);
+
+    showPosition(spectator, shownOn, round, static_cast<int>(record.pgn.moves.size()), board, record.pgn.result);
+    if (spectator) spectator->detach(shownOn);
+    return record;
+}
+
+// Expected score for an Elo difference, and back
+double eloToScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double scoreToElo(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Match score from engine 1's point of view
+class MatchStats {
+private:
+    std::mutex mutex;
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+public:
+    void add(double points) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (points > 0.75) ++wins;
+        else if (points < 0.25) ++losses;
+        else ++draws;
+    }
+
+    struct Snapshot {
+        int wins, draws, losses;
+
+        int games() const { return wins + draws + losses; }
+        double score() const { return (wins + 0.5 * draws) / games(); }
+
+        // Variance of a single game's result
+        double variance() const {
+            double s = score();
+            return (wins * (1.0 - s) * (1.0 - s) + draws * (0.5 - s) * (0.5 - s) +
+                    losses * s * s) / games();
+        }
+
+        // Log-likelihood ratio of elo1 against elo0, normal approximation.
+        // Until every result type has occurred the variance estimate is
+        // meaningless, so the test waits.
+        double llr(const SprtConfig& sprt) const {
+            if (wins == 0 || draws == 0 || losses == 0) return 0.0;
+            double var = variance();
+            double s0 = eloToScore(sprt.elo0);
+            double s1 = eloToScore(sprt.elo1);
+            return games() * (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * var);
+        }
+    };
+
+    Snapshot snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return Snapshot{wins, draws, losses};
+    }
+};
+
+void printReport(const MatchStats::Snapshot& stats, const Options& options) {
+    std::cout << "\n" << options.engines[0].name << " vs " << options.engines[1].name << ": "
+              << stats.wins << " wins, " << stats.draws << " draws, " << stats.losses
+              << " losses in " << stats.games() << " games\n";
+    if (stats.games() == 0) return;
+
+    double score = stats.score();
+    double margin = 1.96 * std::sqrt(stats.variance() / stats.games());
+    double elo = scoreToElo(score);
+    double low = scoreToElo(score - margin);
+    double high = scoreToElo(score + margin);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Score:  " << 100.0 * score << "%\n"
+              << "Elo:    " << elo << " +/- " << (high - low) / 2.0
+              << " (95% CI " << low << " to " << high << ")\n";
+
+    if (options.sprt.enabled) {
+        double lower = std::log(options.sprt.beta / (1.0 - options.sprt.alpha));
+        double upper = std::log((1.0 - options.sprt.beta) / options.sprt.alpha);
+        double llr = stats.llr(options.sprt);
+        std::cout << std::setprecision(2)
+                  << "SPRT:   llr " << llr << " [" << lower << ", " << upper << "] elo0="
+                  << options.sprt.elo0 << " elo1=" << options.sprt.elo1 << " - ";
+        if (llr >= upper) std::cout << "H1 accepted\n";
+        else if (llr <= lower) std::cout << "H0 accepted\n";
+        else std::cout << "inconclusive\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Options:\n"
+              << "  --games N           Games to play (default 100)\n"
+              << "  --openings FILE     FEN/EPD start positions, each played with both colors\n"
+              << "  --concurrency N     Games played at once (default: all cores)\n"
+              << "  --pin               Pin every game thread to its own core\n"
+              << "  --max-plies N       Adjudicate a draw after N plies (default 400)\n"
+              << "  --engine1 SPEC      First engine, e.g. name=new,level=hard,depth=4,book=b.bin,tb=tb/\n"
+              << "                      (nnue=FILE evaluates with a network)\n"
+              << "  --engine2 SPEC      Second engine (same keys)\n"
+              << "  --pgn FILE          Write finished games to FILE\n"
+              << "  --archive FILE      Write finished games to FILE in the binary game archive format\n"
+              << "  --positions FILE    Write sampled quiet positions with search score and result to FILE\n"
+              << "  --sample-rate N     Keep about one sampled position in N (default 4)\n"
+              << "  --skip-plies N      Don't sample the first N plies of a game (default 8)\n"
+              << "  --sprt SPEC         Stop early on an SPRT decision, e.g. elo0=0,elo1=5,alpha=0.05,beta=0.05\n"
+              << "  --watch N           Show up to N running games, tiled, instead of one line per game\n"
+              << "  --fps N             Screen updates per second while watching (default 10)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.engines[0].name = "engine1";
+    options.engines[1].name = "engine2";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) options.games = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--openings" && hasValue) options.openingsPath = argv[++i];
+        else if (arg == "--concurrency" && hasValue) options.concurrency = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--pin") options.pin = true;
+        else if (arg == "--max-plies" && hasValue) options.maxPlies = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--engine1" && hasValue) parseEngine(argv[++i], options.engines[0]);
+        else if (arg == "--engine2" && hasValue) parseEngine(argv[++i], options.engines[1]);
+        else if (arg == "--pgn" && hasValue) options.pgnPath = argv[++i];
+        else if (arg == "--archive" && hasValue) options.archivePath = argv[++i];
+        else if (arg == "--positions" && hasValue) options.positionsPath = argv[++i];
+        else if (arg == "--sample-rate" && hasValue) options.sampling.rate = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--skip-plies" && hasValue) options.sampling.skipPlies = std::max(0, std::stoi(argv[++i]));
+        else if (arg == "--sprt" && hasValue) parseSprt(argv[++i], options.sprt);
+        else if (arg == "--watch" && hasValue) options.watch = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--fps" && hasValue) options.fps = std::max(1, std::stoi(argv[++i]));
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> openings;
+    if (!options.openingsPath.empty()) {
+        if (!loadOpenings(options.openingsPath, openings)) {
+            std::cerr << "Error: cannot open " << options.openingsPath << std::endl;
+            return 1;
+        }
+        if (openings.empty()) {
+            std::cerr << "Error: no usable openings in " << options.openingsPath << std::endl;
+            return 1;
+        }
+    } else {
+        openings.push_back(START_FEN);
+    }
+
+    for (EngineConfig& engine : options.engines) {
+        if (!loadEngineData(engine)) return 1;
+    }
+
+    std::ofstream pgnFile;
+    if (!options.pgnPath.empty()) {
+        pgnFile.open(options.pgnPath);
+        if (!pgnFile) {
+            std::cerr << "Error: cannot write " << options.pgnPath << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<GameArchive::Writer> archive;
+    if (!options.archivePath.empty()) {
+        archive = std::make_unique<GameArchive::Writer>(options.archivePath);
+        if (!archive->isOpen()) {
+            std::cerr << "Error: cannot write " << options.archivePath << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<TrainingData::Writer> positions;
+    if (!options.positionsPath.empty()) {
+        positions = std::make_unique<TrainingData::Writer>(options.positionsPath);
+        if (!positions->isOpen()) {
+            std::cerr << "Error: cannot write " << options.positionsPath << std::endl;
+            return 1;
+        }
+    }
+
+    double sprtLower = std::log(options.sprt.beta / (1.0 - options.sprt.alpha));
+    double sprtUpper = std::log((1.0 - options.sprt.beta) / options.sprt.alpha);
+
+    MatchStats stats;
+    std::mutex outputMutex;
+    std::atomic<bool> stop(false);
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::unique_ptr<Spectator> spectator;
+    if (options.watch > 0) {
+        spectator = std::make_unique<Spectator>(options.watch, options.fps);
+        spectator->start();
+    }
+
+    {
+        ThreadPool pool(options.concurrency, options.pin);
+
+        for (int i = 0; i < options.games; ++i) {
+            pool.submit([&, i] {
+                if (stop) return;
+
+                // Games come in pairs: same opening, colors swapped
+                const std::string& fen = openings[(i / 2) % openings.size()];
+                bool engine1White = i % 2 == 0;
+                const EngineConfig& white = options.engines[engine1White ? 0 : 1];
+                const EngineConfig& black = options.engines[engine1White ? 1 : 0];
+
+                GameRecord game = playGame(fen, white, black, i + 1, options.maxPlies, spectator.get(),
+                                           positions ? &options.sampling : nullptr);
+
+                double whitePoints = game.outcome == Outcome::WHITE_WINS ? 1.0 :
+                                     game.outcome == Outcome::BLACK_WINS ? 0.0 : 0.5;
+                stats.add(engine1White ? whitePoints : 1.0 - whitePoints);
+                MatchStats::Snapshot current = stats.snapshot();
+
+                std::lock_guard<std::mutex> lock(outputMutex);
+                if (pgnFile.is_open()) {
+                    writePgnGame(pgnFile, game.pgn);
+                }
+                if (archive) {
+                    archive->add(game.pgn);
+                }
+                if (positions) {
+                    for (const TrainingPosition& sample : game.samples) positions->add(sample);
+                }
+                // The spectator owns the screen while watching
+                if (!spectator) {
+                    std::cout << "Game " << std::setw(5) << i + 1 << ": " << white.name << " - "
+                              << black.name << " " << game.pgn.result << "  (+" << current.wins
+                              << " =" << current.draws << " -" << current.losses << ")" << std::endl;
+                }
+
+                if (options.sprt.enabled && !stop) {
+                    double llr = current.llr(options.sprt);
+                    if (llr >= sprtUpper || llr <= sprtLower) {
+                        stop = true;
+                        if (!spectator) std::cout << "SPRT decision reached, stopping" << std::endl;
+                    }
+                }
+            });
+        }
+
+        pool.wait();
+    }
+    if (spectator) spectator->stop();
+    // The results are still reported, but a missing output fails the run
+    bool archiveOk = !archive || archive->finish();
+    if (!archiveOk) {
+        std::cerr << "Error: could not write " << options.archivePath << std::endl;
+    }
+    bool positionsOk = !positions || positions->finish();
+    if (!positionsOk) {
+        std::cerr << "Error: could not write " << options.positionsPath << std::endl;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printReport(stats.snapshot(), options);
+    std::cout << "Time:   " << seconds << " s\n";
+    if (positions && positionsOk) {
+        std::cout << "Positions: " << positions->size() << " written to " << options.positionsPath << "\n";
+    }
+
+    return archiveOk && positionsOk ? 0 : 1;
+}
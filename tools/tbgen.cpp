@@ -0,0 +1,74 @@
+// tbgen - generate endgame tablebases
+//
+// Builds every 3- and 4-piece table (or only the signatures given on the
+// command line) into a directory. Tables that already exist there are
+// reused, so an interrupted run can simply be restarted.
+
+#include "../include/Tablebase.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <directory> [options] [SIGNATURE...]\n\n"
+              << "Signatures list the stronger side first, e.g. KQK KRKP KBNK.\n\n"
+              << "Options:\n"
+              << "  --pieces N    Generate all tables with up to N pieces (3 or 4, default 4)\n"
+              << "  --threads N   Worker threads (default: all cores)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string directory;
+    int pieces = Tablebase::MAX_PIECES;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> signatures;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--pieces" && i + 1 < argc) {
+                pieces = std::stoi(argv[++i]);
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads = std::max(1, std::stoi(argv[++i]));
+            } else if (!arg.empty() && arg[0] == '-') {
+                printUsage(argv[0]);
+                return 1;
+            } else if (directory.empty()) {
+                directory = arg;
+            } else {
+                signatures.push_back(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (directory.empty() || pieces < 3 || pieces > Tablebase::MAX_PIECES) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (signatures.empty()) {
+        signatures = Tablebase::allSignatures(pieces);
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (const std::string& signature : signatures) {
+        if (!Tablebase::generate(signature, directory, threads, std::cout)) {
+            std::cerr << "Failed to generate " << signature << std::endl;
+            return 1;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Done: " << signatures.size() << " tables in " << seconds << " s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+// tune - fit the hand-written evaluation's weights to game results
+//
+// Loads a training data file written by selfplay --positions, reduces every
+// position to its evaluation terms on all cores, fits the sigmoid scale
+// that maps the current evaluation to winning chances, then optimises
+// every weight (material, piece-square bonuses, mobility, pawn structure)
+// with Adam on the exact gradient of the logistic loss. The tuned weights
+// are printed as C++ tables ready to paste over the current ones.
+
+#include "../include/Evaluation.h"
+#include "../include/MappedFile.h"
+#include "../include/ThreadPool.h"
+#include "../include/TrainingData.h"
+#include "../include/Tuner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string dataPath;
+    std::string outputPath;  // Empty for stdout
+    int epochs = 200;
+    double rate = 1.0;       // Adam step size, in centipawns
+    double lambda = 1.0;     // Share of the game result in the target; the rest is the search score
+    double scale = 0.0;      // 0 = fit it
+    int threads = 0;         // 0 = all cores
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Largest difference between the term-based evaluation and Evaluation's
+double checkTerms(const Tuner::Dataset& data, const TrainingPosition* positions, size_t count,
+                  const std::vector<double>& weights) {
+    std::vector<PackedPosition> packed(count);
+    for (size_t i = 0; i < count; ++i) TrainingData::toPacked(positions[i], packed[i]);
+    std::vector<int> scores(count);
+    Evaluation::evaluateBatch(packed.data(), count, scores.data());
+
+    double worst = 0.0;
+    for (size_t i = 0; i < count; ++i) worst = std::max(worst, std::fabs(data.evaluate(i, weights) - scores[i]));
+    return worst;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " <positions.bin> [options]\n\n"
+              << "Options:\n"
+              << "  --epochs N          Optimisation steps over the whole data (default 200)\n"
+              << "  --rate R            Adam step size in centipawns (default 1)\n"
+              << "  --lambda L          Weight of the game result against the search score (default 1)\n"
+              << "  --scale K           Sigmoid scale instead of fitting it\n"
+              << "  --threads N         Worker threads (default: all cores)\n"
+              << "  --output FILE       Write the tuned tables to FILE instead of the screen\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--epochs" && hasValue) options.epochs = std::max(0, std::stoi(argv[++i]));
+        else if (arg == "--rate" && hasValue) options.rate = std::stod(argv[++i]);
+        else if (arg == "--lambda" && hasValue) options.lambda = std::min(1.0, std::max(0.0, std::stod(argv[++i])));
+        else if (arg == "--scale" && hasValue) options.scale = std::stod(argv[++i]);
+        else if (arg == "--threads" && hasValue) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--output" && hasValue) options.outputPath = argv[++i];
+        else if (!arg.empty() && arg[0] == '-') return false;
+        else positional.push_back(arg);
+    }
+    if (positional.size() != 1) return false;
+    options.dataPath = positional[0];
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    MappedFile file;
+    const TrainingPosition* positions = nullptr;
+    size_t count = 0;
+    if (!file.open(options.dataPath) || !TrainingData::records(file, positions, count)) {
+        std::cerr << "Error: " << options.dataPath << " is not a training data file" << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    auto start = std::chrono::steady_clock::now();
+    Tuner::Dataset data;
+    data.load(positions, count, pool);
+    if (data.size() == 0) {
+        std::cerr << "Error: no usable positions in " << options.dataPath << std::endl;
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(2) << "Loaded " << data.size() << " positions in "
+              << secondsSince(start) << " s on " << pool.size() << " threads\n";
+
+    std::vector<double> weights = Tuner::currentWeights();
+    if (data.size() == count) {
+        std::cout << "Term check:  largest difference from the evaluation " << std::setprecision(3)
+                  << checkTerms(data, positions, std::min<size_t>(count, 100000), weights) << " cp\n";
+    }
+
+    double scale = options.scale > 0.0 ? options.scale : data.fitScale(weights, pool);
+    data.setTargets(scale, options.lambda);
+    std::cout << std::setprecision(6) << "Scale:       " << scale << " (a pawn up scores "
+              << std::setprecision(1) << 100.0 / (1.0 + std::exp(-100.0 * scale)) << "%)\n"
+              << std::setprecision(6) << "Start loss:  " << data.loss(weights, scale, pool, nullptr) << std::endl;
+
+    // Adam
+    const double BETA1 = 0.9;
+    const double BETA2 = 0.999;
+    const double EPSILON = 1e-8;
+    std::vector<double> gradient;
+    std::vector<double> momentum(weights.size(), 0.0);
+    std::vector<double> velocity(weights.size(), 0.0);
+    double loss = 0.0;
+    double epochSeconds = 0.0;
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        auto epochStart = std::chrono::steady_clock::now();
+        loss = data.loss(weights, scale, pool, &gradient);
+        double correction1 = 1.0 - std::pow(BETA1, epoch);
+        double correction2 = 1.0 - std::pow(BETA2, epoch);
+        for (size_t i = 0; i < weights.size(); ++i) {
+            momentum[i] = BETA1 * momentum[i] + (1.0 - BETA1) * gradient[i];
+            velocity[i] = BETA2 * velocity[i] + (1.0 - BETA2) * gradient[i] * gradient[i];
+            weights[i] -= options.rate * (momentum[i] / correction1) / (std::sqrt(velocity[i] / correction2) + EPSILON);
+        }
+        epochSeconds += secondsSince(epochStart);
+
+        if (epoch % 10 == 0 || epoch == options.epochs) {
+            std::cout << "Epoch " << std::setw(5) << epoch << "  loss " << std::setprecision(6) << loss << std::endl;
+        }
+    }
+    if (options.epochs > 0) {
+        double perEpoch = epochSeconds / options.epochs;
+        std::cout << std::setprecision(6) << "Final loss:  "
+                  << data.loss(weights, scale, pool, nullptr) << "\n"
+                  << "Epoch time:  " << std::setprecision(1) << perEpoch * 1000.0 << " ms ("
+                  << perEpoch * 1000.0 * 1e6 / data.size() << " ms per million positions)\n";
+    }
+
+    if (options.outputPath.empty()) {
+        std::cout << "\n";
+        Tuner::writeTables(std::cout, weights);
+    } else {
+        std::ofstream out(options.outputPath);
+        Tuner::writeTables(out, weights);
+        if (!out) {
+            std::cerr << "Error: cannot write " << options.outputPath << std::endl;
+            return 1;
+        }
+        std::cout << "Tables written to " << options.outputPath << std::endl;
+    }
+    return 0;
+}